@@ -0,0 +1,64 @@
+/*!
+ @file bench_frames_alloc.cpp
+ @author Nicolas Padron
+ @brief Description: Bench executable (navfusion_bench_frames_alloc) that checks that the fixed-size Frames functions do not allocate on the heap.
+*			It replaces the global operator new to count its calls, and is built with Armadillo allocating through it (ARMA_ALIEN_MEM_*),
+*			so its matrices are counted too. Only this executable is built so, the navfusion target keeps the default allocators.
+*			Returns 0 when the round trip does not allocate, 1 otherwise.
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <new>
+#include <vector>
+#include <processing/frames/frames.h>
+
+/* Count of the calls to the global operator new while enabled. Single threaded, so plain variables.
+ The replacement allocates as the default one, with malloc, so the default operator delete still releases it. */
+static bool isCountingAllocations = false;
+static size_t countedAllocations = 0;
+
+void* operator new(std::size_t size)
+{
+	if (isCountingAllocations)
+	{
+		countedAllocations++;
+	}
+	void* ptr = malloc((size != 0) ? size : 1);
+	if (ptr == nullptr)
+	{
+		throw std::bad_alloc();
+	}
+	return ptr;
+}
+
+int main(void)
+{
+	// Sweep of the geodetic benchmark (--geo), built before counting
+	const std::vector<arma::vec3> llhs = Frames::benchmarkSweep();
+
+	// Round trip: LLH to ECEF, ENU from the 1st point, back to ECEF and LLH with each method, and the Body to ENU matrix
+	const arma::vec3 xyz0 = Frames::llh2ecef(llhs.front());
+	volatile double sink = 0;
+	isCountingAllocations = true;
+	for (const arma::vec3& llh : llhs)
+	{
+		const arma::vec3 ecef = Frames::llh2ecef(llh);
+		const arma::vec3 enu = Frames::ecef2enu(llh, ecef, xyz0);
+		const arma::vec3 ecefBack = Frames::enu2ecef(llh, enu, xyz0);
+		const arma::mat33 rBody2Enu = Frames::matrixBody2Enu(llh);
+		for (int method = 0; method < Frames::GEODETIC_TOTAL; method++)
+		{
+			sink = sink + Frames::ecef2llh(ecefBack, method)(0) + rBody2Enu(2, 2);
+		}
+	}
+	isCountingAllocations = false;
+
+	printf("Frames round trip (LLH, ECEF, ENU, Body to ENU): %zu heap allocations over %zu points.\n", countedAllocations, llhs.size());
+	if (countedAllocations != 0)
+	{
+		printf("WARNING: the fixed-size Frames functions allocated on the heap.\n");
+		return 1;
+	}
+	return 0;
+}
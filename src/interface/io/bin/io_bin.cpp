@@ -0,0 +1,274 @@
+/*!
+ @file io_bin.cpp
+ @author Nicolas Padron
+ @brief In this file the processes of io_bin.h are implemented: reading and writing of the binary columnar log.
+*/
+
+#include <string.h>
+#include <cmath>
+#include <interface/io/bin/io_bin.h>
+
+using namespace std;
+
+/* Round byte offset up to the format alignment */
+static uint64_t alignOffset(uint64_t offset)
+{
+	return (offset + BINLOG_ALIGNMENT - 1) / BINLOG_ALIGNMENT * BINLOG_ALIGNMENT;
+}
+
+/* Size in bytes of one value of the given type */
+static uint64_t sizeOfType(uint8_t type)
+{
+	return (type == BINLOG_TYPE_F32) ? sizeof(float) : sizeof(double);
+}
+
+/* Powers of 10 of the decimals of float32 columns, exact in double */
+static const double BINLOG_POW10[BINLOG_F32_MAX_DECIMALS + 1] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9 };
+
+/* Value of a float32 column: the nearest double to the decimal with the given decimals, as parsed from the CSV text */
+static inline double decodeF32(float value, uint8_t decimals)
+{
+	return (decimals == 0) ? (double)value : std::nearbyint((double)value * BINLOG_POW10[decimals]) / BINLOG_POW10[decimals];
+}
+
+/* Check if all the values of a column are read back with the same bits from float32 with the given decimals. NaN holds as NaN. */
+static bool isExactF32(const vector<double>& values, uint8_t decimals)
+{
+	for (double value : values)
+	{
+		const double decoded = decodeF32((float)value, decimals);
+		if ((memcmp(&decoded, &value, sizeof(double)) != 0) && !(std::isnan(decoded) && std::isnan(value)))
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+/*************************************************
+* Method definition for class: BinaryLogReader   *
+**************************************************/
+
+/* Check magic bytes */
+bool BinaryLogReader::isBinaryLog(const char* data_, size_t size_)
+{
+	return (data_ != nullptr) && (size_ >= sizeof(BINLOG_MAGIC)) && (memcmp(data_, BINLOG_MAGIC, sizeof(BINLOG_MAGIC)) == 0);
+}
+
+/* Attach to buffer and validate it */
+bool BinaryLogReader::attach(const char* data_, size_t size_)
+{
+	if (!isBinaryLog(data_, size_) || (size_ < sizeof(BinLogHeader_t)))
+	{
+		return false;
+	}
+	const BinLogHeader_t* header_ = (const BinLogHeader_t*)data_;
+	if ((header_->version < BINLOG_VERSION_MIN) || (header_->version > BINLOG_VERSION))
+	{
+		return false;
+	}
+	if (size_ < sizeof(BinLogHeader_t) + (uint64_t)header_->numColumns * sizeof(BinLogColumn_t))
+	{
+		return false;
+	}
+
+	// Check that all the column values lay within the buffer
+	const BinLogColumn_t* columns_ = (const BinLogColumn_t*)(data_ + sizeof(BinLogHeader_t));
+	for (uint32_t column = 0; column < header_->numColumns; column++)
+	{
+		const uint64_t count = (columns_[column].channel == BINLOG_CHANNEL_SPARSE) ? header_->numSparseEntries : header_->numRows;
+		if ((columns_[column].offset % BINLOG_ALIGNMENT != 0) || (columns_[column].offset + count * sizeOfType(columns_[column].type) > size_) ||
+			(columns_[column].decimals > BINLOG_F32_MAX_DECIMALS))
+		{
+			return false;
+		}
+	}
+	if ((header_->numSparseEntries > 0) && (header_->sparseRowsOffset + header_->numSparseEntries * sizeof(uint64_t) > size_))
+	{
+		return false;
+	}
+
+	data = data_;
+	size = size_;
+	header = header_;
+	columns = columns_;
+	return true;
+}
+
+/* Get number of columns */
+int BinaryLogReader::getNumColumns(void) const
+{
+	return (header != nullptr) ? (int)header->numColumns : 0;
+}
+
+/* Get number of dense rows */
+uint64_t BinaryLogReader::getNumRows(void) const
+{
+	return (header != nullptr) ? header->numRows : 0;
+}
+
+/* Get number of sparse entries */
+uint64_t BinaryLogReader::getNumSparseEntries(void) const
+{
+	return (header != nullptr) ? header->numSparseEntries : 0;
+}
+
+/* Get IMU sampling rate */
+double BinaryLogReader::getFsImu(void) const
+{
+	return (header != nullptr) ? header->fsImu : 0;
+}
+
+/* Get GPS sampling rate */
+double BinaryLogReader::getFsGps(void) const
+{
+	return (header != nullptr) ? header->fsGps : 0;
+}
+
+/* Get column name */
+string BinaryLogReader::getColumnName(int column) const
+{
+	const char* name = columns[column].name;
+	return string(name, strnlen(name, BINLOG_NAME_LENGTH));
+}
+
+/* Check if column is sparse */
+bool BinaryLogReader::isColumnSparse(int column) const
+{
+	return columns[column].channel == BINLOG_CHANNEL_SPARSE;
+}
+
+/* Get dense row of a sparse entry */
+uint64_t BinaryLogReader::getSparseRow(uint64_t entry) const
+{
+	uint64_t row;
+	memcpy(&row, data + header->sparseRowsOffset + entry * sizeof(uint64_t), sizeof(uint64_t));
+	return row;
+}
+
+/* Get value */
+double BinaryLogReader::getValue(int column, uint64_t index) const
+{
+	const char* values = data + columns[column].offset;
+	if (columns[column].type == BINLOG_TYPE_F32)
+	{
+		float value;
+		memcpy(&value, values + index * sizeof(float), sizeof(float));
+		return decodeF32(value, columns[column].decimals);
+	}
+	double value;
+	memcpy(&value, values + index * sizeof(double), sizeof(double));
+	return value;
+}
+
+/*************************************************
+* Method definition for class: BinaryLogWriter   *
+**************************************************/
+
+/* Write the binary log */
+bool BinaryLogWriter::write(const vector<string>& names, const vector<vector<double>>& values, const vector<bool>& sparse,
+	double fsImu, double fsGps, FileHandler& file, int& numColumnsF32)
+{
+	const uint32_t numColumns = (uint32_t)names.size();
+	const uint64_t numRows = (numColumns > 0) ? values.at(0).size() : 0;
+
+	// Sparse entries: rows where any of the sparse columns changes. Compared bitwise so that NaN holds like any other value.
+	vector<uint64_t> sparseRows;
+	for (uint64_t row = 0; row < numRows; row++)
+	{
+		bool isChanged = (row == 0);
+		for (uint32_t column = 0; (column < numColumns) && !isChanged; column++)
+		{
+			if (sparse.at(column))
+			{
+				isChanged = memcmp(&values[column][row], &values[column][sparseRows.back()], sizeof(double)) != 0;
+			}
+		}
+		if (isChanged)
+		{
+			sparseRows.push_back(row);
+		}
+	}
+	const uint64_t numSparseEntries = sparseRows.size();
+
+	// Layout
+	BinLogHeader_t header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, BINLOG_MAGIC, sizeof(BINLOG_MAGIC));
+	header.version = BINLOG_VERSION;
+	header.numColumns = numColumns;
+	header.numRows = numRows;
+	header.numSparseEntries = numSparseEntries;
+	header.fsImu = fsImu;
+	header.fsGps = fsGps;
+
+	// Type of each column: float32 with the fewest decimals that read back all its values, else float64
+	vector<BinLogColumn_t> columns(numColumns);
+	uint64_t offset = alignOffset(sizeof(BinLogHeader_t) + numColumns * sizeof(BinLogColumn_t));
+	numColumnsF32 = 0;
+	for (uint32_t column = 0; column < numColumns; column++)
+	{
+		memset(&columns[column], 0, sizeof(BinLogColumn_t));
+		strncpy(columns[column].name, names[column].c_str(), BINLOG_NAME_LENGTH - 1);
+		columns[column].type = BINLOG_TYPE_F64;
+		for (uint8_t decimals = 0; (decimals <= BINLOG_F32_MAX_DECIMALS) && (columns[column].type == BINLOG_TYPE_F64); decimals++)
+		{
+			if (isExactF32(values[column], decimals))
+			{
+				columns[column].type = BINLOG_TYPE_F32;
+				columns[column].decimals = decimals;
+				numColumnsF32++;
+			}
+		}
+		columns[column].channel = sparse.at(column) ? BINLOG_CHANNEL_SPARSE : BINLOG_CHANNEL_DENSE;
+		columns[column].offset = offset;
+		offset = alignOffset(offset + (sparse.at(column) ? numSparseEntries : numRows) * sizeOfType(columns[column].type));
+	}
+	header.sparseRowsOffset = offset;
+
+	// Serialize
+	uint64_t written = 0;
+	const char padding[BINLOG_ALIGNMENT] = { 0 };
+	auto writeBytes = [&file, &written](const void* ptr, uint64_t length) -> bool
+	{
+		written += length;
+		return (length == 0) || (FILE_ACT_WRITTEN == file.writeContent((const char*)ptr, (size_t)length));
+	};
+	auto writePadding = [&writeBytes, &written, &padding](void) -> bool
+	{
+		return writeBytes(padding, alignOffset(written) - written);
+	};
+
+	bool isWritten = writeBytes(&header, sizeof(header));
+	isWritten &= writeBytes(columns.data(), numColumns * sizeof(BinLogColumn_t));
+	isWritten &= writePadding();
+	vector<double> sparseValues(numSparseEntries);
+	vector<float> valuesF32;
+	for (uint32_t column = 0; (column < numColumns) && isWritten; column++)
+	{
+		const double* columnValues = values[column].data();
+		uint64_t count = numRows;
+		if (sparse.at(column))
+		{
+			for (uint64_t entry = 0; entry < numSparseEntries; entry++)
+			{
+				sparseValues[entry] = values[column][sparseRows[entry]];
+			}
+			columnValues = sparseValues.data();
+			count = numSparseEntries;
+		}
+		if (columns[column].type == BINLOG_TYPE_F32)
+		{
+			valuesF32.assign(columnValues, columnValues + count);
+			isWritten &= writeBytes(valuesF32.data(), count * sizeof(float));
+		}
+		else
+		{
+			isWritten &= writeBytes(columnValues, count * sizeof(double));
+		}
+		isWritten &= writePadding();
+	}
+	isWritten &= writeBytes(sparseRows.data(), numSparseEntries * sizeof(uint64_t));
+
+	return isWritten;
+}
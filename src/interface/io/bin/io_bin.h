@@ -0,0 +1,141 @@
+/*!
+ @file io_bin.h
+ @author Nicolas Padron
+ @brief Native binary columnar log format (NFB): definitions, reader over a memory mapped buffer and writer.
+ Layout (little endian, all offsets in bytes from the start of the file and 8 bytes aligned):
+	- BinLogHeader_t: magic, version, number of columns/rows, sample rates and offset of the sparse row index.
+	- BinLogColumn_t x numColumns: schema, i.e. name, type (float64/float32), decimals of float32, channel and offset of the values.
+	  A float32 column with decimals d is read back as round(value * 10^d) / 10^d, i.e. the double parsed from the CSV text with d decimals.
+	- Dense columns: one value per row (IMU rate).
+	- Sparse channel (GNSS): row index of each entry, then one value per entry for each sparse column.
+	  An entry is written only when any of the sparse columns changes, and holds until the next entry.
+ */
+
+#ifndef _HEADER_IO_BIN_
+#define _HEADER_IO_BIN_
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <interface/io/files/io_files.h>
+
+/* Format constants */
+constexpr char BINLOG_MAGIC[4] = { 'N', 'F', 'B', 'L' };
+constexpr uint32_t BINLOG_VERSION = 2; // 2: decimals of float32 columns, version 1 logs only hold float64 columns
+constexpr uint32_t BINLOG_VERSION_MIN = 1;
+constexpr size_t BINLOG_NAME_LENGTH = 48;
+constexpr size_t BINLOG_ALIGNMENT = 8;
+constexpr uint8_t BINLOG_F32_MAX_DECIMALS = 9;
+const std::string BINLOG_EXTENSION = ".nfb";
+
+/* Type of the values of a column */
+enum BinLogColumnType_e {
+	BINLOG_TYPE_F64,
+	BINLOG_TYPE_F32
+};
+
+/* Channel of a column: one value per row, or one value per sparse entry */
+enum BinLogChannel_e {
+	BINLOG_CHANNEL_DENSE,
+	BINLOG_CHANNEL_SPARSE
+};
+
+/* File header */
+typedef struct BinLogHeader_s {
+	char magic[4];
+	uint32_t version;
+	uint32_t numColumns;
+	uint32_t reserved;
+	uint64_t numRows;
+	uint64_t numSparseEntries;
+	double fsImu;
+	double fsGps;
+	uint64_t sparseRowsOffset;
+} BinLogHeader_t;
+
+/* Column descriptor */
+typedef struct BinLogColumn_s {
+	char name[BINLOG_NAME_LENGTH];
+	uint8_t type;
+	uint8_t channel;
+	uint8_t decimals;
+	uint8_t reserved8;
+	uint32_t reserved32;
+	uint64_t offset;
+} BinLogColumn_t;
+
+/*!
+ @brief Reader of a binary log held in memory (usually the memory mapping of the input file). No data is copied.
+ \class BinaryLogReader
+*/
+class BinaryLogReader {
+public:
+	/*! Default constructor */
+	BinaryLogReader()
+	{
+		data = nullptr;
+		size = 0;
+		header = nullptr;
+		columns = nullptr;
+	};
+
+	/*! Check if the buffer starts as a binary log */
+	static bool isBinaryLog(const char* data_, size_t size_);
+
+	/*!
+	@brief Attach to the buffer and validate header and schema.
+	@return false if the buffer is not a valid binary log.
+	*/
+	bool attach(const char* data_, size_t size_);
+
+	/*! Get number of columns */
+	int getNumColumns(void) const;
+	/*! Get number of dense rows */
+	uint64_t getNumRows(void) const;
+	/*! Get number of entries in the sparse channel */
+	uint64_t getNumSparseEntries(void) const;
+	/*! Get sampling rates written by the converter */
+	double getFsImu(void) const;
+	double getFsGps(void) const;
+	/*! Get column name */
+	std::string getColumnName(int column) const;
+	/*! Check if the column belongs to the sparse channel */
+	bool isColumnSparse(int column) const;
+	/*! Get dense row at which the sparse entry starts to hold */
+	uint64_t getSparseRow(uint64_t entry) const;
+	/*!
+	@brief Get value of a column.
+	@param column: column index.
+	@param index: row for dense columns, entry for sparse columns.
+	*/
+	double getValue(int column, uint64_t index) const;
+
+private:
+	const char* data;
+	size_t size;
+	const BinLogHeader_t* header;
+	const BinLogColumn_t* columns;
+};
+
+/*!
+ @brief Writer of a binary log.
+ \class BinaryLogWriter
+*/
+class BinaryLogWriter {
+public:
+	/*!
+	@brief Compute the layout and serialize the log. A column is stored as float32 if all its values are read back with the same bits,
+	with the fewest decimals that allow it (e.g. IMU channels logged with a few decimals), else as float64.
+	@param names: column names.
+	@param values: dense values of every column, one vector per column with the same number of rows.
+	@param sparse: columns to store in the sparse channel (GNSS).
+	@param fsImu, fsGps: sampling rates.
+	@param file: output file, already opened in binary mode.
+	@param numColumnsF32: number of columns stored as float32.
+	@return false if writing failed.
+	*/
+	static bool write(const std::vector<std::string>& names, const std::vector<std::vector<double>>& values, const std::vector<bool>& sparse,
+		double fsImu, double fsGps, FileHandler& file, int& numColumnsF32);
+};
+
+#endif // _HEADER_IO_BIN_
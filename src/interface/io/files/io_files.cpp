@@ -4,7 +4,29 @@
  @brief: File for handling the reading/writing of files.
 */
 
+#include <string.h>
 #include <interface/io/files/io_files.h>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#include <io.h>
+#include <stdio.h>
+#else
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#endif
+
 using namespace std;
 
 /* Get last action that took place in the file */
@@ -16,10 +38,47 @@ const IoFilesAction_e FileHandler::getFileLastAction()
 /* Open file */
 bool FileHandler::openFile(void)
 {
+	// Already mapped or open as live source
+	if ((mapPtr != nullptr) || isStream())
+	{
+		return true;
+	}
+
+	// Live input sources are read as the data arrives. Checked before mapping, since opening a named pipe blocks until its writer connects.
+	if ((openOption == FSTREAM_IN_MAPPED) && !fs.is_open() && openStream())
+	{
+		fileLastAction = FILE_ACT_OPEN;
+		return true;
+	}
+
+	// Map input files if requested, otherwise (or if mapping is not possible) fall back to the stream.
+	if ((openOption == FSTREAM_IN_MAPPED) && !fs.is_open() && mapFile())
+	{
+		// Compressed files are decoded as they are read, the mapping only holds the compressed content
+		if (!openCompressed())
+		{
+			unmapFile();
+			return false;
+		}
+		fileLastAction = FILE_ACT_OPEN;
+		return true;
+	}
+
 	// Open if not open already
 	if (!fs.is_open())
 	{
-		fs.open(filename, (openOption == FSTREAM_IN) ? std::fstream::in : std::fstream::out);
+		switch (openOption)
+		{
+		case FSTREAM_OUT:
+			fs.open(filename, std::fstream::out);
+			break;
+		case FSTREAM_OUT_BINARY:
+			fs.open(filename, std::fstream::out | std::fstream::binary);
+			break;
+		default:
+			fs.open(filename, std::fstream::in);
+			break;
+		}
 		fileLastAction = FILE_ACT_OPEN;
 	}
 
@@ -27,6 +86,256 @@ bool FileHandler::openFile(void)
 	return fs.is_open();
 }
 
+/* Map file in memory */
+bool FileHandler::mapFile(void)
+{
+#ifdef _WIN32
+	HANDLE hFile = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+	if (hFile == INVALID_HANDLE_VALUE)
+	{
+		return false;
+	}
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(hFile, &fileSize) || fileSize.QuadPart <= 0)
+	{
+		CloseHandle(hFile);
+		return false;
+	}
+	HANDLE hMap = CreateFileMappingA(hFile, NULL, PAGE_READONLY, 0, 0, NULL);
+	CloseHandle(hFile); // The mapping keeps its own reference to the file
+	if (hMap == NULL)
+	{
+		return false;
+	}
+	const void* ptr = MapViewOfFile(hMap, FILE_MAP_READ, 0, 0, 0);
+	if (ptr == NULL)
+	{
+		CloseHandle(hMap);
+		return false;
+	}
+	mapHandle = (void*)hMap;
+	mapSize = (size_t)fileSize.QuadPart;
+#else
+	int fd = open(filename.c_str(), O_RDONLY);
+	if (fd < 0)
+	{
+		return false;
+	}
+	struct stat st;
+	if ((fstat(fd, &st) != 0) || !S_ISREG(st.st_mode) || (st.st_size <= 0))
+	{
+		close(fd);
+		return false;
+	}
+	void* ptr = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd); // The mapping keeps its own reference to the file
+	if (ptr == MAP_FAILED)
+	{
+		return false;
+	}
+	// The file is read front to back once
+	(void)madvise(ptr, (size_t)st.st_size, MADV_SEQUENTIAL);
+	mapSize = (size_t)st.st_size;
+#endif
+	mapPtr = (const char*)ptr;
+	mapOffset = 0;
+	sizeFile = (long long)mapSize;
+	return true;
+}
+
+/* Open live input source */
+bool FileHandler::openStream(void)
+{
+	int fd = -1;
+#ifdef _WIN32
+	// Only the standard input is supported as live source
+	if (filename != FILE_STREAM_STDIN)
+	{
+		return false;
+	}
+	fd = _fileno(stdin);
+#else
+	if (filename == FILE_STREAM_STDIN)
+	{
+		fd = STDIN_FILENO;
+	}
+	else if (filename.compare(0, FILE_STREAM_UNIX_PREFIX.size(), FILE_STREAM_UNIX_PREFIX) == 0)
+	{
+		// Connect to the UNIX domain socket where the data is served
+		const string path = filename.substr(FILE_STREAM_UNIX_PREFIX.size());
+		struct sockaddr_un addr;
+		memset(&addr, 0, sizeof(addr));
+		addr.sun_family = AF_UNIX;
+		if (path.empty() || (path.size() >= sizeof(addr.sun_path)))
+		{
+			return false;
+		}
+		memcpy(addr.sun_path, path.c_str(), path.size());
+		fd = socket(AF_UNIX, SOCK_STREAM, 0);
+		if (fd < 0)
+		{
+			return false;
+		}
+		if (connect(fd, (const struct sockaddr*)&addr, sizeof(addr)) != 0)
+		{
+			close(fd);
+			return false;
+		}
+	}
+	else
+	{
+		// Named pipes and character devices (e.g. serial ports), regular files are mapped instead
+		struct stat st;
+		if ((stat(filename.c_str(), &st) != 0) || !(S_ISFIFO(st.st_mode) || S_ISCHR(st.st_mode)))
+		{
+			return false;
+		}
+		fd = open(filename.c_str(), O_RDONLY);
+		if (fd < 0)
+		{
+			return false;
+		}
+	}
+#endif
+	streamFd = fd;
+	streamBuffer.assign(FILE_STREAM_BUFFER_SIZE, 0);
+	streamStart = 0;
+	streamEnd = 0;
+	streamReadBytes = 0;
+	isStreamEnded = false;
+	isStreamError = false;
+	sizeFile = -1; // Unknown until the source is closed
+	return true;
+}
+
+/* Start decoding compressed file */
+bool FileHandler::openCompressed(void)
+{
+	compression = ZipReader::detect(mapPtr, mapSize);
+	if (compression == ZIP_FORMAT_NONE)
+	{
+		return true;
+	}
+	if (!zipReader.open(mapPtr, mapSize, isDecodeThreaded))
+	{
+		return false;
+	}
+	streamBuffer.assign(FILE_STREAM_BUFFER_SIZE, 0);
+	streamStart = 0;
+	streamEnd = 0;
+	streamReadBytes = 0;
+	isStreamEnded = false;
+	isStreamError = false;
+	return true;
+}
+
+/* Read from live input source */
+bool FileHandler::fillStream(void)
+{
+	// Move the pending content to the front, and grow the buffer if a single line fills it
+	if (streamStart > 0)
+	{
+		memmove(streamBuffer.data(), streamBuffer.data() + streamStart, streamEnd - streamStart);
+		streamEnd -= streamStart;
+		streamStart = 0;
+	}
+	if (streamEnd == streamBuffer.size())
+	{
+		streamBuffer.resize(2 * streamBuffer.size());
+	}
+
+	// Compressed file: decoded from the mapping
+	if (zipReader.isOpen())
+	{
+		const long long decodedCount = zipReader.read(streamBuffer.data() + streamEnd, streamBuffer.size() - streamEnd);
+		if (decodedCount > 0)
+		{
+			streamEnd += (size_t)decodedCount;
+			return true;
+		}
+		isStreamError = (decodedCount < 0);
+		isStreamEnded = true;
+		return false;
+	}
+
+	// Blocks until some data arrives, the writer closes the source or an error happens
+	while (true)
+	{
+#ifdef _WIN32
+		const long long readCount = (long long)_read(streamFd, streamBuffer.data() + streamEnd, (unsigned int)(streamBuffer.size() - streamEnd));
+#else
+		const long long readCount = (long long)read(streamFd, streamBuffer.data() + streamEnd, streamBuffer.size() - streamEnd);
+		if ((readCount < 0) && (errno == EINTR))
+		{
+			continue;
+		}
+#endif
+		if (readCount > 0)
+		{
+			streamEnd += (size_t)readCount;
+			return true;
+		}
+		isStreamError = (readCount < 0);
+		isStreamEnded = true;
+		return false;
+	}
+}
+
+/* Check if file is a live input source */
+bool FileHandler::isStream(void) const
+{
+	return streamFd >= 0;
+}
+
+/* Release memory mapping */
+void FileHandler::unmapFile(void)
+{
+	if (mapPtr == nullptr)
+	{
+		return;
+	}
+#ifdef _WIN32
+	UnmapViewOfFile(mapPtr);
+	CloseHandle((HANDLE)mapHandle);
+#else
+	munmap((void*)mapPtr, mapSize);
+#endif
+	mapPtr = nullptr;
+	mapHandle = nullptr;
+	mapSize = 0;
+	mapOffset = 0;
+}
+
+/* Check if file is memory mapped */
+bool FileHandler::isMapped(void) const
+{
+	return (mapPtr != nullptr) && !zipReader.isOpen();
+}
+
+/* Set decoding of compressed files in background */
+void FileHandler::setDecodeThreaded(bool isDecodeThreaded_)
+{
+	isDecodeThreaded = isDecodeThreaded_;
+}
+
+/* Get compression format */
+ZipFormat_e FileHandler::getCompression(void) const
+{
+	return compression;
+}
+
+/* Get mapped content */
+const char* FileHandler::getMappedData(void) const
+{
+	return mapPtr;
+}
+
+/* Set read offset in mapped content */
+void FileHandler::setMappedOffset(size_t offset)
+{
+	mapOffset = (offset < mapSize) ? offset : mapSize;
+}
+
 /* Set file option to open */
 void FileHandler::setOpenOption(int opt)
 {
@@ -42,6 +351,30 @@ void FileHandler::setFilename(const std::string& filename_)
 /* Close file */
 bool FileHandler::closeFile(void)
 {
+	if (zipReader.isOpen())
+	{
+		zipReader.close();
+		streamBuffer.clear();
+	}
+	if (mapPtr != nullptr)
+	{
+		unmapFile();
+		fileLastAction = FILE_ACT_CLOSED;
+	}
+	if (isStream())
+	{
+#ifdef _WIN32
+		// Standard input is owned by the process
+#else
+		if (streamFd != STDIN_FILENO)
+		{
+			close(streamFd);
+		}
+#endif
+		streamFd = -1;
+		streamBuffer.clear();
+		fileLastAction = FILE_ACT_CLOSED;
+	}
 	if (fs.is_open())
 	{
 		fs.close();
@@ -53,11 +386,111 @@ bool FileHandler::closeFile(void)
 /* Read file line */
 int FileHandler::readLine(string& line)
 {
-	if (fs.is_open())
+	StrView_t lineView;
+	if (FILE_ACT_READ == readLine(lineView))
 	{
-		if (!fs.eof())
+		line.assign(lineView.ptr, lineView.len);
+	}
+	else
+	{
+		line.clear();
+	}
+	return fileLastAction;
+}
+
+/* Read file line without copying */
+int FileHandler::readLine(StrView_t& line)
+{
+	line.ptr = nullptr;
+	line.len = 0;
+	if (isMapped())
+	{
+		if (mapOffset < mapSize)
 		{
-			std::getline(fs, line);
+			// Look for the end of line directly in the mapped buffer
+			const char* lineStart = mapPtr + mapOffset;
+			const char* lineEnd = (const char*)memchr(lineStart, '\n', mapSize - mapOffset);
+			if (lineEnd == nullptr)
+			{
+				lineEnd = mapPtr + mapSize; // Last line without line break
+			}
+			mapOffset = (size_t)(lineEnd - mapPtr) + 1;
+			// Remove carriage return of files written with "\r\n" line breaks
+			if ((lineEnd > lineStart) && (*(lineEnd - 1) == '\r'))
+			{
+				lineEnd--;
+			}
+			line.ptr = lineStart;
+			line.len = (size_t)(lineEnd - lineStart);
+			fileLastAction = FILE_ACT_READ;
+		}
+		else
+		{
+			fileLastAction = FILE_ACT_EOF;
+		}
+	}
+	else if (isStream() || zipReader.isOpen())
+	{
+		// Wait until a whole line is buffered, only the newly read content is searched for the line break
+		const char* lineEnd = nullptr;
+		size_t searched = 0;
+		while (true)
+		{
+			lineEnd = (const char*)memchr(streamBuffer.data() + streamStart + searched, '\n', streamEnd - streamStart - searched);
+			if ((lineEnd != nullptr) || isStreamEnded)
+			{
+				break;
+			}
+			searched = streamEnd - streamStart;
+			if (!fillStream())
+			{
+				break;
+			}
+		}
+
+		if (isStreamError)
+		{
+			// Neither read nor end of file: reported as read error
+			fileLastAction = FILE_ACT_OPEN;
+		}
+		else if ((lineEnd == nullptr) && (streamStart == streamEnd))
+		{
+			fileLastAction = FILE_ACT_EOF;
+		}
+		else
+		{
+			const char* lineStart = streamBuffer.data() + streamStart;
+			size_t nextStart = streamEnd;
+			if (lineEnd == nullptr)
+			{
+				lineEnd = streamBuffer.data() + streamEnd; // Last line without line break, source closed
+			}
+			else
+			{
+				nextStart = (size_t)(lineEnd - streamBuffer.data()) + 1;
+			}
+			streamReadBytes += (long long)(nextStart - streamStart);
+			streamStart = nextStart;
+			if ((lineEnd > lineStart) && (*(lineEnd - 1) == '\r'))
+			{
+				lineEnd--;
+			}
+			line.ptr = lineStart;
+			line.len = (size_t)(lineEnd - lineStart);
+			fileLastAction = FILE_ACT_READ;
+		}
+	}
+	else if (fs.is_open())
+	{
+		// getline only fails when nothing could be extracted, i.e. end of file reached
+		if (std::getline(fs, lineBuffer))
+		{
+			if (!lineBuffer.empty() && (*lineBuffer.rbegin() == '\r'))
+			{
+				lineBuffer.erase(lineBuffer.size() - 1);
+			}
+			line.ptr = lineBuffer.c_str();
+			line.len = lineBuffer.size();
 			fileLastAction = FILE_ACT_READ;
 		}
 		else
@@ -75,29 +508,41 @@ const std::string& FileHandler::getFilename(void) const
 }
 
 /* Get file size */
-long FileHandler::getFileSize(void)
+long long FileHandler::getFileSize(void)
 {
 	if (fs.is_open() && sizeFile == -1)
 	{
 		// Look for end of the file
 		fs.seekg(0, ios::end);
 		// Count number of bytes
-		sizeFile = (long)fs.tellg();
+		sizeFile = (long long)fs.tellg();
 		// Go back to starting point of the file
 		fs.clear();
 		fs.seekg(0, ios::beg);
-		sizeFile -= (long)fs.tellg();
+		sizeFile -= (long long)fs.tellg();
 	}
 	return sizeFile;
 }
 
 /* Calculate how many bytes have bean read so far */
-long FileHandler::getReadBytes(void)
+long long FileHandler::getReadBytes(void)
 {
-	long readBytes = 0;
-	if (fs.is_open())
+	long long readBytes = 0;
+	if (zipReader.isOpen())
+	{
+		readBytes = zipReader.getConsumed();
+	}
+	else if (isMapped())
+	{
+		readBytes = (long long)((mapOffset < mapSize) ? mapOffset : mapSize);
+	}
+	else if (isStream())
 	{
-		readBytes = (long)fs.tellg();
+		readBytes = streamReadBytes;
+	}
+	else if (fs.is_open())
+	{
+		readBytes = (long long)fs.tellg();
 	}
 	return readBytes;
 }
@@ -115,3 +560,24 @@ int FileHandler::writeContent(const char* str)
 	}
 	return fileLastAction;
 }
+
+/* Write bytes in file */
+int FileHandler::writeContent(const char* data, size_t length)
+{
+	if (fs.is_open())
+	{
+		fs.write(data, length);
+		// On failure the file stays open but nothing is reported as written
+		fileLastAction = fs.good() ? FILE_ACT_WRITTEN : FILE_ACT_OPEN;
+	}
+	return fileLastAction;
+}
+
+/* Flush file content */
+void FileHandler::flush(void)
+{
+	if (fs.is_open())
+	{
+		fs.flush();
+	}
+}
@@ -9,12 +9,22 @@
 #include <iostream>
 #include <fstream>
 #include <string>
+#include <vector>
+#include <interface/io/zip/io_zip.h>
 
 enum FstreamOption_e {
 	FSTREAM_IN,
-	FSTREAM_OUT
+	FSTREAM_OUT,
+	FSTREAM_IN_MAPPED,
+	FSTREAM_OUT_BINARY
 };
 
+/* Live input sources: standard input, and prefix of a UNIX domain socket path. Named pipes (FIFOs) are opened by their path. */
+const std::string FILE_STREAM_STDIN = "-";
+const std::string FILE_STREAM_UNIX_PREFIX = "unix:";
+/* Initial size of the buffer used to read lines from a live input source */
+constexpr size_t FILE_STREAM_BUFFER_SIZE = 1 << 16;
+
 enum IoFilesAction_e{
 	FILE_ACT_INIT,
 	FILE_ACT_OPEN,
@@ -24,6 +34,15 @@ enum IoFilesAction_e{
 	FILE_ACT_WRITTEN
 };
 
+/*!
+ @brief Non-owning view over a range of characters. Used to hand lines and fields of a memory-mapped file without copying them.
+ The content is only valid while the file stays open (mapped) or until the next line is read (stream fallback).
+*/
+typedef struct StrView_s {
+	const char* ptr = nullptr;
+	size_t len = 0;
+} StrView_t;
+
 /*!
  \class FileHandler
  @brief Class to handle files for read/write
@@ -36,6 +55,18 @@ public:
 		sizeFile = -1;
 		fileLastAction = FILE_ACT_INIT;
 		openOption = FSTREAM_OUT;
+		mapPtr = nullptr;
+		mapSize = 0;
+		mapOffset = 0;
+		mapHandle = nullptr;
+		streamFd = -1;
+		streamStart = 0;
+		streamEnd = 0;
+		streamReadBytes = 0;
+		isStreamEnded = false;
+		isStreamError = false;
+		compression = ZIP_FORMAT_NONE;
+		isDecodeThreaded = false;
 	};
 	~FileHandler(){};
 
@@ -45,25 +76,74 @@ public:
 	bool closeFile(void);
 	/*! Read file line */
 	int readLine(std::string& line);
+	/*! Read file line without copying it. On mapped files the view points into the mapping, otherwise to an internal line buffer. */
+	int readLine(StrView_t& line);
 	/*! Write into file */
 	int writeContent(const char* str);
+	/*! Write a number of bytes into file, used for binary content */
+	int writeContent(const char* data, size_t length);
+	/*! Flush the content written so far to the file */
+	void flush(void);
 	/*! Set open mode */
 	void setOpenOption(int opt);
 	/*! Set filename */
 	void setFilename(const std::string& filename_);
 	/*! Get filename */
 	const std::string& getFilename(void) const;
-	/*! Get file size in bytes */
-	long getFileSize(void);
-	/*! Get number of bytes already read */
-	long getReadBytes(void);
+	/*! Get file size in bytes, -1 if unknown (live input source). Compressed files give the compressed size. */
+	long long getFileSize(void);
+	/*! Get number of bytes already read. Compressed files give the compressed bytes consumed. */
+	long long getReadBytes(void);
 	/*! Get file last action */
 	const IoFilesAction_e getFileLastAction(void);
+	/*! Check if the file content is read directly through a memory mapping, i.e. mapped and not compressed */
+	bool isMapped(void) const;
+	/*! Get pointer to the start of the memory mapping, nullptr if not mapped */
+	const char* getMappedData(void) const;
+	/*! Set the offset reported as read bytes, for mapped content not read line by line */
+	void setMappedOffset(size_t offset);
+	/*! Check if the file is a live input source (standard input, named pipe or UNIX domain socket), read as the data arrives */
+	bool isStream(void) const;
+	/*! Decode compressed input files in a background thread. Must be set before opening the file. */
+	void setDecodeThreaded(bool isDecodeThreaded_);
+	/*! Get the compression format detected when opening the file (input files open with FSTREAM_IN_MAPPED) */
+	ZipFormat_e getCompression(void) const;
 private:
-	long sizeFile;
+	/*! Open a live input source. Returns false if the filename is not a live source, e.g. a regular file. */
+	bool openStream(void);
+	/*! Read from the live input source, or decode from the compressed file, into the line buffer, blocking until some data arrives. Returns false at end of stream or on error. */
+	bool fillStream(void);
+	/*! Start decoding the mapped file if it is compressed. Returns false if compressed with a format not supported or corrupted header. */
+	bool openCompressed(void);
+	/*! Map the whole file in memory (read only). Returns false if the file cannot be mapped, e.g. empty file or not a regular file. */
+	bool mapFile(void);
+	/*! Release the memory mapping */
+	void unmapFile(void);
+
+	long long sizeFile;
 	std::string filename;
 	std::fstream fs;
 	IoFilesAction_e fileLastAction;
 	int openOption;
+	// Memory mapping: pointer to the 1st byte, mapped size and offset of the next line to read.
+	const char* mapPtr;
+	size_t mapSize;
+	size_t mapOffset;
+	// Platform handle of the mapping object (only used on Windows).
+	void* mapHandle;
+	// Line buffer used when reading through the stream.
+	std::string lineBuffer;
+	// Live input source: descriptor, buffer with the pending content in [streamStart, streamEnd), bytes consumed and end of stream reached.
+	int streamFd;
+	std::vector<char> streamBuffer;
+	size_t streamStart;
+	size_t streamEnd;
+	long long streamReadBytes;
+	bool isStreamEnded;
+	bool isStreamError;
+	// Compressed file: decoder reading from the mapping into the line buffer, format detected and decoding in a background thread.
+	ZipReader zipReader;
+	ZipFormat_e compression;
+	bool isDecodeThreaded;
 };
 #endif// _HEADER_IO_FILES_
@@ -9,8 +9,15 @@
 #include <monitor/monitor.h>
 #include <interface/ui/ui.h>
 #include <interface/io/in/io_in.h>
+#include <processing/frames/frames.h>
+#include <processing/frames/frames_batch.h>
 
 #include <string.h>
+#include <stdio.h>
+#include <cmath>
+#include <algorithm>
+#include <chrono>
+#include <limits>
 
 using namespace std;
 
@@ -24,6 +31,8 @@ Input& Input::getInstance(void)
 /* Close all opened files */
 void Input::closeFiles(void)
 {
+	// Files cannot be closed while the reader thread is using them
+	stopReader();
 	try {
 		for (auto& fileHandler : cFilesHandler)
 		{
@@ -45,6 +54,17 @@ void Input::closeFiles(void)
 	}
 }
 
+/* Message of file that cannot be opened */
+static string openErrorMessage(const FileHandler& fileHandler)
+{
+	string msg = "File: "; msg += fileHandler.getFilename(); msg += " cannot be opened.";
+	if ((fileHandler.getCompression() != ZIP_FORMAT_NONE) && !ZipReader::isSupported(fileHandler.getCompression()))
+	{
+		msg += " Compressed with "; msg += ZipReader::getFormatName(fileHandler.getCompression()); msg += ", not supported by this build.";
+	}
+	return msg;
+}
+
 /* Open all files (Input & Output) */
 void Input::openIOFiles(void)
 {
@@ -55,14 +75,38 @@ void Input::openIOFiles(void)
 		{
 			if (!cFilesHandler.at(fileIndex).openFile())
 			{
-				string msg = "File: "; msg += cFilesHandler.at(fileIndex).getFilename(); msg += " cannot be opened.";
-				updateDisplayOutputConsoleCpp(msg, true);
+				updateDisplayOutputConsoleCpp(openErrorMessage(cFilesHandler.at(fileIndex)), true);
+				throw MonitorException(ERROR_RETURN_FILE_OPEN_ERROR);
+			}
+		}
+
+		// Additional input files (GNSS, magnetometer/attitude), if entered, are merged by timestamp into the main input epochs
+		sources.clear();
+		for (int fileIndex : { FILE_INPUT_GNSS, FILE_INPUT_AUX })
+		{
+			if (cFilesHandler.at(fileIndex).getFilename().empty())
+			{
+				continue;
+			}
+			if (!cFilesHandler.at(fileIndex).openFile())
+			{
+				updateDisplayOutputConsoleCpp(openErrorMessage(cFilesHandler.at(fileIndex)), true);
 				throw MonitorException(ERROR_RETURN_FILE_OPEN_ERROR);
 			}
+			InputSource_t source;
+			source.fileIndex = fileIndex;
+			source.isGnss = (fileIndex == FILE_INPUT_GNSS);
+			source.next.fill(arma::datum::nan);
+			source.hasNext = false;
+			source.line = 0;
+			sources.push_back(source);
 		}
 
 		// Calculate size of input file
 		(void)cFilesHandler.at(FILE_INPUT).getFileSize();
+
+		// Input may be a binary log instead of a CSV
+		checkInputBinary();
 	}
 	catch (const MonitorException&)
 	{
@@ -85,6 +129,22 @@ const string Input::removeStartingWhiteSpace(const string filename)
 	return string(&pFilename[index]);
 }
 
+/* Remove extension of input filename */
+const string Input::removeExtension(const string& filename)
+{
+	// Compressed inputs keep the name of the file they hold, e.g. "log.csv.gz" gives "log"
+	string name = filename;
+	for (const string& suffix : { ZIP_SUFFIX_GZIP, ZIP_SUFFIX_ZSTD })
+	{
+		if ((name.size() > suffix.size()) && (name.compare(name.size() - suffix.size(), suffix.size(), suffix) == 0))
+		{
+			name.erase(name.size() - suffix.size());
+			break;
+		}
+	}
+	return name.substr(0, name.length() - 4);
+}
+
 /* Function to read and write the IDs of the input CSV file */
 void Input::readInputCsvIds(void)
 {
@@ -99,7 +159,7 @@ void Input::readInputCsvIds(void)
 
 	// Construct filename string to save the IDs and open the file
 	string inputFilename = cFilesHandler.at(FILE_INPUT).getFilename();
-	cFilesHandler.at(FILE_INPUT_CSVIDS).setFilename(inputFilename.substr(0, inputFilename.length() - 4) + "_INDEX.txt");
+	cFilesHandler.at(FILE_INPUT_CSVIDS).setFilename(removeExtension(inputFilename) + "_INDEX.txt");
 	if (!cFilesHandler.at(FILE_INPUT_CSVIDS).openFile())
 	{
 		ostringstream msg;
@@ -122,9 +182,9 @@ void Input::readInputCsvIds(void)
 		// Create string with IDs to write
 		ostringstream idStr;
 		idStr << "Index of Elements: " << endl;
-		for (auto it = mapData.begin(); it != mapData.end(); it++)
+		for (size_t fieldId = 0; fieldId < fieldnames.size(); fieldId++)
 		{
-			idStr << "INDEX:\t" << std::to_string(it->first) << "\t-\t" << it->second.fieldname << endl; // Construct string with IDs, e.g.: "ID: 3 - accX"
+			idStr << "INDEX:\t" << std::to_string(fieldId) << "\t-\t" << fieldnames.at(fieldId) << endl; // Construct string with IDs, e.g.: "ID: 3 - accX"
 		}
 		// Write IDs
 		(void)cFilesHandler.at(FILE_INPUT_CSVIDS).writeContent(idStr.str().c_str()); // Write IDs
@@ -151,121 +211,1274 @@ void Input::readInputCsvIds(void)
 
 };
 
-/* Read CSV line */
-bool Input::readline(bool jumpLine, int epochCounter)
+/* Check if input is a binary log */
+void Input::checkInputBinary(void)
 {
-	bool lineReadCorrectly = false;
-	char* eptr;
+	FileHandler& fileInput = cFilesHandler.at(FILE_INPUT);
+	isInputBinary = fileInput.isMapped() && BinaryLogReader::isBinaryLog(fileInput.getMappedData(), (size_t)fileInput.getFileSize());
+	if (isInputBinary && !cBinaryLog.attach(fileInput.getMappedData(), (size_t)fileInput.getFileSize()))
+	{
+		updateDisplayOutputConsoleCpp("Input binary log is corrupted or has an unsupported version.", true);
+		throw MonitorException(ERROR_RETURN_FILE_READ_ERROR);
+	}
+	binaryRow = 0;
+	binarySparseEntry = 0;
+}
 
-	// Read line
-	string readLineStr;
-	IoFilesAction_e fileLastAction;
-	cFilesHandler.at(FILE_INPUT).readLine(readLineStr);
-	if (!(readLineStr.length() > 0))
+/* Convert input CSV into binary log */
+void Input::writeBinaryLog(const InputIds& sInputIds, double fsImu, double fsGps)
+{
+	FileHandler& fileInput = cFilesHandler.at(FILE_INPUT);
+	FileHandler& fileBinLog = cFilesHandler.at(FILE_INPUT_BINLOG);
+
+	// Open input file
+	if (!fileInput.openFile())
 	{
-		lineReadCorrectly = false;
-		updateDisplayOutputConsoleCpp("Empty line found on input CSV file.", true);
-		if(epochCounter == 0)
+		ostringstream msg;
+		msg << "Error in opening file: " << fileInput.getFilename() << endl;
+		updateDisplayOutputConsoleCpp(msg.str(), true);
+		throw MonitorException(ERROR_RETURN_FILE_OPEN_ERROR);
+	}
+	checkInputBinary();
+	if (isInputBinary)
+	{
+		updateDisplayOutputConsoleCpp("Input file is already a binary log.", true);
+		throw MonitorException(ERROR_RETURN_INCONSISTENT_INPUTS);
+	}
+
+	// Construct filename of the binary log and open the file
+	string inputFilename = fileInput.getFilename();
+	fileBinLog.setFilename(removeExtension(inputFilename) + BINLOG_EXTENSION);
+	if (!fileBinLog.openFile())
+	{
+		ostringstream msg;
+		msg << "Error in opening file: " << fileBinLog.getFilename() << endl;
+		updateDisplayOutputConsoleCpp(msg.str(), true);
+		throw MonitorException(ERROR_RETURN_FILE_OPEN_ERROR);
+	}
+
+	// Read the 1st row, which contains the field names, i.e., column names.
+	if (!readline())
+	{
+		stringstream msg;
+		msg << "Error in reading content from file: " << fileInput.getFilename() << endl;
+		updateDisplayOutputConsoleCpp(msg.str(), true);
+		throw MonitorException(ERROR_RETURN_FILE_READ_ERROR);
+	}
+
+	// Count rows in advance when possible to size the columns once
+	size_t rowsHint = 0;
+	if (fileInput.isMapped())
+	{
+		const char* ptr = fileInput.getMappedData();
+		const char* end = ptr + fileInput.getFileSize();
+		while ((ptr = (const char*)memchr(ptr, '\n', (size_t)(end - ptr))) != nullptr)
 		{
-			throw MonitorException(ERROR_RETURN_FILE_READ_ERROR);
+			rowsHint++;
+			ptr++;
 		}
 	}
-	fileLastAction = cFilesHandler.at(FILE_INPUT).getFileLastAction();
-	if (FILE_ACT_READ == fileLastAction)
+
+	// Decode all the columns of every row
+	vector<InputProjection_t> allColumnsPlan;
+	vector<vector<double>> values(totalfields);
+	vector<double> rowValues(totalfields, 0);
+	for (int column = 0; column < totalfields; column++)
 	{
-		lineReadCorrectly = true;
+		allColumnsPlan.push_back({ column, column });
+		values[column].reserve(rowsHint);
 	}
-	else if(FILE_ACT_EOF == fileLastAction)
+	StrView_t line;
+	while (FILE_ACT_READ == fileInput.readLine(line))
 	{
-		lineReadCorrectly = false;
-		return lineReadCorrectly;
+		inputLine++;
+		if (line.len == 0)
+		{
+			continue;
+		}
+		parseFields(line, allColumnsPlan, rowValues.data(), inputLine);
+		for (int column = 0; column < totalfields; column++)
+		{
+			values[column].push_back(rowValues[column]);
+		}
 	}
-	else
+
+	// GPS and HDOP go to the sparse channel
+	vector<bool> sparse(totalfields, false);
+	for (int column : { (int)sInputIds.GPS.at(0), (int)sInputIds.GPS.at(1), (int)sInputIds.HEIGHT, (int)sInputIds.HDOP })
 	{
-		lineReadCorrectly = false;
-		throw MonitorException(ERROR_RETURN_FILE_READ_ERROR);
+		if ((column >= 0) && (column < totalfields))
+		{
+			sparse[column] = true;
+		}
 	}
 
-	if (jumpLine)
+	// Write binary log
+	int numColumnsF32 = 0;
+	if (!BinaryLogWriter::write(fieldnames, values, sparse, fsImu, fsGps, fileBinLog, numColumnsF32))
 	{
-		return lineReadCorrectly;
+		ostringstream msg;
+		msg << "Error in writing content on file: " << fileBinLog.getFilename() << endl;
+		updateDisplayOutputConsoleCpp(msg.str(), true);
+		throw MonitorException(ERROR_RETURN_FILE_WRITE_ERROR);
 	}
+	ostringstream msg;
+	msg << "Binary log: " << totalfields << " columns, " << numColumnsF32 << " of them stored as float32.";
+	updateDisplayOutputConsoleCpp(msg.str(), true);
 
-	// Fill fieldvalue
-	size_t delimPos = 0;
-	string field;
-	int fieldId = 0;
-	// Since comparing against npos, can be reseted back to 0 if is not handled correctly, the following variable acts as sanity check for that.
-	try {
-		while (delimPos != readLineStr.npos)
+	// Close files
+	if (!fileInput.closeFile() || !fileBinLog.closeFile())
+	{
+		throw MonitorException(ERROR_RETURN_FILE_CLOSE_ERROR);
+	}
+}
+
+/* Benchmark field parser against strtod */
+void Input::benchmarkFieldParser(void)
+{
+	FileHandler& fileInput = cFilesHandler.at(FILE_INPUT);
+
+	// Open input file and read the 1st row, which contains the field names
+	if (!fileInput.openFile())
+	{
+		ostringstream msg;
+		msg << "Error in opening file: " << fileInput.getFilename() << endl;
+		updateDisplayOutputConsoleCpp(msg.str(), true);
+		throw MonitorException(ERROR_RETURN_FILE_OPEN_ERROR);
+	}
+	if (!readline())
+	{
+		stringstream msg;
+		msg << "Error in reading content from file: " << fileInput.getFilename() << endl;
+		updateDisplayOutputConsoleCpp(msg.str(), true);
+		throw MonitorException(ERROR_RETURN_FILE_READ_ERROR);
+	}
+
+	// Collect the fields of every column and row. The lines are copied, so that they outlive the stream buffer of non mapped inputs.
+	string content;
+	vector<pair<size_t, size_t>> fields; // Offset and length in content
+	StrView_t line;
+	while (FILE_ACT_READ == fileInput.readLine(line))
+	{
+		const size_t lineOffset = content.size();
+		content.append(line.ptr, line.len);
+		content.push_back('\n');
+		size_t fieldStart = 0;
+		while (fieldStart <= line.len)
 		{
-			// Look for when a ',' is found, this delimits the end of the field to read
-			do{
-				delimPos = readLineStr.find(",");
-			}while (delimPos == 0);
-			field = readLineStr.substr(0, delimPos); // Read field goes from start of string (index 0) until index where the ',' was found
+			const char* delimPos = (const char*)memchr(line.ptr + fieldStart, ',', line.len - fieldStart);
+			const size_t fieldEnd = (delimPos != nullptr) ? (size_t)(delimPos - line.ptr) : line.len;
+			fields.push_back({ lineOffset + fieldStart, fieldEnd - fieldStart });
+			fieldStart = fieldEnd + 1;
+		}
+	}
+	if (fields.empty())
+	{
+		updateDisplayOutputConsoleCpp("No fields to benchmark on input CSV file.", true);
+		throw MonitorException(ERROR_RETURN_FILE_READ_ERROR);
+	}
 
-			// Fill map at key = fieldcount with the value = field read
-			// The map contans, at each index, a pair of <fieldname, fieldvalue> e.g. <"latitude", 71.34>
-			if(field.length() > 0)
+	// Both parsers must give the same bits, NaN aside. strtod is called as the reader did before: field copied into a null-terminated buffer.
+	const char* data = content.data();
+	char fieldBuffer[FIELD_PARSE_BUFFER_LENGTH];
+	auto parseStrtod = [&fieldBuffer](const char* fieldStart, size_t fieldLength) -> double
+	{
+		if ((fieldLength == 0) || (fieldLength >= FIELD_PARSE_BUFFER_LENGTH))
+		{
+			return std::numeric_limits<double>::quiet_NaN();
+		}
+		memcpy(fieldBuffer, fieldStart, fieldLength);
+		fieldBuffer[fieldLength] = '\0';
+		return strtod(fieldBuffer, nullptr);
+	};
+	size_t mismatches = 0, malformed = 0;
+	for (const pair<size_t, size_t>& field : fields)
+	{
+		double valueFast = 0;
+		if (FIELD_PARSE_MALFORMED == FieldParser::parse(data + field.first, data + field.first + field.second, valueFast))
+		{
+			malformed++;
+			continue;
+		}
+		const double valueStrtod = parseStrtod(data + field.first, field.second);
+		if ((memcmp(&valueFast, &valueStrtod, sizeof(double)) != 0) && !(std::isnan(valueFast) && std::isnan(valueStrtod)))
+		{
+			if (mismatches < 10)
 			{
-				auto it = mapData.find(fieldId);
-				if (false == isFieldnameSet) // The 1st line always contains the fieldname, and subsequent lines the fieldvalue, so if fieldname is not yet set, the 1st thing to do is to set the map with the corresponding fieldnames read.
-				{
-						mapData.insert({ fieldId, InputCsvFields(field, 0) });
-				}
-				else // If fieldname is already set, then what is read from the CSV line is the fieldvalue, so we can introduce it as a double.
-				{
-					try
-					{
-						it->second.fieldvalue = strtod(field.c_str(), &eptr);
-					}
-					catch(...)
-					{
-						lineReadCorrectly = false;
-						throw MonitorException(ERROR_RETURN_FILE_READ_ERROR);
-					}
-				}
-				readLineStr = readLineStr.substr(delimPos + 1);
-				fieldId++;
+				ostringstream msg;
+				msg << std::setprecision(17) << "Mismatch on field \"" << string(data + field.first, field.second) << "\": parser " << valueFast << ", strtod " << valueStrtod;
+				updateDisplayOutputConsoleCpp(msg.str(), true);
 			}
+			mismatches++;
 		}
 	}
-	catch (...)
+
+	// Time each parser over the same fields, repeated up to a minimum number of conversions
+	const size_t iterations = std::max((size_t)1, (size_t)10000000 / fields.size());
+	volatile double sink = 0;
+	auto timeStart = std::chrono::steady_clock::now();
+	for (size_t iteration = 0; iteration < iterations; iteration++)
 	{
-		lineReadCorrectly = false;
+		double sum = 0;
+		for (const pair<size_t, size_t>& field : fields)
+		{
+			sum += parseStrtod(data + field.first, field.second);
+		}
+		sink = sink + sum;
+	}
+	const double secondsStrtod = std::chrono::duration<double>(std::chrono::steady_clock::now() - timeStart).count();
+	timeStart = std::chrono::steady_clock::now();
+	for (size_t iteration = 0; iteration < iterations; iteration++)
+	{
+		double sum = 0;
+		double value = 0;
+		for (const pair<size_t, size_t>& field : fields)
+		{
+			(void)FieldParser::parse(data + field.first, data + field.first + field.second, value);
+			sum += value;
+		}
+		sink = sink + sum;
+	}
+	const double secondsParser = std::chrono::duration<double>(std::chrono::steady_clock::now() - timeStart).count();
+
+	const double conversions = (double)fields.size() * iterations;
+	ostringstream msg;
+	msg << std::fixed << std::setprecision(2)
+		<< "Parser benchmark: " << fields.size() << " fields x " << iterations << " iterations. "
+		<< "strtod " << secondsStrtod * 1e9 / conversions << " ns/field, parser " << secondsParser * 1e9 / conversions << " ns/field, speedup "
+		<< secondsStrtod / secondsParser << "x. Mismatches: " << mismatches << ", malformed fields: " << malformed << ".";
+	updateDisplayOutputConsoleCpp(msg.str(), true);
+
+	// Close file
+	if (!fileInput.closeFile())
+	{
+		throw MonitorException(ERROR_RETURN_FILE_CLOSE_ERROR);
+	}
+}
+
+/* Convert coordinates of input CSV */
+void Input::convertCoordinates(const InputIds& sInputIds, double heightVal)
+{
+	FileHandler& fileInput = cFilesHandler.at(FILE_INPUT);
+	FileHandler& fileConversion = cFilesHandler.at(FILE_OUTPUT_CONVERSION);
+
+	// Open input file, only CSV, and read the 1st row, which contains the field names
+	if (!fileInput.openFile())
+	{
+		updateDisplayOutputConsoleCpp(openErrorMessage(fileInput), true);
+		throw MonitorException(ERROR_RETURN_FILE_OPEN_ERROR);
+	}
+	checkInputBinary();
+	if (isInputBinary)
+	{
+		updateDisplayOutputConsoleCpp("Conversion mode needs an input CSV file.", true);
+		throw MonitorException(ERROR_RETURN_INCONSISTENT_INPUTS);
+	}
+	if (!readline())
+	{
+		stringstream msg;
+		msg << "Error in reading content from file: " << fileInput.getFilename() << endl;
+		updateDisplayOutputConsoleCpp(msg.str(), true);
+		throw MonitorException(ERROR_RETURN_FILE_READ_ERROR);
+	}
+
+	// Decode the coordinates of every row: latitude and longitude in degrees, height in meters from its column or fixed
+	vector<InputProjection_t> plan = { { sInputIds.GPS.at(0), 0 }, { sInputIds.GPS.at(1), 1 } };
+	if (sInputIds.HEIGHT >= 0)
+	{
+		plan.push_back({ sInputIds.HEIGHT, 2 });
+	}
+	std::sort(plan.begin(), plan.end(), [](const InputProjection_t& a, const InputProjection_t& b)
+		{
+			return a.column < b.column;
+		});
+	std::array<vector<double>, 3> llh;
+	StrView_t line;
+	while (FILE_ACT_READ == fileInput.readLine(line))
+	{
+		inputLine++;
+		if (line.len == 0)
+		{
+			continue;
+		}
+		double rowValues[3] = { std::numeric_limits<double>::quiet_NaN(), std::numeric_limits<double>::quiet_NaN(), heightVal };
+		parseFields(line, plan, rowValues, inputLine);
+		if (std::isnan(rowValues[0]) || std::isnan(rowValues[1]) || std::isnan(rowValues[2]))
+		{
+			continue;
+		}
+		llh[0].push_back(rowValues[0] * Frames::DEG2RAD);
+		llh[1].push_back(rowValues[1] * Frames::DEG2RAD);
+		llh[2].push_back(rowValues[2]);
+	}
+	const size_t count = llh[0].size();
+	if (count == 0)
+	{
+		updateDisplayOutputConsoleCpp("No coordinates to convert on input CSV file.", true);
 		throw MonitorException(ERROR_RETURN_FILE_READ_ERROR);
 	}
 
-	// Ideally, the 1st time this function is called, the pair <fieldname,fieldvalue = 0> should be filled, and then only the fieldvalue should be updated.
+	// Batch conversions: LLH to ECEF, and ECEF to ENU with origin at the 1st point
+	std::array<vector<double>, 3> ecef, enu;
+	for (int component = 0; component < 3; component++)
+	{
+		ecef[component].resize(count);
+		enu[component].resize(count);
+	}
+	const auto timeStart = std::chrono::steady_clock::now();
+	Frames::llh2ecefBatch(llh[0].data(), llh[1].data(), llh[2].data(), ecef[0].data(), ecef[1].data(), ecef[2].data(), count);
+	const arma::vec3 ecefRef = { ecef[0][0], ecef[1][0], ecef[2][0] };
+	Frames::ecef2enuBatch(llh[0].data(), llh[1].data(), ecef[0].data(), ecef[1].data(), ecef[2].data(), ecefRef, enu[0].data(), enu[1].data(), enu[2].data(), count);
+	const double secondsBatch = std::chrono::duration<double>(std::chrono::steady_clock::now() - timeStart).count();
+
+	// Write the conversion output file
+	if (!fileConversion.openFile())
+	{
+		updateDisplayOutputConsoleCpp(openErrorMessage(fileConversion), true);
+		throw MonitorException(ERROR_RETURN_FILE_OPEN_ERROR);
+	}
+	string content = "LAT,LON,HEIGHT,ECEF_X,ECEF_Y,ECEF_Z,ENU_E,ENU_N,ENU_U\n";
+	char row[256];
+	bool isWritten = true;
+	for (size_t point = 0; (point < count) && isWritten; point++)
+	{
+		const int length = snprintf(row, sizeof(row), "%.10f,%.10f,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f\n",
+			llh[0][point] * Frames::RAD2DEG, llh[1][point] * Frames::RAD2DEG, llh[2][point],
+			ecef[0][point], ecef[1][point], ecef[2][point], enu[0][point], enu[1][point], enu[2][point]);
+		content.append(row, (size_t)std::max(length, 0));
+		if ((content.size() >= ((size_t)1 << 20)) || (point + 1 == count))
+		{
+			isWritten = (FILE_ACT_WRITTEN == fileConversion.writeContent(content.data(), content.size()));
+			content.clear();
+		}
+	}
+	if (!isWritten)
+	{
+		ostringstream msg;
+		msg << "Error in writing content on file: " << fileConversion.getFilename() << endl;
+		updateDisplayOutputConsoleCpp(msg.str(), true);
+		throw MonitorException(ERROR_RETURN_FILE_WRITE_ERROR);
+	}
+
+	ostringstream msg;
+	msg << "Conversion: " << count << " points, " << Frames::getBatchKernelName(Frames::getBatchKernel()) << " kernel, "
+		<< std::fixed << std::setprecision(2) << secondsBatch * 1e9 / count << " ns/point.";
+	updateDisplayOutputConsoleCpp(msg.str(), true);
+
+	// Close files
+	if (!fileInput.closeFile() || !fileConversion.closeFile())
+	{
+		throw MonitorException(ERROR_RETURN_FILE_CLOSE_ERROR);
+	}
+}
+
+/* Read binary log row */
+bool Input::readBinaryRow(InputSlots_t& rowSlots, bool jumpLine)
+{
+	// 1st row: field names come from the schema
 	if (false == isFieldnameSet)
 	{
+		fieldnames.clear();
+		for (int column = 0; column < cBinaryLog.getNumColumns(); column++)
+		{
+			fieldnames.push_back(cBinaryLog.getColumnName(column));
+		}
+		totalfields = (int)fieldnames.size();
 		isFieldnameSet = true;
+		if ((cBinaryLog.getFsImu() != UI::getInstance().getInputValues().fsImu) || (cBinaryLog.getFsGps() != UI::getInstance().getInputValues().fsGps))
+		{
+			ostringstream msg;
+			msg << "Sampling rates in binary log (" << cBinaryLog.getFsImu() << "," << cBinaryLog.getFsGps() << ") differ from the entered ones, the entered ones are used.";
+			updateDisplayOutputConsoleCpp(msg.str(), true);
+		}
+		return true;
 	}
 
+	if (binaryRow >= cBinaryLog.getNumRows())
+	{
+		return false;
+	}
 
-	return lineReadCorrectly;
+	// Sparse channel holds the last entry started at or before the current row
+	while ((binarySparseEntry + 1 < cBinaryLog.getNumSparseEntries()) && (cBinaryLog.getSparseRow(binarySparseEntry + 1) <= binaryRow))
+	{
+		binarySparseEntry++;
+	}
+
+	if (!jumpLine)
+	{
+		for (const InputProjection_t& projection : projectionPlan)
+		{
+			rowSlots[projection.slot] = cBinaryLog.getValue(projection.column, cBinaryLog.isColumnSparse(projection.column) ? binarySparseEntry : binaryRow);
+		}
+	}
+	binaryRow++;
+
+	// Report progress as the fraction of rows read
+	FileHandler& fileInput = cFilesHandler.at(FILE_INPUT);
+	fileInput.setMappedOffset((size_t)((double)fileInput.getFileSize() * binaryRow / cBinaryLog.getNumRows()));
+
+	return true;
 }
 
-/* Get fieldvalue for corresponding field ID */
-const double Input::getFieldvalue(int id)
+/* Read input line */
+bool Input::readline(bool jumpLine, int epochCounter)
 {
-	double ret = 0;
-	try {
-		auto it = mapData.find(id);
-		if (it != mapData.end())
+	if ((blockRows == 0) || jumpLine)
+	{
+		return readWindowRow(jumpLine, epochCounter);
+	}
+
+	// Next block once all the rows of the current one are returned. A read error is raised after the rows read before it.
+	while (blockNextRow >= block.numRows)
+	{
+		if (block.error != nullptr)
 		{
-			ret = it->second.fieldvalue; // Need to check for the range
+			const std::exception_ptr error = block.error;
+			block.error = nullptr;
+			isBlockEnd = true;
+			std::rethrow_exception(error);
 		}
-		else
+		if (isBlockEnd)
 		{
-			updateDisplayOutputConsoleCpp("Out of range in fieldvalue when trying to read index from CSV. Check if CSV indexes (columns) are correct.", true);
-			throw MonitorException(ERROR_RETURN_OUT_RANGE);
+			return false;
 		}
+		readBlock(epochCounter);
 	}
-	catch (const MonitorException&)
+	const size_t row = blockNextRow++;
+	for (int slot = 0; slot < SLOT_TOTAL; slot++)
 	{
-		throw;
+		slots[slot] = block.columns[slot][row];
+	}
+	isGnssNew = block.isGnssNew[row];
+	return true;
+}
+
+/* Read rows ahead into the block */
+void Input::readBlock(int epochCounter)
+{
+	block.numRows = 0;
+	block.sequence++;
+	blockNextRow = 0;
+	try
+	{
+		// Each row is read with the epoch counter it is processed with, e.g. an empty line is only an error on the 1st epoch
+		while (block.numRows < blockRows)
+		{
+			if (!readWindowRow(false, epochCounter + (int)block.numRows))
+			{
+				isBlockEnd = true;
+				break;
+			}
+			const size_t row = block.numRows;
+			for (int slot = 0; slot < SLOT_TOTAL; slot++)
+			{
+				block.columns[slot][row] = slots[slot];
+			}
+			block.isGnssNew[row] = isGnssNew;
+			block.readBytes[row] = getSourceReadBytes();
+			block.numRows++;
+		}
+	}
+	catch (...)
+	{
+		block.error = std::current_exception();
+	}
+}
+
+/* Start reading by blocks */
+void Input::startBlocks(size_t rows)
+{
+	blockRows = cFilesHandler.at(FILE_INPUT).isStream() ? 1 : std::min(std::max(rows, (size_t)1), INPUT_BLOCK_MAX_ROWS);
+	block.numRows = 0;
+	block.error = nullptr;
+	blockNextRow = 0;
+	isBlockEnd = false;
+}
+
+/* Get block */
+const InputBlock_t& Input::getBlock(void) const
+{
+	return block;
+}
+
+/* Get row of the block */
+size_t Input::getBlockRow(void) const
+{
+	return blockNextRow - 1;
+}
+
+/* Read input row within the time window */
+bool Input::readWindowRow(bool jumpLine, int epochCounter)
+{
+	bool lineReadCorrectly = readNextRow(jumpLine, epochCounter);
+	if (!isTimeWindow || jumpLine)
+	{
+		return lineReadCorrectly;
+	}
+	// Rows before the warm-up are skipped, after a seek at most the rows between two entries of the index. The 1st row after the window ends the input.
+	while (lineReadCorrectly && (slots[SLOT_TIMESTAMP] < timeWindowFirst))
+	{
+		lineReadCorrectly = readNextRow(jumpLine, epochCounter);
+	}
+	return lineReadCorrectly && !(slots[SLOT_TIMESTAMP] > timeWindowEnd);
+}
+
+/* Read next input row */
+bool Input::readNextRow(bool jumpLine, int epochCounter)
+{
+	if (isReaderRunning)
+	{
+		return popRow(jumpLine);
+	}
+	if (isIngested)
+	{
+		return replayRow(jumpLine, epochCounter);
+	}
+	return readRow(slots, isGnssNew, jumpLine, epochCounter);
+}
+
+/* Read input row */
+bool Input::readRow(InputSlots_t& rowSlots, bool& rowGnssNew, bool jumpLine, int epochCounter)
+{
+	rowGnssNew = false;
+	const bool isHeader = (false == isFieldnameSet);
+	const bool lineReadCorrectly = isInputBinary ? readBinaryRow(rowSlots, jumpLine) : readCsvRow(rowSlots, jumpLine, epochCounter);
+	if (sources.empty() || !lineReadCorrectly)
+	{
+		return lineReadCorrectly;
+	}
+
+	// Additional input files: field names along with the ones of the main input, then rows merged up to the timestamp of each main input row
+	if (isHeader)
+	{
+		for (InputSource_t& source : sources)
+		{
+			readSourceHeader(source);
+		}
+	}
+	else if (!jumpLine)
+	{
+		mergeSources(rowSlots, rowGnssNew);
+	}
+	return lineReadCorrectly;
+}
+
+/* Read input CSV row */
+bool Input::readCsvRow(InputSlots_t& rowSlots, bool jumpLine, int epochCounter)
+{
+	bool lineReadCorrectly = false;
+
+	// Read line. No copy is done when the input file is memory mapped, the line points directly into the file content.
+	StrView_t line;
+	IoFilesAction_e fileLastAction;
+	cFilesHandler.at(FILE_INPUT).readLine(line);
+	fileLastAction = cFilesHandler.at(FILE_INPUT).getFileLastAction();
+	if (FILE_ACT_READ == fileLastAction)
+	{
+		lineReadCorrectly = true;
+		inputLine++;
 	}
-	return ret;
+	else if(FILE_ACT_EOF == fileLastAction)
+	{
+		lineReadCorrectly = false;
+		if (epochCounter == 0 && false == isFieldnameSet)
+		{
+			updateDisplayOutputConsoleCpp("Empty input CSV file.", true);
+			throw MonitorException(ERROR_RETURN_FILE_READ_ERROR);
+		}
+		return lineReadCorrectly;
+	}
+	else
+	{
+		lineReadCorrectly = false;
+		ostringstream msg;
+		msg << "Error in reading content from file: " << cFilesHandler.at(FILE_INPUT).getFilename();
+		updateDisplayOutputConsoleCpp(msg.str(), true);
+		throw MonitorException(ERROR_RETURN_FILE_READ_ERROR);
+	}
+
+	if (!(line.len > 0))
+	{
+		updateDisplayOutputConsoleCpp("Empty line found on input CSV file.", true);
+		if(epochCounter == 0)
+		{
+			throw MonitorException(ERROR_RETURN_FILE_READ_ERROR);
+		}
+		// Nothing to parse, keep the values of the previous row.
+		return lineReadCorrectly;
+	}
+
+	if (jumpLine)
+	{
+		return lineReadCorrectly;
+	}
+
+	// The 1st line always contains the fieldnames, and subsequent lines the fieldvalues.
+	if (false == isFieldnameSet)
+	{
+		readFieldnames(line, fieldnames);
+		totalfields = (int)fieldnames.size();
+		isFieldnameSet = true;
+		return lineReadCorrectly;
+	}
+
+	// Fill the slots following the projection plan
+	parseFields(line, projectionPlan, rowSlots.data(), inputLine);
+
+	return lineReadCorrectly;
+}
+
+/* Split field names */
+void Input::readFieldnames(const StrView_t& line, std::vector<std::string>& names)
+{
+	const char* fieldStart = line.ptr;
+	const char* lineEnd = line.ptr + line.len;
+	const char* delimPos = nullptr;
+	while (fieldStart < lineEnd)
+	{
+		// Look for when a ',' is found, this delimits the end of the field to read. Last field may not be followed by a ','.
+		delimPos = (const char*)memchr(fieldStart, ',', (size_t)(lineEnd - fieldStart));
+		if (delimPos == nullptr)
+		{
+			delimPos = lineEnd;
+		}
+		names.push_back(string(fieldStart, (size_t)(delimPos - fieldStart)));
+		fieldStart = delimPos + 1;
+	}
+}
+
+/* Get additional input file */
+const InputSource_t* Input::findSource(int fileIndex) const
+{
+	for (const InputSource_t& source : sources)
+	{
+		if (source.fileIndex == fileIndex)
+		{
+			return &source;
+		}
+	}
+	return nullptr;
+}
+
+/* Read field names of additional input file */
+void Input::readSourceHeader(InputSource_t& source)
+{
+	FileHandler& fileSource = cFilesHandler.at(source.fileIndex);
+	StrView_t line;
+	if ((FILE_ACT_READ != fileSource.readLine(line)) || (line.len == 0))
+	{
+		ostringstream msg;
+		msg << "Empty input CSV file: " << fileSource.getFilename();
+		updateDisplayOutputConsoleCpp(msg.str(), true);
+		throw MonitorException(ERROR_RETURN_FILE_READ_ERROR);
+	}
+	source.line = 1;
+	source.fieldnames.clear();
+	readFieldnames(line, source.fieldnames);
+}
+
+/* Read ahead row of additional input file */
+void Input::readSourceRow(InputSource_t& source)
+{
+	FileHandler& fileSource = cFilesHandler.at(source.fileIndex);
+	StrView_t line;
+	source.hasNext = false;
+	while (FILE_ACT_READ == fileSource.readLine(line))
+	{
+		source.line++;
+		// Empty lines are skipped, the previous row holds until the next one
+		if (line.len == 0)
+		{
+			continue;
+		}
+		// Plan entries missing on short rows keep the previous values, except the timestamp, needed to merge the row
+		source.next[SLOT_TIMESTAMP] = arma::datum::nan;
+		parseFields(line, source.plan, source.next.data(), source.line, source.fileIndex);
+		if (std::isnan(source.next[SLOT_TIMESTAMP]))
+		{
+			ostringstream msg;
+			msg << "Missing timestamp found on input CSV file: " << fileSource.getFilename() << ", line " << source.line << ".";
+			updateDisplayOutputConsoleCpp(msg.str(), true);
+			throw MonitorException(ERROR_RETURN_FILE_READ_ERROR);
+		}
+		source.hasNext = true;
+		return;
+	}
+	if (FILE_ACT_EOF != fileSource.getFileLastAction())
+	{
+		throw MonitorException(ERROR_RETURN_FILE_READ_ERROR);
+	}
+}
+
+/* Merge rows of additional input files */
+void Input::mergeSources(InputSlots_t& rowSlots, bool& rowGnssNew)
+{
+	// k-way merge by timestamp: the earliest row read ahead among the files is applied, until all of them are later than the main input row.
+	// Rows with the same timestamp as the main input row belong to its epoch.
+	const double epochTime = rowSlots[SLOT_TIMESTAMP];
+	while (true)
+	{
+		InputSource_t* earliest = nullptr;
+		for (InputSource_t& source : sources)
+		{
+			if (source.hasNext && (source.next[SLOT_TIMESTAMP] <= epochTime) && ((earliest == nullptr) || (source.next[SLOT_TIMESTAMP] < earliest->next[SLOT_TIMESTAMP])))
+			{
+				earliest = &source;
+			}
+		}
+		if (earliest == nullptr)
+		{
+			break;
+		}
+		for (const InputProjection_t& projection : earliest->plan)
+		{
+			if (projection.slot != SLOT_TIMESTAMP)
+			{
+				rowSlots[projection.slot] = earliest->next[projection.slot];
+			}
+		}
+		rowGnssNew = rowGnssNew || earliest->isGnss;
+		readSourceRow(*earliest);
+	}
+}
+
+/* Start reader thread */
+void Input::startReader(size_t capacity, RingWaitPolicy_e policy)
+{
+	stopReader();
+	ringRows.initialize(capacity, policy);
+	readerException = nullptr;
+	readerReadBytes = cFilesHandler.at(FILE_INPUT).getReadBytes();
+	isReaderRunning = true;
+	readerThread = std::thread(&Input::runReader, this);
+}
+
+/* Reader thread loop */
+void Input::runReader(void)
+{
+	// The thread owns its own copy of the slots, so that values held from previous rows (e.g. empty fields) follow the same rules as without thread.
+	InputEpoch_t epoch;
+	epoch.slots = slots;
+	int epochCounter = 0;
+	try
+	{
+		while (readRow(epoch.slots, epoch.isGnssNew, false, epochCounter))
+		{
+			epoch.readBytes = cFilesHandler.at(FILE_INPUT).getReadBytes();
+			if (!ringRows.push(epoch)) // Closed by the processing thread
+			{
+				break;
+			}
+			epochCounter++;
+		}
+	}
+	catch (...)
+	{
+		readerException = std::current_exception();
+	}
+	ringRows.close();
+}
+
+/* Pop row from the ring */
+bool Input::popRow(bool jumpLine)
+{
+	InputEpoch_t epoch;
+	if (!ringRows.pop(epoch))
+	{
+		// End of input: the error of the reader thread, if any, is raised here as if read in this thread
+		stopReader();
+		if (readerException != nullptr)
+		{
+			std::rethrow_exception(readerException);
+		}
+		return false;
+	}
+	readerReadBytes = epoch.readBytes;
+	if (!jumpLine)
+	{
+		slots = epoch.slots;
+		isGnssNew = epoch.isGnssNew;
+	}
+	return true;
+}
+
+/* Stop reader thread */
+void Input::stopReader(void)
+{
+	if (!readerThread.joinable())
+	{
+		return;
+	}
+	ringRows.close();
+	readerThread.join();
+	isReaderRunning = false;
+
+	ostringstream msg;
+	msg << "Reader ring: capacity " << ringRows.getCapacity() << " rows, reader stalls (ring full) " << ringRows.getProducerStalls()
+		<< ", processing stalls (ring empty) " << ringRows.getConsumerStalls() << ".";
+	updateDisplayOutputConsoleCpp(msg.str(), true);
+}
+
+/* Parallel ingest of the input CSV */
+void Input::ingestParallel(int numThreads)
+{
+	FileHandler& fileInput = cFilesHandler.at(FILE_INPUT);
+	if (isInputBinary || !fileInput.isMapped() || !sources.empty())
+	{
+		updateDisplayOutputConsoleCpp("Parallel ingest needs a single memory mapped input CSV, input is read row by row.", true);
+		return;
+	}
+	// More threads than cores would only add switching, the number of cores is used instead
+	const int numCores = std::max(1, (int)std::thread::hardware_concurrency());
+	if (numThreads > numCores)
+	{
+		numThreads = numCores;
+	}
+	numThreads = std::max(1, std::min(numThreads, INGEST_MAX_THREADS));
+	const auto timeStart = std::chrono::steady_clock::now();
+
+	// Split the rows left after the header in byte ranges of similar size, each one ending right after a line break
+	ingestStartOffset = fileInput.getReadBytes();
+	const char* begin = fileInput.getMappedData() + ingestStartOffset;
+	const char* end = fileInput.getMappedData() + fileInput.getFileSize();
+	const char* chunkBegin = begin;
+	ingestChunks.assign(numThreads, InputChunk_t());
+	for (int chunkIndex = 0; chunkIndex < numThreads; chunkIndex++)
+	{
+		const char* chunkEnd = end;
+		if (chunkIndex < numThreads - 1)
+		{
+			const char* split = begin + (end - begin) * (chunkIndex + 1) / numThreads;
+			chunkEnd = chunkBegin;
+			if (split > chunkBegin)
+			{
+				const char* lineBreak = (const char*)memchr(split - 1, '\n', (size_t)(end - split + 1));
+				chunkEnd = (lineBreak != nullptr) ? lineBreak + 1 : end;
+			}
+		}
+		ingestChunks[chunkIndex].begin = chunkBegin;
+		ingestChunks[chunkIndex].end = chunkEnd;
+		chunkBegin = chunkEnd;
+	}
+
+	// Count the lines of each chunk first, so that every chunk knows the line number of its 1st row (needed to report malformed fields)
+	runIngestTask(&Input::countChunkLines);
+	long long nextLine = inputLine + 1;
+	for (InputChunk_t& chunk : ingestChunks)
+	{
+		chunk.firstLine = nextLine;
+		nextLine += (long long)chunk.numLines;
+	}
+
+	// Decode the chunks
+	runIngestTask(&Input::ingestChunk);
+
+	ingestRowsTotal = 0;
+	for (const InputChunk_t& chunk : ingestChunks)
+	{
+		ingestRowsTotal += chunk.decoded.size();
+	}
+	ingestChunkIndex = 0;
+	ingestRowIndex = 0;
+	ingestRowsRead = 0;
+	isIngested = true;
+	fileInput.setMappedOffset((size_t)fileInput.getFileSize());
+
+	ostringstream msg;
+	msg << "Parallel ingest: " << ingestRowsTotal << " rows decoded in " << numThreads << " threads, "
+		<< std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - timeStart).count() << " ms.";
+	updateDisplayOutputConsoleCpp(msg.str(), true);
+}
+
+/* Run ingest task on every chunk */
+void Input::runIngestTask(void (Input::*task)(InputChunk_t&))
+{
+	// The 1st chunk is handled in this thread
+	vector<std::thread> workers;
+	for (size_t chunkIndex = 1; chunkIndex < ingestChunks.size(); chunkIndex++)
+	{
+		workers.emplace_back(task, this, std::ref(ingestChunks[chunkIndex]));
+	}
+	(this->*task)(ingestChunks[0]);
+	for (std::thread& worker : workers)
+	{
+		worker.join();
+	}
+}
+
+/* Count lines of chunk of the input CSV */
+void Input::countChunkLines(InputChunk_t& chunk)
+{
+	// Every line ends with a line break, except maybe the last one of the file
+	chunk.numLines = 0;
+	for (const char* ptr = chunk.begin; (ptr = (const char*)memchr(ptr, '\n', (size_t)(chunk.end - ptr))) != nullptr; ptr++)
+	{
+		chunk.numLines++;
+	}
+	if ((chunk.end > chunk.begin) && (*(chunk.end - 1) != '\n'))
+	{
+		chunk.numLines++;
+	}
+}
+
+/* Decode chunk of the input CSV */
+void Input::ingestChunk(InputChunk_t& chunk)
+{
+	const size_t planSize = projectionPlan.size();
+
+	// Size the arrays once
+	chunk.columns.assign(planSize, vector<double>());
+	for (vector<double>& column : chunk.columns)
+	{
+		column.reserve(chunk.numLines);
+	}
+	chunk.decoded.reserve(chunk.numLines);
+
+	// Same line splitting as FileHandler::readLine(). Values of plan entries not found on a row are stored but not replayed.
+	InputSlots_t rowSlots;
+	rowSlots.fill(0);
+	StrView_t line;
+	const char* lineStart = chunk.begin;
+	try
+	{
+		while (lineStart < chunk.end)
+		{
+			const char* lineEnd = (const char*)memchr(lineStart, '\n', (size_t)(chunk.end - lineStart));
+			if (lineEnd == nullptr)
+			{
+				lineEnd = chunk.end;
+			}
+			line.ptr = lineStart;
+			line.len = (size_t)(lineEnd - lineStart);
+			if ((line.len > 0) && (line.ptr[line.len - 1] == '\r'))
+			{
+				line.len--;
+			}
+			lineStart = lineEnd + 1;
+
+			const long long lineNumber = chunk.firstLine + (long long)chunk.decoded.size();
+			const size_t found = (line.len > 0) ? parseFields(line, projectionPlan, rowSlots.data(), lineNumber) : INGEST_ROW_EMPTY;
+			for (size_t planIndex = 0; planIndex < planSize; planIndex++)
+			{
+				chunk.columns[planIndex].push_back(rowSlots[projectionPlan[planIndex].slot]);
+			}
+			chunk.decoded.push_back((uint8_t)found);
+		}
+	}
+	catch (...)
+	{
+		// Raised when the replay reaches this row
+		chunk.error = std::current_exception();
+	}
+}
+
+/* Replay row decoded by the parallel ingest */
+bool Input::replayRow(bool jumpLine, int epochCounter)
+{
+	while ((ingestChunkIndex < ingestChunks.size()) && (ingestRowIndex >= ingestChunks[ingestChunkIndex].decoded.size()))
+	{
+		if (ingestChunks[ingestChunkIndex].error != nullptr)
+		{
+			std::rethrow_exception(ingestChunks[ingestChunkIndex].error);
+		}
+		ingestChunkIndex++;
+		ingestRowIndex = 0;
+	}
+	if (ingestChunkIndex >= ingestChunks.size())
+	{
+		return false;
+	}
+
+	const InputChunk_t& chunk = ingestChunks[ingestChunkIndex];
+	const size_t row = ingestRowIndex++;
+	ingestRowsRead++;
+	isGnssNew = false;
+
+	// Same handling as readRow(): empty lines keep the previous values, as well as the plan entries missing on short lines
+	if (chunk.decoded[row] == INGEST_ROW_EMPTY)
+	{
+		updateDisplayOutputConsoleCpp("Empty line found on input CSV file.", true);
+		if (epochCounter == 0)
+		{
+			throw MonitorException(ERROR_RETURN_FILE_READ_ERROR);
+		}
+		return true;
+	}
+	if (!jumpLine)
+	{
+		for (size_t planIndex = 0; planIndex < chunk.decoded[row]; planIndex++)
+		{
+			slots[projectionPlan[planIndex].slot] = chunk.columns[planIndex][row];
+		}
+	}
+	return true;
+}
+
+/* Get input bytes consumed */
+long long Input::getReadBytes(void)
+{
+	if ((blockRows > 0) && (blockNextRow > 0))
+	{
+		return block.readBytes[blockNextRow - 1];
+	}
+	return getSourceReadBytes();
+}
+
+/* Get input bytes consumed by the source of the rows */
+long long Input::getSourceReadBytes(void)
+{
+	if (isReaderRunning)
+	{
+		return readerReadBytes;
+	}
+	if (isIngested)
+	{
+		// Rows are not tracked by offset once in memory, progress is the fraction of rows replayed
+		const long long ingestBytes = cFilesHandler.at(FILE_INPUT).getFileSize() - ingestStartOffset;
+		return ingestStartOffset + ((ingestRowsTotal > 0) ? (long long)((double)ingestBytes * ingestRowsRead / ingestRowsTotal) : ingestBytes);
+	}
+	return cFilesHandler.at(FILE_INPUT).getReadBytes();
+}
+
+/* Decode fields following a projection plan */
+size_t Input::parseFields(const StrView_t& line, const std::vector<InputProjection_t>& plan, double* values, long long lineNumber, int fileIndex)
+{
+	// Fields are delimited directly on the line buffer, and only the columns in the plan are converted, in place.
+	const char* fieldStart = line.ptr;
+	const char* lineEnd = line.ptr + line.len;
+	const char* delimPos = nullptr;
+	double fieldvalue = 0;
+	const size_t planSize = plan.size();
+	size_t planIndex = 0;
+	int fieldId = 0;
+	while ((fieldStart < lineEnd) && (planIndex < planSize)) // No need to look further than the last column in the plan
+	{
+		delimPos = (const char*)memchr(fieldStart, ',', (size_t)(lineEnd - fieldStart));
+		if (delimPos == nullptr)
+		{
+			delimPos = lineEnd;
+		}
+
+		if (fieldId == plan[planIndex].column)
+		{
+			// Empty field: no data for this column on this row, value is NaN
+			if (FIELD_PARSE_MALFORMED == FieldParser::parse(fieldStart, delimPos, fieldvalue))
+			{
+				reportFieldError(lineNumber, fieldId, fieldStart, (size_t)(delimPos - fieldStart), fileIndex);
+			}
+			// Same column may be used for several slots
+			while ((planIndex < planSize) && (fieldId == plan[planIndex].column))
+			{
+				values[plan[planIndex].slot] = fieldvalue;
+				planIndex++;
+			}
+		}
+		fieldStart = delimPos + 1;
+		fieldId++;
+	}
+	return planIndex;
+}
+
+/* Report malformed field */
+void Input::reportFieldError(long long lineNumber, int column, const char* fieldStart, size_t fieldLength, int fileIndex)
+{
+	const InputSource_t* source = findSource(fileIndex);
+	const std::vector<std::string>& names = (source != nullptr) ? source->fieldnames : fieldnames;
+	ostringstream msg;
+	msg << "Malformed field \"" << string(fieldStart, fieldLength) << "\" found on input CSV file: " << cFilesHandler.at(fileIndex).getFilename()
+		<< ", line " << lineNumber << ", column " << column;
+	if (column < (int)names.size())
+	{
+		msg << " (" << names[column] << ")";
+	}
+	msg << ".";
+	updateDisplayOutputConsoleCpp(msg.str(), true);
+	throw MonitorException(ERROR_RETURN_FILE_READ_ERROR);
+}
+
+/* Build the projection plan from the input IDs */
+void Input::buildProjectionPlan(const InputIds& sInputIds)
+{
+	const std::array<std::pair<int, InputSlots_e>, SLOT_TOTAL> columnsToSlots{{
+		{ sInputIds.ACC.at(0), SLOT_ACC_X }, { sInputIds.ACC.at(1), SLOT_ACC_Y }, { sInputIds.ACC.at(2), SLOT_ACC_Z },
+		{ sInputIds.GYR.at(0), SLOT_GYR_X }, { sInputIds.GYR.at(1), SLOT_GYR_Y }, { sInputIds.GYR.at(2), SLOT_GYR_Z },
+		{ sInputIds.MAG.at(0), SLOT_MAG_X }, { sInputIds.MAG.at(1), SLOT_MAG_Y }, { sInputIds.MAG.at(2), SLOT_MAG_Z },
+		{ sInputIds.ROLL, SLOT_ROLL }, { sInputIds.PITCH, SLOT_PITCH }, { sInputIds.YAW, SLOT_YAW },
+		{ sInputIds.GPS.at(0), SLOT_LAT }, { sInputIds.GPS.at(1), SLOT_LON }, { sInputIds.HEIGHT, SLOT_HEIGHT },
+		{ sInputIds.HDOP, SLOT_HDOP },
+		{ sInputIds.TIMESTAMP, SLOT_TIMESTAMP }
+	}};
+
+	// Each additional input file is merged by its own timestamp, and the main input needs one to merge them
+	projectionPlan.clear();
+	for (InputSource_t& source : sources)
+	{
+		const int timestampColumn = (source.fileIndex == FILE_INPUT_GNSS) ? sInputIds.TIMESTAMP_GNSS : sInputIds.TIMESTAMP_AUX;
+		if ((sInputIds.TIMESTAMP == -1) || (timestampColumn == -1))
+		{
+			updateDisplayOutputConsoleCpp("Timestamp columns (-S) must be entered for every input file when GNSS (-G) or magnetometer/attitude (-U) files are entered.", true);
+			throw MonitorException(ERROR_RETURN_INCONSISTENT_INPUTS);
+		}
+		if ((timestampColumn < 0) || (timestampColumn >= (int)source.fieldnames.size()))
+		{
+			updateDisplayOutputConsoleCpp("Out of range in fieldvalue when trying to read index from CSV. Check if CSV indexes (columns) are correct.", true);
+			throw MonitorException(ERROR_RETURN_OUT_RANGE);
+		}
+		source.plan.clear();
+		source.plan.push_back({ timestampColumn, SLOT_TIMESTAMP });
+		source.next.fill(arma::datum::nan);
+	}
+
+	for (const auto& columnToSlot : columnsToSlots)
+	{
+		if (columnToSlot.first == -1) // Not entered
+		{
+			continue;
+		}
+		// GNSS and magnetometer/attitude columns are read from their own file, if entered
+		InputSource_t* source = nullptr;
+		for (InputSource_t& candidate : sources)
+		{
+			const bool isGnssSlot = (columnToSlot.second >= SLOT_LAT) && (columnToSlot.second <= SLOT_HDOP);
+			const bool isAuxSlot = (columnToSlot.second >= SLOT_MAG_X) && (columnToSlot.second <= SLOT_YAW);
+			if ((isGnssSlot && (candidate.fileIndex == FILE_INPUT_GNSS)) || (isAuxSlot && (candidate.fileIndex == FILE_INPUT_AUX)))
+			{
+				source = &candidate;
+			}
+		}
+		std::vector<InputProjection_t>& plan = (source != nullptr) ? source->plan : projectionPlan;
+		const int numColumns = (source != nullptr) ? (int)source->fieldnames.size() : totalfields;
+		if ((columnToSlot.first < 0) || (columnToSlot.first >= numColumns))
+		{
+			updateDisplayOutputConsoleCpp("Out of range in fieldvalue when trying to read index from CSV. Check if CSV indexes (columns) are correct.", true);
+			throw MonitorException(ERROR_RETURN_OUT_RANGE);
+		}
+		plan.push_back({ columnToSlot.first, columnToSlot.second });
+	}
+
+	// Sort by column so that each row is scanned only once, from left to right
+	auto sortByColumn = [](std::vector<InputProjection_t>& plan)
+	{
+		std::stable_sort(plan.begin(), plan.end(), [](const InputProjection_t& a, const InputProjection_t& b)
+			{
+				return a.column < b.column;
+			});
+	};
+	sortByColumn(projectionPlan);
+	for (InputSource_t& source : sources)
+	{
+		sortByColumn(source.plan);
+		// Values of the additional files are NaN until their 1st row is merged, e.g. GPS invalid while the GNSS file starts later than the main input
+		for (const InputProjection_t& projection : source.plan)
+		{
+			if (projection.slot != SLOT_TIMESTAMP)
+			{
+				slots[projection.slot] = arma::datum::nan;
+			}
+		}
+		// Read ahead the 1st row of each additional file
+		readSourceRow(source);
+	}
+}
+
+/* Get the decoded values of the last row read */
+const InputSlots_t& Input::getSlots(void) const
+{
+	return slots;
+}
+
+/* Check if GNSS arrivals are signalled */
+bool Input::hasGnssArrivals(void) const
+{
+	return findSource(FILE_INPUT_GNSS) != nullptr;
+}
+
+/* Get GNSS arrival with the last row read */
+bool Input::getIsGnssNew(void) const
+{
+	return isGnssNew;
+}
+
+/* Seek time window */
+void Input::seekTimeWindow(const InputIds& sInputIds, double timeStart, double timeEnd, double warmup)
+{
+	if ((timeStart < 0) && (timeEnd < 0)) // Whole input
+	{
+		return;
+	}
+	if (sInputIds.TIMESTAMP == -1)
+	{
+		updateDisplayOutputConsoleCpp("Timestamp column (-S) must be entered to process a time window (-s).", true);
+		throw MonitorException(ERROR_RETURN_INCONSISTENT_INPUTS);
+	}
+	isTimeWindow = true;
+	timeWindowStart = (timeStart < 0) ? -std::numeric_limits<double>::infinity() : timeStart;
+	timeWindowFirst = timeWindowStart - warmup;
+	timeWindowEnd = (timeEnd < 0) ? std::numeric_limits<double>::infinity() : timeEnd;
+
+	// Only a mapped CSV can be seeked, the rest of the inputs are read from the start
+	FileHandler& fileInput = cFilesHandler.at(FILE_INPUT);
+	if ((timeStart < 0) || isInputBinary || !fileInput.isMapped())
+	{
+		return;
+	}
+
+	// Index saved next to the input file, as the CSV column index. Rebuilt if missing or out of date.
+	const string indexFilename = removeExtension(fileInput.getFilename()) + SEEK_INDEX_SUFFIX;
+	const char* data = fileInput.getMappedData();
+	const size_t fileSize = (size_t)fileInput.getFileSize();
+	if (!cSeekIndex.load(indexFilename, sInputIds.TIMESTAMP, data, fileSize) && !buildSeekIndex(sInputIds, indexFilename))
+	{
+		return;
+	}
+
+	// The row seeked must be the one indexed, else the input changed after the index was saved
+	const SeekEntry_t* entry = cSeekIndex.lookup(timeWindowFirst);
+	if ((entry != nullptr) && !cSeekIndex.isEntryValid(data, fileSize, *entry))
+	{
+		updateDisplayOutputConsoleCpp("Seek index out of date with the input CSV, rebuilding it.", true);
+		if (!buildSeekIndex(sInputIds, indexFilename))
+		{
+			return;
+		}
+		entry = cSeekIndex.lookup(timeWindowFirst);
+	}
+	if ((entry != nullptr) && ((long long)entry->offset > fileInput.getReadBytes()))
+	{
+		fileInput.setMappedOffset((size_t)entry->offset);
+		inputLine = (long long)entry->line - 1;
+		ostringstream msg;
+		msg << "Input seeked to line " << entry->line << ", timestamp " << entry->timestamp << ".";
+		updateDisplayOutputConsoleCpp(msg.str(), true);
+	}
+}
+
+/* Build seek index */
+bool Input::buildSeekIndex(const InputIds& sInputIds, const string& indexFilename)
+{
+	FileHandler& fileInput = cFilesHandler.at(FILE_INPUT);
+	const auto timeBuildStart = std::chrono::steady_clock::now();
+	if (!cSeekIndex.build(fileInput.getMappedData(), (size_t)fileInput.getFileSize(), (size_t)fileInput.getReadBytes(), sInputIds.TIMESTAMP))
+	{
+		updateDisplayOutputConsoleCpp("Seek index not built, timestamps of the input CSV are missing or decreasing. Input is read from the start.", true);
+		return false;
+	}
+	const double elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - timeBuildStart).count();
+	ostringstream msg;
+	msg << "Seek index built: " << cSeekIndex.size() << " entries in " << elapsedMs << " ms.";
+	updateDisplayOutputConsoleCpp(msg.str(), true);
+	if (!cSeekIndex.save(indexFilename))
+	{
+		ostringstream msgSave;
+		msgSave << "Error in writing content on file: " << indexFilename;
+		updateDisplayOutputConsoleCpp(msgSave.str(), true);
+	}
+	return true;
+}
+
+/* Check if row is in warm-up */
+bool Input::isInWarmup(void) const
+{
+	return isTimeWindow && (slots[SLOT_TIMESTAMP] < timeWindowStart);
 }
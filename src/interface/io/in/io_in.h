@@ -7,41 +7,116 @@
 #ifndef _HEADER_IO_IN_
 #define _HEADER_IO_IN_
 
-#include <unordered_map>
+#include <vector>
 #include <string>
 #include <array>
+#include <thread>
+#include <exception>
 #include <interface/io/files/io_files.h>
+#include <interface/io/bin/io_bin.h>
+#include <interface/io/ring/io_ring.h>
+#include <interface/io/parse/io_parse.h>
+#include <interface/io/seek/io_seek.h>
 
 /* Types of files to handle (open, read/write, close): input file, output file, google earth */
 enum FileTypes_e {
 	FILE_INPUT,
 	FILE_INPUT_CSVIDS,
+	FILE_INPUT_BINLOG,
+	FILE_INPUT_GNSS,
+	FILE_INPUT_AUX,
 	FILE_OUTPUT,
 	FILE_OUTPUT_KML_GPS,
 	FILE_OUTPUT_KML_INS,
 	FILE_OUTPUT_KML_FUSION,
+	FILE_OUTPUT_CONVERSION,
 	FILE_TOTAL
 };
 
-/*!
- @brief Class to handle the Input CSV fields
- */
-class InputCsvFields{
-public:
-	/*! Default constructor */
-	InputCsvFields()
-	{
-		fieldvalue = 0;
-	};
-	/*! Constructor used when inserting the CSV into the input map in Input::readLine */
-	InputCsvFields(std::string fieldname_, double fieldvalue_) : fieldname(fieldname_), fieldvalue(fieldvalue_) {};
+/* Slots of the projected input row. Only the CSV columns referenced by the input IDs are decoded, each one into its slot. */
+enum InputSlots_e {
+	SLOT_ACC_X,
+	SLOT_ACC_Y,
+	SLOT_ACC_Z,
+	SLOT_GYR_X,
+	SLOT_GYR_Y,
+	SLOT_GYR_Z,
+	SLOT_MAG_X,
+	SLOT_MAG_Y,
+	SLOT_MAG_Z,
+	SLOT_ROLL,
+	SLOT_PITCH,
+	SLOT_YAW,
+	SLOT_LAT,
+	SLOT_LON,
+	SLOT_HEIGHT,
+	SLOT_HDOP,
+	SLOT_TIMESTAMP,
+	SLOT_TOTAL
+};
 
-	/*! Variable to hold field name in input CSV */
-	std::string fieldname;
+/* Dense storage of the decoded values of one input row, indexed by InputSlots_e */
+typedef std::array<double, SLOT_TOTAL> InputSlots_t;
 
-	/*! Variable to hold field value in input CSV */
-	double fieldvalue;
-};
+/* Maximum number of rows of the reader ring */
+constexpr int READER_RING_MAX_CAPACITY = 1 << 20;
+
+/* Row handed by the reader thread to the processing thread: decoded values, GNSS arrival and input bytes consumed once it was read */
+typedef struct InputEpoch_s {
+	InputSlots_t slots;
+	bool isGnssNew;
+	long long readBytes;
+} InputEpoch_t;
+
+/* Rows of the blocks read ahead by readline(): maximum */
+constexpr size_t INPUT_BLOCK_MAX_ROWS = 1024;
+
+/* Consecutive input rows read ahead by readline(), in columnar layout (one array per slot), so that the epochs are preprocessed a block at a time */
+typedef struct InputBlock_s {
+	double columns[SLOT_TOTAL][INPUT_BLOCK_MAX_ROWS];
+	bool isGnssNew[INPUT_BLOCK_MAX_ROWS];
+	long long readBytes[INPUT_BLOCK_MAX_ROWS]; // Input bytes consumed once the row was read
+	size_t numRows;
+	uint64_t sequence; // Incremented on every block read
+	std::exception_ptr error; // Error raised on the row after the last one of the block
+} InputBlock_t;
+
+/* Parallel ingest: maximum number of threads, and marker of an empty line in the decoded rows */
+constexpr int INGEST_MAX_THREADS = 256;
+constexpr uint8_t INGEST_ROW_EMPTY = 0xFF;
+
+/* Rows of a byte range of the input CSV decoded by the parallel ingest. Range boundaries are aligned to line breaks. */
+typedef struct InputChunk_s {
+	const char* begin;
+	const char* end;
+	long long firstLine; // Line number in the input CSV of the 1st row of the chunk
+	size_t numLines;
+	std::vector<std::vector<double>> columns; // One array per projection plan entry
+	std::vector<uint8_t> decoded; // Number of plan entries found on each row, INGEST_ROW_EMPTY for empty lines
+	std::exception_ptr error; // Error raised on the row after the last decoded one
+} InputChunk_t;
+
+/* Entry of the projection plan: CSV column to decode and index where its value is stored (InputSlots_e when decoding into the slots) */
+typedef struct InputProjection_s {
+	int column;
+	int slot;
+} InputProjection_t;
+
+/*
+ Additional input file merged by timestamp into the epochs of the main input file (IMU), e.g. GNSS at its own rate.
+ One row is read ahead: its values are applied to the epochs once the IMU timestamp reaches the row timestamp.
+*/
+typedef struct InputSource_s {
+	int fileIndex; // FileTypes_e
+	bool isGnss; // Rows of this file signal GNSS arrivals
+	std::vector<std::string> fieldnames;
+	std::vector<InputProjection_t> plan; // Includes the timestamp column, decoded into SLOT_TIMESTAMP of the row read ahead
+	InputSlots_t next; // Row read ahead
+	bool hasNext;
+	long long line; // Line number of the row read ahead
+} InputSource_t;
+
+class InputIds;
 
 /*!
  @brief Read/Write Files Interface class
@@ -50,7 +125,7 @@ class Input {
 public:
 	Input(const Input&) = delete;
 	Input operator=(const Input&) = delete;
-	~Input() {};
+	~Input() { stopReader(); };
 	/*! Singleton class, function returns static object from private constructor */
 	static Input& getInstance(void);
 
@@ -60,12 +135,77 @@ public:
 	void closeFiles(void);
 	/*! Remove white space on string, needed for UI */
 	static const string removeStartingWhiteSpace(const string filename);
+	/*! Remove the extension of an input filename, and the compression one if any, to name the files written next to it */
+	static const string removeExtension(const string& filename);
 	/*! Read input line */
 	bool readline(bool jumpLine = false, int epochCounter = 0);
 	/*! Function to read the IDs of the input CSV file */
 	void readInputCsvIds(void);	
-	/*! Get the fieldvalues */
-	const double getFieldvalue(int id);
+	/*!
+	@brief Convert the input CSV file into the binary columnar log, written next to the input file.
+	@param sInputIds: CSV column indexes entered in the command line. GPS and HDOP columns are stored in the sparse channel.
+	@param fsImu, fsGps: sampling rates to store in the header.
+	*/
+	void writeBinaryLog(const InputIds& sInputIds, double fsImu, double fsGps);
+	/*! 
+	@brief Build the projection plan from the input IDs, i.e. which CSV columns are decoded and into which slot. Must be called after reading the 1st row (field names).
+	@param sInputIds: CSV column indexes entered in the command line.
+	*/
+	void buildProjectionPlan(const InputIds& sInputIds);
+	/*!
+	@brief Process only a time window of the input: seek the input CSV to the 1st row of the window using the sparse seek index (*_SEEK.txt),
+	built and saved next to the input file if missing or out of date, and finish the input after the window. Must be called after buildProjectionPlan().
+	Binary logs and live inputs are not seeked, their rows out of the window are only skipped.
+	@param sInputIds: CSV column indexes entered in the command line, the timestamp column is used.
+	@param timeStart, timeEnd: window in seconds of the timestamp column, -1 for the start or the end of the input.
+	@param warmup: seconds processed before the window for the filter to converge, see isInWarmup().
+	*/
+	void seekTimeWindow(const InputIds& sInputIds, double timeStart, double timeEnd, double warmup);
+	/*! Check if the last row read belongs to the warm-up period before the time window, i.e. processed but not written */
+	bool isInWarmup(void) const;
+	/*! Get the decoded values of the last row read, indexed by InputSlots_e */
+	const InputSlots_t& getSlots(void) const;
+	/*! Check if GNSS arrivals are signalled by the input, i.e. GNSS is read from its own file, instead of being inferred from changes of the values */
+	bool hasGnssArrivals(void) const;
+	/*! Check if a GNSS row arrived with the last row read, only meaningful if hasGnssArrivals() */
+	bool getIsGnssNew(void) const;
+	/*!
+	@brief Start reading and parsing the input file in a background thread. The rows are handed to readline() through a ring.
+	Must be called after buildProjectionPlan(). readline() then only pops rows from the ring.
+	@param capacity: number of rows in the ring.
+	@param policy: wait behavior while the ring is full (reader) or empty (processing).
+	*/
+	void startReader(size_t capacity, RingWaitPolicy_e policy);
+	/*! Stop the reader thread, if running, and display the ring stall counters */
+	void stopReader(void);
+	/*!
+	@brief Decode the rest of the input CSV at once, splitting it in byte ranges parsed in parallel into columnar arrays.
+	readline() then replays the rows from memory, in file order. Must be called after buildProjectionPlan().
+	@param numThreads: number of threads, 1 to INGEST_MAX_THREADS as validated by the UI (-j). Values above the number of cores use all the cores.
+	*/
+	void ingestParallel(int numThreads);
+	/*!
+	@brief Read the input by blocks of rows: readline() reads the next rows ahead into a block and then returns them one by one.
+	Live inputs are read one row at a time, not to hold epochs back. Must be called after ingestParallel()/startReader(), if used.
+	@param rows: rows of each block, limited to INPUT_BLOCK_MAX_ROWS.
+	*/
+	void startBlocks(size_t rows);
+	/*! Get the block holding the last row read, only meaningful after startBlocks() */
+	const InputBlock_t& getBlock(void) const;
+	/*! Get the row of the block returned by the last readline() */
+	size_t getBlockRow(void) const;
+	/*! Get the input bytes consumed up to the last row returned by readline() */
+	long long getReadBytes(void);
+	/*! Benchmark the field parser against strtod on all the fields of the input CSV, checking that both give the same values */
+	void benchmarkFieldParser(void);
+	/*!
+	@brief Conversion mode: convert the GPS coordinates of every row of the input CSV with the batch conversions of frames_batch.h and write them
+	to the conversion output file. The batch conversions are checked by the geodetic benchmark (--geo), see Frames::benchmarkBatch().
+	Output columns: LLH [deg, deg, m], ECEF [m] and ENU [m] with origin at the 1st point. Rows without valid coordinates are skipped.
+	@param sInputIds: CSV column indexes entered in the command line, GPS and HEIGHT are used.
+	@param heightVal: height of every point if there is no HEIGHT column.
+	*/
+	void convertCoordinates(const InputIds& sInputIds, double heightVal);
 
 	// Handle the files
 	std::array<FileHandler, FILE_TOTAL> cFilesHandler;
@@ -75,11 +215,123 @@ private:
 	{
 		totalfields = 0;
 		isFieldnameSet = false;
-		cFilesHandler.at(FILE_INPUT).setOpenOption(FSTREAM_IN);
+		inputLine = 0;
+		isInputBinary = false;
+		binaryRow = 0;
+		binarySparseEntry = 0;
+		isReaderRunning = false;
+		readerReadBytes = 0;
+		isIngested = false;
+		ingestChunkIndex = 0;
+		ingestRowIndex = 0;
+		ingestRowsTotal = 0;
+		ingestRowsRead = 0;
+		ingestStartOffset = 0;
+		slots.fill(0);
+		isGnssNew = false;
+		blockRows = 0;
+		blockNextRow = 0;
+		isBlockEnd = false;
+		block.numRows = 0;
+		block.sequence = 0;
+		isTimeWindow = false;
+		timeWindowFirst = timeWindowStart = timeWindowEnd = 0;
+		cFilesHandler.at(FILE_INPUT).setOpenOption(FSTREAM_IN_MAPPED);
+		cFilesHandler.at(FILE_INPUT_GNSS).setOpenOption(FSTREAM_IN_MAPPED);
+		cFilesHandler.at(FILE_INPUT_AUX).setOpenOption(FSTREAM_IN_MAPPED);
+		cFilesHandler.at(FILE_INPUT_BINLOG).setOpenOption(FSTREAM_OUT_BINARY);
 	};
+	/*! Build the seek index of the mapped input CSV and save it to indexFilename. Returns false if the timestamps are missing or decreasing. */
+	bool buildSeekIndex(const InputIds& sInputIds, const string& indexFilename);
+	/*! Read the next row within the time window, if entered */
+	bool readWindowRow(bool jumpLine, int epochCounter);
+	/*! Read the next rows ahead into the block, until it is full, the input ends or a read error, which is kept to be raised after the rows read */
+	void readBlock(int epochCounter);
+	/*! Get the input bytes consumed by the file, the reader ring or the parallel ingest, i.e. up to the last row read ahead */
+	long long getSourceReadBytes(void);
+	/*! Read the next row from the input file, the reader ring or the rows decoded by the parallel ingest */
+	bool readNextRow(bool jumpLine, int epochCounter);
+	/*! Read the next row of the input file (CSV or binary log) into rowSlots, merging the rows of the additional input files up to its timestamp */
+	bool readRow(InputSlots_t& rowSlots, bool& rowGnssNew, bool jumpLine, int epochCounter);
+	/*! Read the field names of an additional input file and its 1st row */
+	void readSourceHeader(InputSource_t& source);
+	/*! Read the next row of the main input CSV */
+	bool readCsvRow(InputSlots_t& rowSlots, bool jumpLine, int epochCounter);
+	/*! Split the 1st line of a CSV into the field names */
+	static void readFieldnames(const StrView_t& line, std::vector<std::string>& names);
+	/*! Get the additional input file of the given FileTypes_e, nullptr if not entered */
+	const InputSource_t* findSource(int fileIndex) const;
+	/*! Read ahead the next row of an additional input file */
+	void readSourceRow(InputSource_t& source);
+	/*! Apply the rows of the additional input files with timestamp up to the one of the main input row, in timestamp order */
+	void mergeSources(InputSlots_t& rowSlots, bool& rowGnssNew);
+	/*! Reader thread loop: read rows and push them into the ring until end of file, error or stop */
+	void runReader(void);
+	/*! Pop the next row from the ring, rethrowing any error of the reader thread once the ring is drained */
+	bool popRow(bool jumpLine);
+	/*! Run a task of the parallel ingest on every chunk, one thread per chunk */
+	void runIngestTask(void (Input::*task)(InputChunk_t&));
+	/*! Count the lines of a chunk of the mapped input CSV (parallel ingest) */
+	void countChunkLines(InputChunk_t& chunk);
+	/*! Decode the rows of a chunk of the mapped input CSV (parallel ingest) */
+	void ingestChunk(InputChunk_t& chunk);
+	/*! Replay the next row decoded by the parallel ingest */
+	bool replayRow(bool jumpLine, int epochCounter);
+	/*!
+	@brief Decode the fields of a CSV line following a projection plan sorted by column.
+	@param lineNumber: line number in the input CSV, only used to report malformed fields.
+	@return Number of plan entries found on the line.
+	*/
+	size_t parseFields(const StrView_t& line, const std::vector<InputProjection_t>& plan, double* values, long long lineNumber, int fileIndex = FILE_INPUT);
+	/*! Display the file, line and column of a malformed field and throw the read error */
+	void reportFieldError(long long lineNumber, int column, const char* fieldStart, size_t fieldLength, int fileIndex);
+	/*! Read the next row of a binary log input */
+	bool readBinaryRow(InputSlots_t& rowSlots, bool jumpLine);
+	/*! Attach the binary log reader if the mapped input file is a binary log */
+	void checkInputBinary(void);
+
 	int totalfields;
 	bool isFieldnameSet;
-	std::unordered_map<int, InputCsvFields> mapData;
+	// Line number of the last line read from the input CSV, 1 being the field names.
+	long long inputLine;
+	// Field names read from the 1st row, in column order.
+	std::vector<std::string> fieldnames;
+	// Columns to decode sorted by column, and the values decoded on the last row.
+	std::vector<InputProjection_t> projectionPlan;
+	InputSlots_t slots;
+	bool isGnssNew;
+	// Additional input files (GNSS, magnetometer/attitude) merged by timestamp into the main input epochs.
+	std::vector<InputSource_t> sources;
+	// Time window: timestamps of the 1st row processed (warm-up included), of the 1st row written and of the last row, and sparse seek index.
+	bool isTimeWindow;
+	double timeWindowFirst;
+	double timeWindowStart;
+	double timeWindowEnd;
+	SeekIndex cSeekIndex;
+	// Blocks: rows read ahead, rows of each block (0 before startBlocks()), next row to return and end of input reached.
+	InputBlock_t block;
+	size_t blockRows;
+	size_t blockNextRow;
+	bool isBlockEnd;
+	// Binary log input: reader over the mapped file, next dense row and current sparse entry.
+	BinaryLogReader cBinaryLog;
+	bool isInputBinary;
+	uint64_t binaryRow;
+	uint64_t binarySparseEntry;
+	// Reader thread: ring of rows, error raised by the thread, and bytes consumed by the processing thread.
+	SpscRing<InputEpoch_t> ringRows;
+	std::thread readerThread;
+	std::exception_ptr readerException;
+	bool isReaderRunning;
+	long long readerReadBytes;
+	// Parallel ingest: decoded chunks, position of the next row to replay, and rows/bytes used for progress.
+	std::vector<InputChunk_t> ingestChunks;
+	bool isIngested;
+	size_t ingestChunkIndex;
+	size_t ingestRowIndex;
+	uint64_t ingestRowsTotal;
+	uint64_t ingestRowsRead;
+	long long ingestStartOffset;
 };
 
 
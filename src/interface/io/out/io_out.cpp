@@ -150,3 +150,13 @@ void Output_c::writeContent()
 	// Write streams
 	cInput.cFilesHandler.at(FILE_OUTPUT_KML_FUSION).writeContent(valuesStream.str().c_str());
 }
+
+void Output_c::flush()
+{
+	Input& cInput = Input::getInstance();
+
+	for (int fileIndex : { FILE_OUTPUT, FILE_OUTPUT_KML_GPS, FILE_OUTPUT_KML_INS, FILE_OUTPUT_KML_FUSION })
+	{
+		cInput.cFilesHandler.at(fileIndex).flush();
+	}
+}
@@ -68,6 +68,8 @@ public:
 	void writeContent(void);
 	/*! Write footer for KMLs. Cannot be handled together with analysis CSV like header and content.*/
 	void kmlWriteFooter(void);
+	/*! Flush analysis CSV and KMLs, so that the content written is available right away (live input) */
+	void flush(void);
 
 private:
 	Output_c()
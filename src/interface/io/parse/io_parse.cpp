@@ -0,0 +1,232 @@
+/*!
+ @file io_parse.cpp
+ @author Nicolas Padron
+ @brief In this file the processes of io_parse.h are implemented: conversion of the numeric fields of the input CSV.
+*/
+
+#include <string.h>
+#include <stdlib.h>
+#include <locale.h>
+#include <cmath>
+#include <limits>
+#include <string>
+#include <interface/io/parse/io_parse.h>
+
+using namespace std;
+
+/* Powers of ten exactly representable as double */
+static const double exactPowersOfTen[FIELD_PARSE_MAX_EXACT_POW10 + 1] = {
+	1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+	1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+/* Largest integer mantissa exactly representable as double */
+static const uint64_t MAX_EXACT_MANTISSA = (uint64_t)1 << 53;
+
+/* Exponent magnitude beyond which any mantissa underflows or overflows, used to stop accumulating exponent digits */
+static const int MAX_EXPONENT_MAGNITUDE = 100000;
+
+static inline bool isDigit(char c)
+{
+	return (unsigned char)(c - '0') < 10;
+}
+
+static inline bool isBlank(char c)
+{
+	return (c == ' ') || (c == '\t');
+}
+
+/* Parse field */
+FieldParseStatus_e FieldParser::parse(const char* begin, const char* end, double& value)
+{
+	// Blanks around the number
+	while ((begin < end) && isBlank(*begin))
+	{
+		begin++;
+	}
+	while ((end > begin) && isBlank(*(end - 1)))
+	{
+		end--;
+	}
+	if (begin == end)
+	{
+		value = std::numeric_limits<double>::quiet_NaN();
+		return FIELD_PARSE_EMPTY;
+	}
+
+	const char* ptr = begin;
+	bool isNegative = false;
+	if ((*ptr == '-') || (*ptr == '+'))
+	{
+		isNegative = (*ptr == '-');
+		ptr++;
+	}
+
+	// Significant digits go to the mantissa, leading zeros are skipped and the position of the point moves the exponent
+	uint64_t mantissa = 0;
+	int numDigits = 0;
+	int exponent = 0;
+	bool isAnyDigit = false;
+	bool isTruncated = false;
+	while ((ptr < end) && isDigit(*ptr))
+	{
+		isAnyDigit = true;
+		if ((mantissa != 0) || (*ptr != '0'))
+		{
+			if (numDigits < FIELD_PARSE_MAX_DIGITS)
+			{
+				mantissa = mantissa * 10 + (uint64_t)(*ptr - '0');
+				numDigits++;
+			}
+			else
+			{
+				isTruncated = true;
+			}
+		}
+		ptr++;
+	}
+	if ((ptr < end) && (*ptr == '.'))
+	{
+		ptr++;
+		while ((ptr < end) && isDigit(*ptr))
+		{
+			isAnyDigit = true;
+			if ((mantissa == 0) && (*ptr == '0'))
+			{
+				exponent--;
+			}
+			else if (numDigits < FIELD_PARSE_MAX_DIGITS)
+			{
+				mantissa = mantissa * 10 + (uint64_t)(*ptr - '0');
+				numDigits++;
+				exponent--;
+			}
+			else
+			{
+				isTruncated = true;
+			}
+			ptr++;
+		}
+	}
+
+	// NaN and infinity, sign kept as strtod does
+	if (!isAnyDigit)
+	{
+		if (matchWord(ptr, end, "nan"))
+		{
+			value = isNegative ? -std::numeric_limits<double>::quiet_NaN() : std::numeric_limits<double>::quiet_NaN();
+			return FIELD_PARSE_OK;
+		}
+		if (matchWord(ptr, end, "inf") || matchWord(ptr, end, "infinity"))
+		{
+			value = isNegative ? -std::numeric_limits<double>::infinity() : std::numeric_limits<double>::infinity();
+			return FIELD_PARSE_OK;
+		}
+		return FIELD_PARSE_MALFORMED;
+	}
+
+	// Exponent of the scientific notation
+	if ((ptr < end) && ((*ptr == 'e') || (*ptr == 'E')))
+	{
+		ptr++;
+		bool isExponentNegative = false;
+		if ((ptr < end) && ((*ptr == '-') || (*ptr == '+')))
+		{
+			isExponentNegative = (*ptr == '-');
+			ptr++;
+		}
+		if (!((ptr < end) && isDigit(*ptr)))
+		{
+			return FIELD_PARSE_MALFORMED;
+		}
+		int exponentField = 0;
+		while ((ptr < end) && isDigit(*ptr))
+		{
+			if (exponentField < MAX_EXPONENT_MAGNITUDE)
+			{
+				exponentField = exponentField * 10 + (*ptr - '0');
+			}
+			ptr++;
+		}
+		exponent += isExponentNegative ? -exponentField : exponentField;
+	}
+
+	// Anything left is not part of a number
+	if (ptr != end)
+	{
+		return FIELD_PARSE_MALFORMED;
+	}
+
+	// Mantissa and power of ten are both exact, so the product (quotient) is rounded only once: same result as strtod
+	if (!isTruncated && (mantissa <= MAX_EXACT_MANTISSA) && (exponent >= -FIELD_PARSE_MAX_EXACT_POW10) && (exponent <= FIELD_PARSE_MAX_EXACT_POW10))
+	{
+		double result = (double)mantissa;
+		result = (exponent < 0) ? (result / exactPowersOfTen[-exponent]) : (result * exactPowersOfTen[exponent]);
+		value = isNegative ? -result : result;
+		return FIELD_PARSE_OK;
+	}
+	if (mantissa == 0)
+	{
+		value = isNegative ? -0.0 : 0.0;
+		return FIELD_PARSE_OK;
+	}
+
+	return parseFallback(begin, end, value);
+}
+
+/* Parse with strtod */
+FieldParseStatus_e FieldParser::parseFallback(const char* begin, const char* end, double& value)
+{
+	const size_t length = (size_t)(end - begin);
+	char buffer[FIELD_PARSE_BUFFER_LENGTH];
+	string longField;
+	char* field = buffer;
+	if (length >= FIELD_PARSE_BUFFER_LENGTH)
+	{
+		longField.assign(begin, length);
+		field = &longField[0];
+	}
+	else
+	{
+		memcpy(buffer, begin, length);
+		buffer[length] = '\0';
+	}
+
+	// strtod follows the decimal point of the current locale
+	const char localePoint = *localeconv()->decimal_point;
+	if (localePoint != '.')
+	{
+		char* point = (char*)memchr(field, '.', length);
+		if (point != nullptr)
+		{
+			*point = localePoint;
+		}
+	}
+
+	char* eptr = nullptr;
+	const double result = strtod(field, &eptr);
+	if (eptr != field + length)
+	{
+		return FIELD_PARSE_MALFORMED;
+	}
+	value = result;
+	return FIELD_PARSE_OK;
+}
+
+/* Match word in any case */
+bool FieldParser::matchWord(const char* begin, const char* end, const char* word)
+{
+	const size_t length = strlen(word);
+	if ((size_t)(end - begin) != length)
+	{
+		return false;
+	}
+	for (size_t index = 0; index < length; index++)
+	{
+		if ((begin[index] | 0x20) != word[index]) // ASCII letters to lower case
+		{
+			return false;
+		}
+	}
+	return true;
+}
@@ -0,0 +1,50 @@
+/*!
+ @file io_parse.h
+ @author Nicolas Padron
+ @brief Locale independent parser of the numeric fields of the input CSV.
+ Accepts fixed and scientific notation ("-12.5", "1.25e-3"), NaN and infinity in any case, and empty fields (NaN).
+ Fields with up to 19 significant digits and a decimal exponent within +/-22 are converted exactly with integer arithmetic and a single
+ floating point operation, the rest go through strtod. Results are bit-exact with strtod in the "C" locale.
+ */
+
+#ifndef _HEADER_IO_PARSE_
+#define _HEADER_IO_PARSE_
+
+#include <stdint.h>
+#include <stddef.h>
+
+/* Maximum number of significant digits accumulated in the integer mantissa (10^19 - 1 fits in 64 bits) */
+constexpr int FIELD_PARSE_MAX_DIGITS = 19;
+/* Largest power of ten exactly representable as double */
+constexpr int FIELD_PARSE_MAX_EXACT_POW10 = 22;
+/* Length of the buffer used to hand a field to strtod, longer fields use a temporary string */
+constexpr size_t FIELD_PARSE_BUFFER_LENGTH = 64;
+
+/* Result of parsing a field */
+enum FieldParseStatus_e {
+	FIELD_PARSE_OK,
+	FIELD_PARSE_EMPTY,		// Nothing but blanks: value is NaN
+	FIELD_PARSE_MALFORMED	// Not a number, value is not modified
+};
+
+/*!
+ @brief Parser of numeric fields. Does not throw, errors are returned as status so that the caller adds its own context.
+ \class FieldParser
+*/
+class FieldParser {
+public:
+	/*!
+	@brief Parse the field in [begin, end). Blanks (spaces, tabs) around the number are ignored.
+	@param value: parsed value.
+	@return FIELD_PARSE_OK, FIELD_PARSE_EMPTY or FIELD_PARSE_MALFORMED.
+	*/
+	static FieldParseStatus_e parse(const char* begin, const char* end, double& value);
+
+private:
+	/*! Parse with strtod a field already validated, replacing the decimal point by the one of the current locale */
+	static FieldParseStatus_e parseFallback(const char* begin, const char* end, double& value);
+	/*! Check if [begin, end) matches the lower case word, in any case */
+	static bool matchWord(const char* begin, const char* end, const char* word);
+};
+
+#endif // _HEADER_IO_PARSE_
@@ -0,0 +1,79 @@
+/*!
+ @file io_ring.h
+ @author Nicolas Padron
+ @brief Bounded lock-free single-producer/single-consumer ring buffer, used to hand data between the reader thread and the processing thread.
+ */
+
+#ifndef _HEADER_IO_RING_
+#define _HEADER_IO_RING_
+
+#include <stdint.h>
+#include <atomic>
+#include <vector>
+
+/* Size of a cache line, indexes of producer and consumer are kept on separate lines */
+constexpr size_t RING_CACHE_LINE = 64;
+
+/* Behavior of a side while the ring is full (producer) or empty (consumer) */
+enum RingWaitPolicy_e {
+	RING_WAIT_SPIN,		// Busy wait, lowest latency, keeps the core busy
+	RING_WAIT_YIELD,	// Yield the core to other threads between checks
+	RING_WAIT_SLEEP,	// Sleep between checks, lowest CPU usage
+	RING_WAIT_TOTAL
+};
+
+/*!
+ @brief Single-producer/single-consumer ring. Push only from one thread and pop only from another one.
+ Counts the stalls of each side, i.e. the number of push (pop) calls that had to wait because the ring was full (empty).
+ \class SpscRing
+*/
+template <class T>
+class SpscRing {
+public:
+	/*! Default constructor */
+	SpscRing();
+
+	/*!
+	@brief Allocate the ring. Not thread safe, call before starting the producer.
+	@param capacity: number of elements, rounded up to the next power of 2.
+	@param policy: wait behavior of both sides, see RingWaitPolicy_e.
+	*/
+	void initialize(size_t capacity, RingWaitPolicy_e policy);
+
+	/*! Push without waiting. Returns false if the ring is full. Producer only. */
+	bool tryPush(const T& item);
+	/*! Pop without waiting. Returns false if the ring is empty. Consumer only. */
+	bool tryPop(T& item);
+
+	/*! Push, waiting while the ring is full. Returns false if the ring was closed. Producer only. */
+	bool push(const T& item);
+	/*! Pop, waiting while the ring is empty. Returns false once the ring is closed and empty. Consumer only. */
+	bool pop(T& item);
+
+	/*! Close the ring: waiting sides are released, pending elements can still be popped. Any side. */
+	void close(void);
+
+	/*! Get capacity */
+	size_t getCapacity(void) const;
+	/*! Get number of push calls that waited for space */
+	uint64_t getProducerStalls(void) const;
+	/*! Get number of pop calls that waited for data */
+	uint64_t getConsumerStalls(void) const;
+
+private:
+	/*! Wait according to the policy */
+	void wait(void) const;
+
+	std::vector<T> buffer;
+	size_t mask;
+	RingWaitPolicy_e policy;
+	alignas(RING_CACHE_LINE) std::atomic<size_t> head; // Next element to pop, written by consumer
+	alignas(RING_CACHE_LINE) std::atomic<size_t> tail; // Next element to push, written by producer
+	alignas(RING_CACHE_LINE) std::atomic<bool> closed;
+	std::atomic<uint64_t> producerStalls;
+	std::atomic<uint64_t> consumerStalls;
+};
+
+#include <interface/io/ring/io_ring.tpp>
+
+#endif // _HEADER_IO_RING_
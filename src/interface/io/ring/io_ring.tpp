@@ -0,0 +1,155 @@
+/*!
+ @file io_ring.tpp
+ @author Nicolas Padron
+ @brief In this file the processes of io_ring.h are implemented. Included at the end of io_ring.h, so that the ring is instantiated for any element type by its users.
+*/
+
+#include <thread>
+#include <chrono>
+
+/*****************************************
+* Method definition for class: SpscRing  *
+******************************************/
+
+/* Constructor */
+template <class T>
+SpscRing<T>::SpscRing() : mask(0), policy(RING_WAIT_YIELD), head(0), tail(0), closed(false), producerStalls(0), consumerStalls(0)
+{
+}
+
+/* Allocate ring */
+template <class T>
+void SpscRing<T>::initialize(size_t capacity, RingWaitPolicy_e policy_)
+{
+	size_t size = 1;
+	while (size < capacity)
+	{
+		size <<= 1;
+	}
+	buffer.assign(size, T());
+	mask = size - 1;
+	policy = policy_;
+	head.store(0, std::memory_order_relaxed);
+	tail.store(0, std::memory_order_relaxed);
+	closed.store(false, std::memory_order_relaxed);
+	producerStalls.store(0, std::memory_order_relaxed);
+	consumerStalls.store(0, std::memory_order_relaxed);
+}
+
+/* Push without waiting */
+template <class T>
+bool SpscRing<T>::tryPush(const T& item)
+{
+	const size_t tail_ = tail.load(std::memory_order_relaxed);
+	if (tail_ - head.load(std::memory_order_acquire) > mask) // Full
+	{
+		return false;
+	}
+	buffer[tail_ & mask] = item;
+	tail.store(tail_ + 1, std::memory_order_release);
+	return true;
+}
+
+/* Pop without waiting */
+template <class T>
+bool SpscRing<T>::tryPop(T& item)
+{
+	const size_t head_ = head.load(std::memory_order_relaxed);
+	if (head_ == tail.load(std::memory_order_acquire)) // Empty
+	{
+		return false;
+	}
+	item = buffer[head_ & mask];
+	head.store(head_ + 1, std::memory_order_release);
+	return true;
+}
+
+/* Push waiting for space */
+template <class T>
+bool SpscRing<T>::push(const T& item)
+{
+	if (tryPush(item))
+	{
+		return !closed.load(std::memory_order_acquire);
+	}
+	producerStalls.fetch_add(1, std::memory_order_relaxed);
+	while (!closed.load(std::memory_order_acquire))
+	{
+		wait();
+		if (tryPush(item))
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+/* Pop waiting for data */
+template <class T>
+bool SpscRing<T>::pop(T& item)
+{
+	if (tryPop(item))
+	{
+		return true;
+	}
+	consumerStalls.fetch_add(1, std::memory_order_relaxed);
+	while (true)
+	{
+		// Check closed before trying, so that elements pushed right before closing are not lost
+		const bool isClosed = closed.load(std::memory_order_acquire);
+		if (tryPop(item))
+		{
+			return true;
+		}
+		if (isClosed)
+		{
+			return false;
+		}
+		wait();
+	}
+}
+
+/* Close ring */
+template <class T>
+void SpscRing<T>::close(void)
+{
+	closed.store(true, std::memory_order_release);
+}
+
+/* Wait according to policy */
+template <class T>
+void SpscRing<T>::wait(void) const
+{
+	switch (policy)
+	{
+	case RING_WAIT_SPIN:
+		break;
+	case RING_WAIT_SLEEP:
+		std::this_thread::sleep_for(std::chrono::microseconds(50));
+		break;
+	default:
+		std::this_thread::yield();
+		break;
+	}
+}
+
+/* Get capacity */
+template <class T>
+size_t SpscRing<T>::getCapacity(void) const
+{
+	return buffer.size();
+}
+
+/* Get producer stalls */
+template <class T>
+uint64_t SpscRing<T>::getProducerStalls(void) const
+{
+	return producerStalls.load(std::memory_order_relaxed);
+}
+
+/* Get consumer stalls */
+template <class T>
+uint64_t SpscRing<T>::getConsumerStalls(void) const
+{
+	return consumerStalls.load(std::memory_order_relaxed);
+}
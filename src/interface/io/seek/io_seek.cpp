@@ -0,0 +1,194 @@
+/*!
+ @file io_seek.cpp
+ @author Nicolas Padron
+ @brief In this file the processes of io_seek.h are implemented.
+*/
+
+#include <string.h>
+#include <stdio.h>
+#include <cmath>
+#include <algorithm>
+#include <interface/io/seek/io_seek.h>
+#include <interface/io/parse/io_parse.h>
+
+using namespace std;
+
+/* End of the content of the row starting at offset, without line ending */
+static const char* rowContentEnd(const char* data, size_t size, size_t offset)
+{
+	const char* lineStart = data + offset;
+	const char* lineEnd = (const char*)memchr(lineStart, '\n', size - offset);
+	if (lineEnd == nullptr)
+	{
+		lineEnd = data + size;
+	}
+	return ((lineEnd > lineStart) && (*(lineEnd - 1) == '\r')) ? (lineEnd - 1) : lineEnd;
+}
+
+/* FNV-1a hash of a row */
+static uint64_t hashRow(const char* rowStart, const char* rowEnd)
+{
+	uint64_t hash = 14695981039346656037ULL;
+	for (const char* ptr = rowStart; ptr < rowEnd; ptr++)
+	{
+		hash ^= (uint64_t)(unsigned char)*ptr;
+		hash *= 1099511628211ULL;
+	}
+	return hash;
+}
+
+/* Build index */
+bool SeekIndex::build(const char* data, size_t size, size_t offset, int timestampColumn_)
+{
+	timestampColumn = timestampColumn_;
+	fileSize = size;
+	firstRowHash = 0;
+	entries.clear();
+
+	// Only the lines of the entries are parsed, the rest are just jumped over
+	uint64_t line = 2; // 1st data row, right after the field names
+	size_t rowsSinceEntry = SEEK_INDEX_STRIDE;
+	while (offset < size)
+	{
+		const char* lineStart = data + offset;
+		const char* lineEnd = (const char*)memchr(lineStart, '\n', size - offset);
+		if (lineEnd == nullptr)
+		{
+			lineEnd = data + size;
+		}
+		const char* contentEnd = ((lineEnd > lineStart) && (*(lineEnd - 1) == '\r')) ? (lineEnd - 1) : lineEnd;
+
+		// Empty lines carry no timestamp, the entry goes to the next row
+		if ((rowsSinceEntry >= SEEK_INDEX_STRIDE) && (contentEnd > lineStart))
+		{
+			double timestamp;
+			if (!readTimestamp(lineStart, contentEnd, timestamp) || (!entries.empty() && (timestamp < entries.back().timestamp)))
+			{
+				entries.clear();
+				return false;
+			}
+			if (entries.empty())
+			{
+				firstRowHash = hashRow(lineStart, contentEnd);
+			}
+			entries.push_back({ timestamp, (uint64_t)offset, line });
+			rowsSinceEntry = 0;
+		}
+		rowsSinceEntry++;
+		line++;
+		offset = (size_t)(lineEnd - data) + 1;
+	}
+	return true;
+}
+
+/* Load index from file */
+bool SeekIndex::load(const string& filename, int timestampColumn_, const char* data, size_t size)
+{
+	entries.clear();
+	FILE* file = fopen(filename.c_str(), "r");
+	if (file == nullptr)
+	{
+		return false;
+	}
+
+	// Header: the index is only valid for the same timestamp column, the same input file size and the same row at the 1st entry
+	int column = -1;
+	unsigned long long savedSize = 0, savedHash = 0;
+	bool isValid = (fscanf(file, "Seek index: column %d, file size %llu, 1st row hash %llx", &column, &savedSize, &savedHash) == 3) &&
+		(column == timestampColumn_) && (savedSize == (unsigned long long)size);
+	if (isValid)
+	{
+		double timestamp;
+		unsigned long long offset, line;
+		while (fscanf(file, "%lf\t%llu\t%llu", &timestamp, &offset, &line) == 3)
+		{
+			entries.push_back({ timestamp, (uint64_t)offset, (uint64_t)line });
+		}
+		isValid = (feof(file) != 0) && !entries.empty();
+	}
+	fclose(file);
+
+	// A log rewritten with the same size is detected by the row of the 1st entry
+	timestampColumn = timestampColumn_;
+	isValid = isValid && isEntryValid(data, size, entries.front());
+	isValid = isValid && (hashRow(data + entries.front().offset, rowContentEnd(data, size, (size_t)entries.front().offset)) == (uint64_t)savedHash);
+	if (!isValid)
+	{
+		entries.clear();
+		return false;
+	}
+	fileSize = size;
+	firstRowHash = (uint64_t)savedHash;
+	return true;
+}
+
+/* Save index to file */
+bool SeekIndex::save(const string& filename) const
+{
+	FILE* file = fopen(filename.c_str(), "w");
+	if (file == nullptr)
+	{
+		return false;
+	}
+	// Timestamps written with enough digits to be read back exactly
+	bool isWritten = fprintf(file, "Seek index: column %d, file size %llu, 1st row hash %llx\n", timestampColumn, (unsigned long long)fileSize, (unsigned long long)firstRowHash) > 0;
+	for (size_t index = 0; (index < entries.size()) && isWritten; index++)
+	{
+		isWritten = fprintf(file, "%.17g\t%llu\t%llu\n", entries[index].timestamp, (unsigned long long)entries[index].offset, (unsigned long long)entries[index].line) > 0;
+	}
+	return (fclose(file) == 0) && isWritten;
+}
+
+/* Look up time */
+const SeekEntry_t* SeekIndex::lookup(double timestamp) const
+{
+	// 1st entry not before the time, then one back: rows with the same timestamp as an entry may start before it
+	auto it = std::lower_bound(entries.begin(), entries.end(), timestamp, [](const SeekEntry_t& entry, double value)
+		{
+			return entry.timestamp < value;
+		});
+	if (it == entries.begin())
+	{
+		return nullptr;
+	}
+	return &(*(it - 1));
+}
+
+/* Get number of entries */
+size_t SeekIndex::size(void) const
+{
+	return entries.size();
+}
+
+/* Check entry against content */
+bool SeekIndex::isEntryValid(const char* data, size_t size, const SeekEntry_t& entry) const
+{
+	if ((data == nullptr) || (entry.offset >= (uint64_t)size) || ((entry.offset > 0) && (data[entry.offset - 1] != '\n')))
+	{
+		return false;
+	}
+	const size_t offset = (size_t)entry.offset;
+	double timestamp;
+	return readTimestamp(data + offset, rowContentEnd(data, size, offset), timestamp) && (timestamp == entry.timestamp);
+}
+
+/* Read timestamp of row */
+bool SeekIndex::readTimestamp(const char* lineStart, const char* lineEnd, double& timestamp) const
+{
+	const char* fieldStart = lineStart;
+	for (int column = 0; column < timestampColumn; column++)
+	{
+		fieldStart = (const char*)memchr(fieldStart, ',', (size_t)(lineEnd - fieldStart));
+		if (fieldStart == nullptr)
+		{
+			return false;
+		}
+		fieldStart++;
+	}
+	const char* fieldEnd = (const char*)memchr(fieldStart, ',', (size_t)(lineEnd - fieldStart));
+	if (fieldEnd == nullptr)
+	{
+		fieldEnd = lineEnd;
+	}
+	return (FieldParser::parse(fieldStart, fieldEnd, timestamp) == FIELD_PARSE_OK) && !std::isnan(timestamp);
+}
@@ -0,0 +1,79 @@
+/*!
+ @file io_seek.h
+ @author Nicolas Padron
+ @brief Sparse seek index of the input CSV: timestamp and byte offset of one row every SEEK_INDEX_STRIDE rows.
+ Built in a single pass over the memory mapped input and saved next to it (*_SEEK.txt), so that a time window of a long log
+ is reached with a binary search instead of reading all the rows before it.
+ */
+
+#ifndef _HEADER_IO_SEEK_
+#define _HEADER_IO_SEEK_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string>
+#include <vector>
+
+/* Rows between two entries of the index: at most this number of rows is read before the time seeked */
+constexpr size_t SEEK_INDEX_STRIDE = 1024;
+/* Suffix of the index file, replacing the extension of the input file as the *_INDEX.txt column index */
+const std::string SEEK_INDEX_SUFFIX = "_SEEK.txt";
+
+/* Entry of the index: timestamp of a row, offset of its 1st byte and its line number in the input file (1 being the field names) */
+typedef struct SeekEntry_s {
+	double timestamp;
+	uint64_t offset;
+	uint64_t line;
+} SeekEntry_t;
+
+/*!
+ @brief Sparse index of timestamps to byte offsets of a CSV file. Timestamps must not decrease along the file.
+ \class SeekIndex
+*/
+class SeekIndex {
+public:
+	/*! Default constructor */
+	SeekIndex()
+	{
+		timestampColumn = -1;
+		fileSize = 0;
+		firstRowHash = 0;
+	};
+
+	/*!
+	@brief Build the index in a single pass over the file content.
+	@param data, size: content of the file.
+	@param offset: offset of the 1st data row, i.e. right after the field names.
+	@param timestampColumn_: CSV column of the timestamp.
+	@return false if a timestamp cannot be read or decreases, the index is then empty.
+	*/
+	bool build(const char* data, size_t size, size_t offset, int timestampColumn_);
+	/*!
+	@brief Load the index from file.
+	@param filename: index file.
+	@param timestampColumn_: CSV column of the timestamp.
+	@param data, size: content of the input file, to check that the index was built from it.
+	@return false if missing, or built for another timestamp column, another size or another content of the input file
+	(hash of the row of the 1st entry, and that row found at its offset with its timestamp).
+	*/
+	bool load(const std::string& filename, int timestampColumn_, const char* data, size_t size);
+	/*! Save the index to file */
+	bool save(const std::string& filename) const;
+	/*! Get the last entry with timestamp lower than the given one (binary search), nullptr if the index is empty or the time is before the 1st entry */
+	const SeekEntry_t* lookup(double timestamp) const;
+	/*! Get the number of entries */
+	size_t size(void) const;
+	/*! Check that an entry points to the start of a row of the content with the timestamp of the entry, e.g. before seeking to it */
+	bool isEntryValid(const char* data, size_t size, const SeekEntry_t& entry) const;
+
+private:
+	/*! Decode the timestamp column of the row starting at lineStart. Returns false if missing or malformed. */
+	bool readTimestamp(const char* lineStart, const char* lineEnd, double& timestamp) const;
+
+	int timestampColumn;
+	size_t fileSize;
+	uint64_t firstRowHash; // FNV-1a of the row of the 1st entry, without line ending
+	std::vector<SeekEntry_t> entries;
+};
+
+#endif // _HEADER_IO_SEEK_
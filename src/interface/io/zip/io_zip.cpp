@@ -0,0 +1,368 @@
+/*!
+ @file io_zip.cpp
+ @author Nicolas Padron
+ @brief In this file the processes of io_zip.h are implemented.
+*/
+
+#include <string.h>
+#include <limits.h>
+#include <algorithm>
+#include <interface/io/zip/io_zip.h>
+
+#ifdef NAVFUSION_ZLIB
+#include <zlib.h>
+#endif
+#ifdef NAVFUSION_ZSTD
+#include <zstd.h>
+#endif
+
+using namespace std;
+
+/* Magic bytes of each format */
+static const unsigned char GZIP_MAGIC[2] = { 0x1F, 0x8B };
+static const unsigned char ZSTD_MAGIC[4] = { 0x28, 0xB5, 0x2F, 0xFD };
+
+/* Largest input handed to zlib at once, its counters are 32 bits */
+static const size_t GZIP_MAX_INPUT = (size_t)1 << 30;
+
+/* Constructor */
+ZipReader::ZipReader()
+{
+	format = ZIP_FORMAT_NONE;
+	src = nullptr;
+	srcSize = 0;
+	srcOffset = 0;
+	srcConsumed = 0;
+	stream = nullptr;
+	isMemberEnd = false;
+	zstdHint = 1;
+	consumed = 0;
+	isThreaded = false;
+	currentBlock = { 0, 0, 0 };
+	blockPosition = 0;
+	hasBlock = false;
+}
+
+/* Detect format */
+ZipFormat_e ZipReader::detect(const char* data, size_t size)
+{
+	if ((data != nullptr) && (size >= sizeof(GZIP_MAGIC)) && (memcmp(data, GZIP_MAGIC, sizeof(GZIP_MAGIC)) == 0))
+	{
+		return ZIP_FORMAT_GZIP;
+	}
+	if ((data != nullptr) && (size >= sizeof(ZSTD_MAGIC)) && (memcmp(data, ZSTD_MAGIC, sizeof(ZSTD_MAGIC)) == 0))
+	{
+		return ZIP_FORMAT_ZSTD;
+	}
+	return ZIP_FORMAT_NONE;
+}
+
+/* Check if format is supported */
+bool ZipReader::isSupported(ZipFormat_e format_)
+{
+	switch (format_)
+	{
+#ifdef NAVFUSION_ZLIB
+	case ZIP_FORMAT_GZIP:
+		return true;
+#endif
+#ifdef NAVFUSION_ZSTD
+	case ZIP_FORMAT_ZSTD:
+		return true;
+#endif
+	default:
+		return false;
+	}
+}
+
+/* Get format name */
+const char* ZipReader::getFormatName(ZipFormat_e format_)
+{
+	switch (format_)
+	{
+	case ZIP_FORMAT_GZIP:
+		return "gzip";
+	case ZIP_FORMAT_ZSTD:
+		return "zstd";
+	default:
+		return "none";
+	}
+}
+
+/* Open compressed buffer */
+bool ZipReader::open(const char* data, size_t size, bool isThreaded_)
+{
+	close();
+	const ZipFormat_e format_ = detect(data, size);
+	if (!isSupported(format_))
+	{
+		return false;
+	}
+
+	// Decoder
+	switch (format_)
+	{
+#ifdef NAVFUSION_ZLIB
+	case ZIP_FORMAT_GZIP:
+	{
+		z_stream* zs = new z_stream;
+		memset(zs, 0, sizeof(z_stream));
+		if (inflateInit2(zs, 15 + 16) != Z_OK) // gzip wrapper only
+		{
+			delete zs;
+			return false;
+		}
+		stream = zs;
+		break;
+	}
+#endif
+#ifdef NAVFUSION_ZSTD
+	case ZIP_FORMAT_ZSTD:
+	{
+		ZSTD_DStream* zds = ZSTD_createDStream();
+		if ((zds == nullptr) || ZSTD_isError(ZSTD_initDStream(zds)))
+		{
+			ZSTD_freeDStream(zds);
+			return false;
+		}
+		stream = zds;
+		break;
+	}
+#endif
+	default:
+		return false;
+	}
+	format = format_;
+	src = data;
+	srcSize = size;
+	srcOffset = 0;
+	srcConsumed = 0;
+	isMemberEnd = false;
+	zstdHint = 1;
+	consumed = 0;
+
+	// Decoder thread, all the blocks start free
+	isThreaded = isThreaded_;
+	hasBlock = false;
+	blockPosition = 0;
+	if (isThreaded)
+	{
+		blocks.assign(ZIP_BLOCKS, vector<char>(ZIP_BLOCK_SIZE));
+		filledBlocks.initialize(ZIP_BLOCKS, RING_WAIT_YIELD);
+		freeBlocks.initialize(ZIP_BLOCKS, RING_WAIT_YIELD);
+		for (size_t index = 0; index < ZIP_BLOCKS; index++)
+		{
+			(void)freeBlocks.tryPush(index);
+		}
+		decoderThread = std::thread(&ZipReader::runDecoder, this);
+	}
+	return true;
+}
+
+/* Read decoded data */
+long long ZipReader::read(char* dst, size_t capacity)
+{
+	if (!isOpen() || (capacity == 0))
+	{
+		return isOpen() ? 0 : -1;
+	}
+	if (!isThreaded)
+	{
+		const long long length = decode(dst, capacity);
+		consumed = srcConsumed;
+		return length;
+	}
+
+	// Next block from the decoder thread. The end of input and errors are kept as the current block, so they are returned again.
+	if (!hasBlock)
+	{
+		if (!filledBlocks.pop(currentBlock))
+		{
+			return -1;
+		}
+		hasBlock = true;
+		blockPosition = 0;
+	}
+	if (currentBlock.length <= 0)
+	{
+		return currentBlock.length;
+	}
+	const size_t count = std::min(capacity, (size_t)currentBlock.length - blockPosition);
+	memcpy(dst, blocks[currentBlock.index].data() + blockPosition, count);
+	blockPosition += count;
+	if (blockPosition == (size_t)currentBlock.length)
+	{
+		consumed = currentBlock.consumed;
+		(void)freeBlocks.push(currentBlock.index);
+		hasBlock = false;
+	}
+	return (long long)count;
+}
+
+/* Close */
+void ZipReader::close(void)
+{
+	if (decoderThread.joinable())
+	{
+		filledBlocks.close();
+		freeBlocks.close();
+		decoderThread.join();
+	}
+	blocks.clear();
+	hasBlock = false;
+
+	switch (format)
+	{
+#ifdef NAVFUSION_ZLIB
+	case ZIP_FORMAT_GZIP:
+		inflateEnd((z_stream*)stream);
+		delete (z_stream*)stream;
+		break;
+#endif
+#ifdef NAVFUSION_ZSTD
+	case ZIP_FORMAT_ZSTD:
+		ZSTD_freeDStream((ZSTD_DStream*)stream);
+		break;
+#endif
+	default:
+		break;
+	}
+	stream = nullptr;
+	format = ZIP_FORMAT_NONE;
+	src = nullptr;
+	srcSize = 0;
+}
+
+/* Check if open */
+bool ZipReader::isOpen(void) const
+{
+	return format != ZIP_FORMAT_NONE;
+}
+
+/* Get compressed bytes consumed */
+long long ZipReader::getConsumed(void) const
+{
+	return consumed;
+}
+
+/* Decode */
+long long ZipReader::decode(char* dst, size_t capacity)
+{
+	switch (format)
+	{
+	case ZIP_FORMAT_GZIP:
+		return decodeGzip(dst, capacity);
+	case ZIP_FORMAT_ZSTD:
+		return decodeZstd(dst, capacity);
+	default:
+		return -1;
+	}
+}
+
+/* Decode gzip */
+long long ZipReader::decodeGzip(char* dst, size_t capacity)
+{
+#ifdef NAVFUSION_ZLIB
+	z_stream* zs = (z_stream*)stream;
+	const uInt outSize = (uInt)std::min(capacity, (size_t)UINT_MAX);
+	zs->next_out = (Bytef*)dst;
+	zs->avail_out = outSize;
+	while (zs->avail_out == outSize)
+	{
+		if (zs->avail_in == 0)
+		{
+			if (srcOffset >= srcSize)
+			{
+				// Whole input consumed: end of data after a complete member, truncated otherwise
+				return isMemberEnd ? 0 : -1;
+			}
+			zs->next_in = (Bytef*)(src + srcOffset);
+			zs->avail_in = (uInt)std::min(srcSize - srcOffset, GZIP_MAX_INPUT);
+			srcOffset += zs->avail_in;
+		}
+		const int ret = inflate(zs, Z_NO_FLUSH);
+		srcConsumed = (long long)(srcOffset - zs->avail_in);
+		if (ret == Z_STREAM_END)
+		{
+			// Concatenated members (e.g. logs appended or compressed in parallel) are decoded as one. Anything else after a member is ignored, as gzip does.
+			const size_t next = srcOffset - zs->avail_in;
+			const bool isNextMember = (detect(src + next, srcSize - next) == ZIP_FORMAT_GZIP);
+			if (!isNextMember)
+			{
+				isMemberEnd = true;
+				zs->avail_in = 0;
+				srcOffset = srcSize;
+				srcConsumed = (long long)srcSize;
+				break;
+			}
+			if (inflateReset(zs) != Z_OK)
+			{
+				return -1;
+			}
+		}
+		else if ((ret != Z_OK) && (ret != Z_BUF_ERROR))
+		{
+			return -1;
+		}
+		isMemberEnd = false;
+	}
+	return (long long)(outSize - zs->avail_out);
+#else
+	(void)dst;
+	(void)capacity;
+	return -1;
+#endif
+}
+
+/* Decode zstd */
+long long ZipReader::decodeZstd(char* dst, size_t capacity)
+{
+#ifdef NAVFUSION_ZSTD
+	ZSTD_DStream* zds = (ZSTD_DStream*)stream;
+	ZSTD_inBuffer in = { src, srcSize, srcOffset };
+	ZSTD_outBuffer out = { dst, capacity, 0 };
+	while (out.pos == 0)
+	{
+		// Hint 0: last frame complete, anything else at end of input is a truncated frame
+		if ((in.pos == in.size) && (zstdHint == 0))
+		{
+			break;
+		}
+		const size_t inPos = in.pos;
+		const size_t ret = ZSTD_decompressStream(zds, &out, &in);
+		if (ZSTD_isError(ret))
+		{
+			return -1;
+		}
+		zstdHint = ret;
+		if ((out.pos == 0) && (in.pos == inPos) && (in.pos == in.size) && (zstdHint != 0))
+		{
+			return -1;
+		}
+	}
+	srcOffset = in.pos;
+	srcConsumed = (long long)in.pos;
+	return (long long)out.pos;
+#else
+	(void)dst;
+	(void)capacity;
+	return -1;
+#endif
+}
+
+/* Decoder thread loop */
+void ZipReader::runDecoder(void)
+{
+	size_t index;
+	while (freeBlocks.pop(index))
+	{
+		ZipBlock_t block;
+		block.index = index;
+		block.length = decode(blocks[index].data(), ZIP_BLOCK_SIZE);
+		block.consumed = srcConsumed;
+		if (!filledBlocks.push(block) || (block.length <= 0))
+		{
+			break;
+		}
+	}
+}
@@ -0,0 +1,109 @@
+/*!
+ @file io_zip.h
+ @author Nicolas Padron
+ @brief Decoder of compressed input files (gzip, zstd), detected by their magic bytes.
+ The compressed content is read from memory (the mapping of the input file) and decoded in blocks, so that only a bounded
+ amount of decoded data is held at any time. Decoding can run in its own thread, overlapping with the processing.
+ gzip needs zlib and zstd needs libzstd at build time (NAVFUSION_ZLIB, NAVFUSION_ZSTD), otherwise the format is detected but not supported.
+ */
+
+#ifndef _HEADER_IO_ZIP_
+#define _HEADER_IO_ZIP_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string>
+#include <thread>
+#include <vector>
+#include <interface/io/ring/io_ring.h>
+
+/* Compression formats */
+enum ZipFormat_e {
+	ZIP_FORMAT_NONE,
+	ZIP_FORMAT_GZIP,
+	ZIP_FORMAT_ZSTD
+};
+
+/* Usual extensions of compressed files, only used to name the files written next to the input */
+const std::string ZIP_SUFFIX_GZIP = ".gz";
+const std::string ZIP_SUFFIX_ZSTD = ".zst";
+
+/* Decoder thread: size of each block of decoded data and number of blocks (power of 2) */
+constexpr size_t ZIP_BLOCK_SIZE = 1 << 18;
+constexpr size_t ZIP_BLOCKS = 4;
+
+/* Block handed by the decoder thread: index in the pool, decoded length (0 at end of input, -1 on error) and compressed bytes consumed */
+typedef struct ZipBlock_s {
+	size_t index;
+	long long length;
+	long long consumed;
+} ZipBlock_t;
+
+/*!
+ @brief Reader of a compressed buffer. read() is called from a single thread.
+ \class ZipReader
+*/
+class ZipReader {
+public:
+	/*! Default constructor */
+	ZipReader();
+	ZipReader(const ZipReader&) = delete;
+	ZipReader operator=(const ZipReader&) = delete;
+	~ZipReader() { close(); };
+
+	/*! Detect the compression format from the magic bytes at the start of the buffer */
+	static ZipFormat_e detect(const char* data, size_t size);
+	/*! Check if the format can be decoded by this build */
+	static bool isSupported(ZipFormat_e format);
+	/*! Get the name of the format */
+	static const char* getFormatName(ZipFormat_e format);
+
+	/*!
+	@brief Start decoding a compressed buffer, which must stay valid until close().
+	@param isThreaded: decode in a background thread, a few blocks ahead of read().
+	@return false if the format is not detected, not supported or the decoder cannot be created.
+	*/
+	bool open(const char* data, size_t size, bool isThreaded);
+	/*! Read decoded data. Returns the number of bytes read, 0 at end of the input and -1 if the input is corrupted or truncated. */
+	long long read(char* dst, size_t capacity);
+	/*! Stop the decoder thread, if running, and release the decoder */
+	void close(void);
+	/*! Check if a buffer is being decoded */
+	bool isOpen(void) const;
+	/*! Get the compressed bytes consumed to decode the data read so far */
+	long long getConsumed(void) const;
+
+private:
+	/*! Decode into dst from the current position of the compressed buffer. Same return values as read(). */
+	long long decode(char* dst, size_t capacity);
+	/*! Decode gzip members, one after the other if concatenated */
+	long long decodeGzip(char* dst, size_t capacity);
+	/*! Decode zstd frames */
+	long long decodeZstd(char* dst, size_t capacity);
+	/*! Decoder thread loop: decode into free blocks until end of input, error or close */
+	void runDecoder(void);
+
+	ZipFormat_e format;
+	// Compressed buffer, offset handed to the decoder and bytes consumed by it
+	const char* src;
+	size_t srcSize;
+	size_t srcOffset;
+	long long srcConsumed;
+	// Decoder state (z_stream or ZSTD_DStream), end of the last member/frame reached and hint of zstd of the input left in the frame
+	void* stream;
+	bool isMemberEnd;
+	size_t zstdHint;
+	// Compressed bytes consumed up to the data returned by read()
+	long long consumed;
+	// Decoder thread: pool of blocks, blocks decoded and blocks free, and the block being read
+	bool isThreaded;
+	std::thread decoderThread;
+	std::vector<std::vector<char>> blocks;
+	SpscRing<ZipBlock_t> filledBlocks;
+	SpscRing<size_t> freeBlocks;
+	ZipBlock_t currentBlock;
+	size_t blockPosition;
+	bool hasBlock;
+};
+
+#endif // _HEADER_IO_ZIP_
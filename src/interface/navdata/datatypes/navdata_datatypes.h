@@ -7,20 +7,22 @@
 #ifndef NAVDATA_DATATYPES_HEADER
 #define NAVDATA_DATATYPES_HEADER
 
-/* GPS data structure */
+/* GPS data structure. Coordinates and angles are fixed-size 3x1 vectors, held inside the structure without heap allocation. */
 typedef struct DatatypesGps_s {
-	arma::vec ECEF = arma::vec(3, arma::fill::zeros);
-	arma::vec ENU = arma::vec(3, arma::fill::zeros);
-	arma::vec LLH = arma::vec(3, arma::fill::value(arma::datum::nan));
-	arma::vec ECEF_REF = arma::vec(3, arma::fill::value(arma::datum::nan));
+	arma::vec3 ECEF = arma::vec3(arma::fill::zeros);
+	arma::vec3 ENU = arma::vec3(arma::fill::zeros);
+	arma::vec3 LLH = arma::vec3(arma::fill::value(arma::datum::nan));
+	arma::vec3 ECEF_REF = arma::vec3(arma::fill::value(arma::datum::nan));
 } DatatypesGps_t;
 
 /* INS data structure */
 typedef struct DatatypesIns_s : DatatypesGps_s {
-	arma::vec V = arma::vec(3, arma::fill::zeros);
-	arma::vec V_dot  = arma::vec(3, arma::fill::zeros);
-	arma::vec RPY = arma::vec(3, arma::fill::zeros);
-	arma::vec RPY_dot = arma::vec(3, arma::fill::zeros);
+	arma::vec3 V = arma::vec3(arma::fill::zeros);
+	arma::vec3 V_dot  = arma::vec3(arma::fill::zeros);
+	arma::vec3 RPY = arma::vec3(arma::fill::zeros);
+	arma::vec3 RPY_dot = arma::vec3(arma::fill::zeros);
+	// Body to ENU matrix of the attitude, propagated with the quaternion (-y 2). Starts as the matrix of null angles.
+	arma::mat33 BODY2ENU = arma::mat33({ {0, 1, 0}, {1, 0, 0}, {0, 0, -1} });
 } DatatypesIns_t;
 
 /* Fusion data structure */
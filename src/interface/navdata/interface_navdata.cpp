@@ -25,6 +25,54 @@ NavDataInterface& NavDataInterface::getInstance()
 	return instance;
 }
 
+/* 1st slot (InputSlots_e) of the projected input row holding the values of each key, the rest follow consecutively */
+static const int KEY_SLOTS[KEY_TOTAL] = { SLOT_LAT, SLOT_ACC_X, SLOT_GYR_X, SLOT_MAG_X, SLOT_ROLL, SLOT_HDOP };
+
+/* Keys quantized by the preprocessing */
+static const bool KEY_IS_QUANTIZED[KEY_TOTAL] = { false, true, true, true, true, false };
+
+/* Preprocessing kernels over the arrays of a block: plain loops with no dependency between rows, vectorized by the compiler.
+ The operations are the same, in the same order, as on a single epoch, so the results do not depend on the size of the blocks. */
+static void subtractBlock(double* values, const size_t numRows, const double bias)
+{
+	for (size_t row = 0; row < numRows; row++)
+	{
+		values[row] -= bias;
+	}
+}
+
+static void scaleBlock(double* values, const size_t numRows, const double factor)
+{
+	for (size_t row = 0; row < numRows; row++)
+	{
+		values[row] *= factor;
+	}
+}
+
+/* Quantize values as floor(x * QF) / QF (truncated towards zero). Non finite values, e.g. NaN of missing fields, give 0, the rest of the steps propagate NaN. */
+static void quantizeBlock(double* values, const size_t numRows, const uint32_t quantFactor)
+{
+	for (size_t row = 0; row < numRows; row++)
+	{
+		const double scaled = values[row] * quantFactor;
+		values[row] = (double)(std::isfinite(scaled) ? (int)scaled : 0) / quantFactor;
+	}
+}
+
+/* Rotate XYZ arrays by a 3x3 matrix, summing in the same order as Armadillo does for a 3x3 matrix times a vector */
+static void rotateBlock(double* x, double* y, double* z, const size_t numRows, const double m[3][3])
+{
+	for (size_t row = 0; row < numRows; row++)
+	{
+		const double x0 = x[row];
+		const double x1 = y[row];
+		const double x2 = z[row];
+		x[row] = m[0][0] * x0 + m[0][1] * x1 + m[0][2] * x2;
+		y[row] = m[1][0] * x0 + m[1][1] * x1 + m[1][2] * x2;
+		z[row] = m[2][0] * x0 + m[2][1] * x1 + m[2][2] * x2;
+	}
+}
+
 // Initialize input monitor on defined KEYS
 void NavDataInterface::initialize(void)
 {
@@ -32,123 +80,201 @@ void NavDataInterface::initialize(void)
 	sInputValues = UI::getInstance().getInputValues();
 	epochCounter = 0;
 
-	// Check input GPS
-	mapInputMonitor.insert({ KEY_GPS, MapInputMonitorStruct(arma::Mat<int>({sInputIds.GPS.at(0), sInputIds.GPS.at(1), sInputIds.HEIGHT})) });
+	// CSV columns entered for each key
+	const std::array<std::array<int, INPUT_KEY_ELEMS>, KEY_TOTAL> inputIds{{
+		{ sInputIds.GPS.at(0), sInputIds.GPS.at(1), sInputIds.HEIGHT },
+		{ sInputIds.ACC.at(0), sInputIds.ACC.at(1), sInputIds.ACC.at(2) },
+		{ sInputIds.GYR.at(0), sInputIds.GYR.at(1), sInputIds.GYR.at(2) },
+		{ sInputIds.MAG.at(0), sInputIds.MAG.at(1), sInputIds.MAG.at(2) },
+		{ sInputIds.ROLL, sInputIds.PITCH, sInputIds.YAW },
+		{ sInputIds.HDOP, -1, -1 }
+	}};
+	epochInputs = EpochInputs();
+	for (int key = 0; key < KEY_TOTAL; key++)
+	{
+		for (int i = 0; i < INPUT_KEY_ELEMS; i++)
+		{
+			if (inputIds[key][i] != -1)
+			{
+				epochInputs.setEntered(key, i);
+			}
+		}
+	}
 
-	// Check input ACC
-	mapInputMonitor.insert({ KEY_ACC, MapInputMonitorStruct(arma::Mat<int>({sInputIds.ACC.at(0), sInputIds.ACC.at(1), sInputIds.ACC.at(2)})) });
+	isGpsDataNew = false;
+	isGpsDataValid = false;
+	cPreintegrator.initialize(1.0 / sInputValues.fsImu);
+	isNavEpoch = false;
+	navPeriod = 1.0 / sInputValues.fsImu;
 
-	// Check input GYR
-	mapInputMonitor.insert({ KEY_GYR, MapInputMonitorStruct(arma::Mat<int>({sInputIds.GYR.at(0), sInputIds.GYR.at(1), sInputIds.GYR.at(2)})) });
+	// Constant transforms of the preprocessing. The selectors of accelerometers and gyrometers go after the bias feedback, if enabled, so they are applied on each epoch.
+	const arma::mat matPlat2Body = Frames::matrixPlatform2Body(sInputValues.diagPlat2Body);
+	for (int row = 0; row < 3; row++)
+	{
+		for (int col = 0; col < 3; col++)
+		{
+			plat2Body[row][col] = matPlat2Body(row, col);
+		}
+	}
+	for (int key = 0; key < KEY_TOTAL; key++)
+	{
+		for (int i = 0; i < INPUT_KEY_ELEMS; i++)
+		{
+			restBias[key][i] = 0;
+			scale[key][i] = 1;
+			defaultValue[key][i] = 0;
+		}
+	}
+	for (int i = 0; i < INPUT_KEY_ELEMS; i++)
+	{
+		restBias[KEY_ACC][i] = sInputValues.accRest(i);
+		restBias[KEY_GYR][i] = sInputValues.gyrRest(i);
+		scale[KEY_MAG][i] = sInputValues.bodySelector(i);
+		if (!sInputValues.feedbackBias)
+		{
+			scale[KEY_ACC][i] = sInputValues.bodySelector(i);
+			scale[KEY_GYR][i] = sInputValues.attitudeSelector(i);
+		}
+		/* Input angles covnerted to radians to avoid unecessary conversions in processing functions */
+		if (!sInputValues.inputAnglesInRadians)
+		{
+			scale[KEY_RPY][i] = DEG2RAD;
+		}
+	}
+	scale[KEY_GPS][0] = DEG2RAD;
+	scale[KEY_GPS][1] = DEG2RAD;
+	// Assign default/entered height if not part of CSV
+	defaultValue[KEY_GPS][2] = sInputValues.heightVal;
+	preprocessedSequence = 0;
+}
 
-	// Check input MAG
-	mapInputMonitor.insert({ KEY_MAG, MapInputMonitorStruct(arma::Mat<int>({sInputIds.MAG.at(0), sInputIds.MAG.at(1), sInputIds.MAG.at(2)})) });
+/* Preprocess the rows of a block */
+void NavDataInterface::preprocessBlock(const InputBlock_t& block)
+{
+	const size_t numRows = block.numRows;
+	for (int key = 0; key < KEY_TOTAL; key++)
+	{
+		for (int i = 0; i < INPUT_KEY_ELEMS; i++)
+		{
+			// Values of the entered columns, the rest hold their default
+			double* values = preprocessed[key][i];
+			if (epochInputs.isEntered(key, i))
+			{
+				std::copy(block.columns[KEY_SLOTS[key] + i], block.columns[KEY_SLOTS[key] + i] + numRows, values);
+			}
+			else
+			{
+				std::fill(values, values + numRows, defaultValue[key][i]);
+			}
 
-	// Check input RPY
-	mapInputMonitor.insert({ KEY_RPY, MapInputMonitorStruct(arma::Mat<int>({sInputIds.ROLL, sInputIds.PITCH, sInputIds.YAW})) });
+			// Apply bias correction if entered, otherwise take 1st value.
+			subtractBlock(values, numRows, restBias[key][i]);
+			if (KEY_IS_QUANTIZED[key])
+			{
+				quantizeBlock(values, numRows, sInputValues.quantFactor);
+			}
+		}
+	}
 
-	// Check input HDOP
-	mapInputMonitor.insert({ KEY_HDOP, MapInputMonitorStruct(arma::Mat<int>({sInputIds.HDOP})) });
+	// Platform to body 
+	rotateBlock(preprocessed[KEY_ACC][0], preprocessed[KEY_ACC][1], preprocessed[KEY_ACC][2], numRows, plat2Body);
 
-	isGpsDataNew = false;
-	isGpsDataValid = false;
+	// Selectors and units
+	for (int key = 0; key < KEY_TOTAL; key++)
+	{
+		for (int i = 0; i < INPUT_KEY_ELEMS; i++)
+		{
+			scaleBlock(preprocessed[key][i], numRows, scale[key][i]);
+		}
+	}
 }
 
 /* Update input monitor on defined KEYS */
 void NavDataInterface::update(void)
 {
-	Input& cInput = Input::getInstance();
-	arma::vec rpyIns = NavsystemsHolder::getInstance().getPtrIns().RPY;
-	arma::vec oldGpsData = mapInputMonitor.at(KEY_GPS).inputHolder;
-	arma::vec oldAcc = mapInputMonitor.at(KEY_ACC).inputHolder; 
-	arma::vec oldGyr = mapInputMonitor.at(KEY_GYR).inputHolder;
-	arma::vec gl = arma::vec({0,0,0});
-	std::vector<int> quant;
-	double fieldvalue = 0;
+	const InputBlock_t& block = Input::getInstance().getBlock();
+	const size_t blockRow = Input::getInstance().getBlockRow();
+	const DatatypesIns_t& sIns = NavsystemsHolder::getInstance().getPtrIns();
+	// With the quaternion (-y 2) the INS attitude is its Body to ENU matrix, the angles are only derived for the outputs
+	const bool isQuaternion = sInputValues.progressAngles && sInputValues.progressQuaternion;
+	const arma::vec3 oldGpsData = epochInputs.get(KEY_GPS);
+	arma::vec3 gl = { 0, 0, 0 };
 	
 	// Increase epoch counter
 	epochCounter += 1;
 
-	try
+	// Preprocess the block once, at its 1st row, then take the values of the row
+	if (block.sequence != preprocessedSequence)
 	{
-		// For each Key and for each inputCheck != false, then fill the corresponding input value
-		for (MapInputMonitor_t::iterator it = mapInputMonitor.begin(); it != mapInputMonitor.end(); it++)
+		preprocessBlock(block);
+		preprocessedSequence = block.sequence;
+	}
+	for (int key = 0; key < KEY_TOTAL; key++)
+	{
+		for (int i = 0; i < INPUT_KEY_ELEMS; i++)
 		{
-			for (int i = 0; i < it->second.nElems; i++)
-			{
-				if (it->second.inputId.at(i) != -1)
-				{
-					fieldvalue = cInput.getFieldvalue(it->second.inputId[i]);
-					it->second.inputHolder.at(i) = fieldvalue;
-				}
-			}
+			epochInputs.values[key][i] = preprocessed[key][i][blockRow];
 		}
 	}
-	catch (const MonitorException&)
+	const arma::vec3 gps = epochInputs.get(KEY_GPS);
+	arma::vec3 acc = epochInputs.get(KEY_ACC);
+	arma::vec3 gyr = epochInputs.get(KEY_GYR);
+	
+	if(sInputValues.feedbackBias)
 	{
-		throw;
+		acc += NavsystemsHolder::getInstance().getPtrKf().X(KfStates::AccBias::span());
+		gyr += NavsystemsHolder::getInstance().getPtrKf().X(KfStates::GyrBias::span());
+		acc %= sInputValues.bodySelector;
+		gyr %= sInputValues.attitudeSelector;
 	}
 
-	// Assign default/entered height if not part of CSV
-	if (mapInputMonitor.at(KEY_GPS).inputId.at(2) == -1)
+	// With a GNSS input file the arrivals are known from the merge, a fix repeated with the same values is still a new one
+	if (Input::getInstance().hasGnssArrivals())
 	{
-		mapInputMonitor.at(KEY_GPS).inputHolder.at(2) = sInputValues.heightVal;
+		isGpsDataNew = Input::getInstance().getIsGnssNew();
 	}
-
-	// Apply bias correction if entered, otherwise take 1st value.
-	mapInputMonitor.at(KEY_ACC).inputHolder -= sInputValues.accRest;
-	mapInputMonitor.at(KEY_GYR).inputHolder -= sInputValues.gyrRest;
-
- 	quant = arma::conv_to<std::vector<int>>::from(mapInputMonitor.at(KEY_ACC).inputHolder * sInputValues.quantFactor);
-	mapInputMonitor.at(KEY_ACC).inputHolder = arma::conv_to<arma::vec>::from(quant) / sInputValues.quantFactor;
- 	quant = arma::conv_to<std::vector<int>>::from(mapInputMonitor.at(KEY_GYR).inputHolder * sInputValues.quantFactor);
-	mapInputMonitor.at(KEY_GYR).inputHolder = arma::conv_to<arma::vec>::from(quant) / sInputValues.quantFactor;
- 	quant = arma::conv_to<std::vector<int>>::from(mapInputMonitor.at(KEY_MAG).inputHolder * sInputValues.quantFactor);
-	mapInputMonitor.at(KEY_MAG).inputHolder = arma::conv_to<arma::vec>::from(quant) / sInputValues.quantFactor;
- 	quant = arma::conv_to<std::vector<int>>::from(mapInputMonitor.at(KEY_RPY).inputHolder * sInputValues.quantFactor);
-	mapInputMonitor.at(KEY_RPY).inputHolder = arma::conv_to<arma::vec>::from(quant) / sInputValues.quantFactor;
-	
-	// Platform to body 
-	mapInputMonitor.at(KEY_ACC).inputHolder = Frames::matrixPlatform2Body(sInputValues.diagPlat2Body) * mapInputMonitor.at(KEY_ACC).inputHolder;
-	//mapInputMonitor.at(KEY_GYR).inputHolder = Frames::matrixPlatform2Body(sInputValues.diagPlat2Body) * mapInputMonitor.at(KEY_GYR).inputHolder;
-	
-	if(sInputValues.feedbackBias)
+	else
 	{
-		mapInputMonitor.at(KEY_ACC).inputHolder += NavsystemsHolder::getInstance().getPtrKf().X.subvec(9,11);
-		mapInputMonitor.at(KEY_GYR).inputHolder += NavsystemsHolder::getInstance().getPtrKf().X.subvec(12,14);
+		isGpsDataNew = arma::sum(arma::abs(oldGpsData - gps)) > 0;
 	}
+	isGpsDataValid = !gps.has_nan();
 
-	/* Input angles covnerted to radians to avoid unecessary conversions in processing functions */
-	if (!sInputValues.inputAnglesInRadians)
+	if(sInputValues.doPlatformAlignment)
 	{
-		mapInputMonitor.at(KEY_RPY).inputHolder %= arma::repmat(arma::vec({ DEG2RAD }), 3, 1);
-		//mapInputMonitor.at(KEY_GYR).inputHolder %= arma::repmat(arma::vec({ DEG2RAD }), 3, 1);
+		const arma::mat33 rBody2H = isQuaternion ? Frames::matrixBody2H(Frames::rpyFromMatrixBody2Enu(sIns.BODY2ENU)) : FrameCache::getInstance().matrixBody2H(sIns.RPY);
+		acc = rBody2H * acc;
+		gyr = rBody2H * gyr;
 	}
-	mapInputMonitor.at(KEY_GPS).inputHolder.subvec(0, 1) %= arma::repmat(arma::vec({ DEG2RAD }), 2, 1);
-	isGpsDataNew = arma::sum(arma::abs(oldGpsData - mapInputMonitor.at(KEY_GPS).inputHolder)) > 0;
-	isGpsDataValid = !mapInputMonitor.at(KEY_GPS).inputHolder.has_nan();
-
-	mapInputMonitor.at(KEY_ACC).inputHolder %= sInputValues.bodySelector;
-	mapInputMonitor.at(KEY_GYR).inputHolder %= sInputValues.attitudeSelector;
-	mapInputMonitor.at(KEY_MAG).inputHolder %= sInputValues.bodySelector;
 
-	if(sInputValues.doPlatformAlignment)
+	if(sInputValues.correctForGravity)
 	{
-		mapInputMonitor.at(KEY_ACC).inputHolder = Frames::matrixBody2H(rpyIns) * mapInputMonitor.at(KEY_ACC).inputHolder;
-		mapInputMonitor.at(KEY_GYR).inputHolder = Frames::matrixBody2H(rpyIns) * mapInputMonitor.at(KEY_GYR).inputHolder;
+		gl(2) = Frames::gravityCorrectionForComponentZ(gps(2), gps(0));
+		acc -= (isQuaternion ? sIns.BODY2ENU : FrameCache::getInstance().matrixBody2Enu(sIns.RPY)) * gl;
 	}
 
-	if(sInputValues.correctForGravity)
+	// Preintegration: the epoch closes after -n samples, or earlier with a new GPS fix so that the updates are not delayed
+	if (sInputValues.navDecimation > 1)
 	{
-		gl(2) = Frames::gravityCorrectionForComponentZ(mapInputMonitor.at(KEY_GPS).inputHolder(2),mapInputMonitor.at(KEY_GPS).inputHolder(0));
-		mapInputMonitor.at(KEY_ACC).inputHolder -= Frames::matrixBody2Enu(rpyIns) * gl;
+		cPreintegrator.add(gyr, acc);
+		isNavEpoch = isGpsDataNew || (cPreintegrator.getSamples() >= sInputValues.navDecimation);
+		if (isNavEpoch)
+		{
+			navPeriod = cPreintegrator.close(gyr, acc);
+		}
+	}
+	else
+	{
+		isNavEpoch = true;
 	}
+
+	epochInputs.set(KEY_ACC, acc);
+	epochInputs.set(KEY_GYR, gyr);
 }
 
-/* Get map holding inputs organized in KEYS */
-const MapInputMonitor_t& NavDataInterface::getMapInputMonitor(void) const
+/* Get inputs of the current epoch */
+const EpochInputs& NavDataInterface::getEpochInputs(void) const
 {
-	return mapInputMonitor;
+	return epochInputs;
 }
 
 /* Get user entered input values */
@@ -171,3 +297,13 @@ const int NavDataInterface::getEpochCounter(void) const
 {
 	return epochCounter;
 }
+
+const bool NavDataInterface::getIsNavEpoch(void) const
+{
+	return isNavEpoch;
+}
+
+const double NavDataInterface::getNavPeriod(void) const
+{
+	return navPeriod;
+}
@@ -2,7 +2,7 @@
  @file interface_navdata.h
  @author Nicolas Padron
  @brief Description: This file contains the variables holding the input arguments that play a role in navigation:
-	- CSV indexes for IMU or GPS measurements and corresponding values (MapInputMonitorStruct)
+	- CSV indexes entered for IMU or GPS measurements and corresponding values of each epoch (EpochInputs)
 	- Command line inputs for controlling/tuning the processing flow (InputValues_t)
 		- NOTE: this command line entered inputs are part of ui.cpp/.h, however for centralization it is convenient to have them accessible from intetrface_navdata.cpp/.h.
 */
@@ -12,6 +12,7 @@
 
 #include <general/general.h>
 #include <interface/ui/ui.h>
+#include <processing/system/ins/proc_system_ins_preint.h>
 
 
 /* Input Keys */
@@ -25,35 +26,60 @@ enum MonitorInputKeys_e {
 	KEY_TOTAL
 };
 
-/*! 
- @brief Input monitor struct for each Key.
- The idea is to parse every input field with an id (user entered CSV column number) and store the corresponding value.
- */
-class MapInputMonitorStruct {
+/* Number of values of each key: XYZ for accelerometers, gyrometers and magnetometers, LAT/LON/HEIGHT for GPS, roll/pitch/yaw for attitude angles. HDOP uses the 1st one. */
+constexpr int INPUT_KEY_ELEMS = 3;
+
+/*!
+ @brief Inputs of one epoch, in plain fixed-size storage indexed by MonitorInputKeys_e, so that an epoch takes a few cache lines and no heap allocation.
+ Each value comes from a CSV column entered by the user (see isEntered), the values of the columns not entered keep their default.
+ \class EpochInputs
+*/
+class EpochInputs {
 public:
-	/*! Constructor */
-	MapInputMonitorStruct(){};
-
-	/*! 
-	@brief Constructor used to insert/create new entry in NavDataInterface::Initialize function
-	@param in_inputId: ID number, i.e., column number in CSV/Excel
-	@param in_inputHolder: actual value. It is entered as a 3D array: XYZ (for accelerometers, gyrometers and magnetometers), radians (for LAT/LON, or attitude angles).
-	*/
-	MapInputMonitorStruct(arma::Mat<int> in_inputId, arma::vec in_inputHolder = arma::vec({0, 0, 0}))
+	/*! Constructor: all values 0, no column entered */
+	EpochInputs()
+	{
+		for (int key = 0; key < KEY_TOTAL; key++)
+		{
+			for (int i = 0; i < INPUT_KEY_ELEMS; i++)
+			{
+				values[key][i] = 0;
+			}
+		}
+		enteredMask = 0;
+	};
+
+	/*! Get the values of a key as a fixed-size vector (no allocation) */
+	arma::vec3 get(MonitorInputKeys_e key) const
 	{
-		inputId = in_inputId;
-		nElems = (uint8_t)inputId.n_cols;
-		inputHolder = in_inputHolder;
-	}
+		return arma::vec3(values[key]);
+	};
+	/*! Set the values of a key */
+	void set(MonitorInputKeys_e key, const arma::vec3& in)
+	{
+		for (int i = 0; i < INPUT_KEY_ELEMS; i++)
+		{
+			values[key][i] = in(i);
+		}
+	};
+	/*! Check if the CSV column of an element of a key was entered */
+	bool isEntered(int key, int i) const
+	{
+		return ((enteredMask >> (key * INPUT_KEY_ELEMS + i)) & 1u) != 0;
+	};
+	/*! Set the CSV column of an element of a key as entered */
+	void setEntered(int key, int i)
+	{
+		enteredMask |= 1u << (key * INPUT_KEY_ELEMS + i);
+	};
 
 	// Variables
-	arma::Mat<int> inputId;
-	arma::vec inputHolder;
-	uint8_t nElems = 0;
+	double values[KEY_TOTAL][INPUT_KEY_ELEMS];
+	uint32_t enteredMask;
 };
 
-/* Typedef map for input monitor struct */
-typedef std::map<MonitorInputKeys_e, MapInputMonitorStruct> MapInputMonitor_t;
+/* Preprocessed inputs of a block of rows (see Input::getBlock), in structure of arrays layout: one array per key and element, indexed by the row of the block */
+typedef double PreprocBlock_t[KEY_TOTAL][INPUT_KEY_ELEMS][INPUT_BLOCK_MAX_ROWS];
 
 /*!
  @brief Input data file monitor class. Its purpose is to manage the input data to be used for navigation. It is not the same as UI input or general Input class handler.
@@ -66,14 +92,15 @@ public:
 	NavDataInterface& operator=(const NavDataInterface&) = delete;
 	~NavDataInterface() {};
 
-	/*! Initialize interface. Creates MapInputMonitorStruct entries. */
+	/*! Initialize interface. Sets the inputs entered as CSV columns. */
 	void initialize(void);
 	
-	/*! Update at every new input file row, i.e., every unit of time. Updates the map field in MapInputMonitorStruct entries. */
+	/*! Update at every new input file row, i.e., every unit of time. Updates the inputs of the epoch.
+	The rows are preprocessed a block at a time (see preprocessBlock), only the steps depending on the processing state run on each epoch. */
 	void update(void);
 
-	/*! Function to retrieve private MapInputMonitorStruct */
-	const MapInputMonitor_t& getMapInputMonitor(void) const;
+	/*! Function to retrieve the inputs of the current epoch */
+	const EpochInputs& getEpochInputs(void) const;
 	
 	/*! Function to retrieve user entered input values with navigation purpose (different to the general UI entered, which are for example filenames or CSV columns) */
 	const InputValues_t& getInputValues(void) const;
@@ -87,16 +114,38 @@ public:
 	
 	/*! Get epoch counter */
 	const int getEpochCounter(void) const;
+
+	/*! Function to retrieve the bool checking if the current row closes a navigation epoch, in which case the systems are processed.
+	With -n above 1 the IMU samples are preintegrated and the epoch inputs of accelerometers and gyrometers are their mean over the epoch. */
+	const bool getIsNavEpoch(void) const;
+
+	/*! Get the period of the current navigation epoch [s], 1 / fs_imu without preintegration */
+	const double getNavPeriod(void) const;
 	
 private:
 	// Private constructor
 	NavDataInterface() {};
+	/*! Preprocess all the rows of an input block: rest bias, quantization, platform to body, selectors (without bias feedback) and units.
+	These steps only depend on the inputs, so they run element by element over the arrays of the block, which the compiler vectorizes. */
+	void preprocessBlock(const InputBlock_t& block);
+
 	// Variables
-	MapInputMonitor_t mapInputMonitor;
+	EpochInputs epochInputs;
 	InputValues_t sInputValues;
 	int epochCounter;
 	bool isGpsDataNew;
 	bool isGpsDataValid;
+	// Preintegration of the IMU samples of the navigation epochs
+	ImuPreintegrator cPreintegrator;
+	bool isNavEpoch;
+	double navPeriod;
+	// Preprocessing: constant transforms taken from the inputs at initialize(), values of the last block and its sequence number
+	double plat2Body[3][3];
+	double restBias[KEY_TOTAL][INPUT_KEY_ELEMS];
+	double scale[KEY_TOTAL][INPUT_KEY_ELEMS]; // Selector or conversion to radians, 1 if none
+	double defaultValue[KEY_TOTAL][INPUT_KEY_ELEMS]; // Value of the columns not entered
+	PreprocBlock_t preprocessed;
+	uint64_t preprocessedSequence;
 };
 extern NavDataInterface& cInterfaceNavdata;
 
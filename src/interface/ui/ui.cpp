@@ -7,6 +7,11 @@
 #include <general/general.h>
 #include <monitor/monitor.h>
 #include <interface/ui/ui.h>
+#include <processing/frames/frames.h>
+#include <processing/frames/frames_batch.h>
+#include <processing/kf/proc_kf.h>
+#include <sstream>
+#include <iomanip>
 
 #ifndef WFUI_INTERFACE
 
@@ -48,7 +53,9 @@ template <typename InType, size_t arrSize>
 }
 template void strvecToArray<int, 2>(const string& str, array<int, 2>& arr);
 template void strvecToArray<uint16_t, 3>(const string& str, array<uint16_t, 3>& arr);
+template void strvecToArray<int, 3>(const string& str, array<int, 3>& arr);
 template void strvecToArray<double, 3>(const string& str, array<double, 3>& arr);
+template void strvecToArray<double, 4>(const string& str, array<double, 4>& arr);
 
 /* Check if input is within the acceptable range */
 static int checkInputScalar(const int input, const int inMin, const int inMax, string msg)
@@ -199,7 +206,25 @@ void UI::ui_usage(void)
 		"Commands ( * = mandatory ):\n"
 		"  -?     HELP, show this menu again\n"
 		"  --idx  If this flag is entered, the software will read the input CSV file and write a .txt indicating each column number. Program finishes after this.\n"
+		"  --bin  If this flag is entered, the software will convert the input CSV file into a binary log (.nfb) in the input folder. Program finishes after this.\n"
+		"         GPS (-C, -H) columns are stored only when they change. Columns whose values are read back exactly from float32 (e.g. IMU with few decimals)\n"
+		"         are stored as float32. The binary log can then be entered as input file (-I) with the same CSV columns.\n"
+		"  --bench  If this flag is entered, the software will benchmark the field parser against strtod on all the fields of the input CSV file. Program finishes after this.\n"
+		"  --geo  If this flag is entered, the software will check the accuracy and benchmark the ECEF to LLH conversions (-e) on a sweep of latitudes, longitudes and heights\n"
+		"         from -10 km to 100 km, and of the batch conversions (--conv) against the Frames functions, with each SIMD kernel against the scalar one.\n"
+		"         No input file needed. Program finishes after this.\n"
+		"  --conv If this flag is entered, the software will convert the GPS coordinates (-C, -H or -h) of the input CSV file to ECEF and ENU (origin at the 1st point)\n"
+		"         with the batch SIMD conversions, writing conversion.csv in the output directory (-O). Only -I, -O and -C are needed. Program finishes after this.\n"
+		"  --kf   If this flag is entered, the software will benchmark the Kalman Filter engines (-k) on the 15 states model with the states\n"
+		"         selected by -x and -z, 300 Hz prediction and 1 Hz update. No input file needed. Program finishes after this.\n"
 		"  -I *   Input CSV file. NOTE: must be comma separated, not Excel type. The program expects a CSV file with decimals represented with dots: \"0.1,0.5,...\".\n"
+		"         Live input is also accepted: \"-\" for standard input, the path of a named pipe, or \"unix:path\" for a UNIX domain socket.\n"
+		"         Rows are processed as they arrive and the output files are flushed every epoch.\n"
+		"         gzip and zstd compressed files are decoded while reading, detected by their content.\n"
+		"  -G     GNSS input CSV file, for GPS recorded at its own rate. -C and -H are then columns of this file.\n"
+		"         Rows are merged by timestamp (-S) with the IMU rows of -I: each IMU row is one epoch and takes the last GNSS row received.\n"
+		"  -U     Magnetometer/attitude input CSV file. -M, -R, -P and -Y are then columns of this file, merged by timestamp (-S) as -G.\n"
+		"  -S     CSV Columns for TIMESTAMP in seconds, order as \"imu, gnss, aux\". Mandatory with -G or -U, enter -1 for files not used.\n"
 		"  -O *   Output directory\n"
 		"  -K *   Contains Process Noise and Measurement Noises in the order: [1x3 acc bias, 1x3 gyr bias, 1x3 acc drift bias, 1x3 gyr drift bias, 1x3 GPS DOPs].\n"
 		"  -F *   Sampling Rate in Hz, order as \"fs_imu, fs_gps\"\n"
@@ -229,9 +254,39 @@ void UI::ui_usage(void)
 		"  -g     Gravity correction for Z component: correct = 1, do not correct = 0\n"
 		"  -y     Progress attitude angles or take input ones. Set to 1 to 1st use attitude angles from entered (CSV indexes) or calculated (from acc, gyr, mag) \n"
 	    "         and then continue with Euler derivatives. Set to 0 to use entered/calculated all the time, no euler derivatives used. Default is 1.\n"
+		"         Set to 2 to continue with a quaternion propagated with the gyrometer increments instead: the Body to ENU matrix is built\n"
+		"         from it with multiplications only and used by the INS, the Kalman Filter and the fusion. The angles are only derived\n"
+		"         from it when the outputs are written. -z then selects gyrometer axes.\n"
 		"  -t     Correlation time in seconds to be used in State Transition Matrix 1st order Markov processes for accelerometer and gyrometer drift. Default is 1.\n"
 		"  -T     Interval in seconds to turn GPS off in GPS-INS fusion. Enter as \"min,max\" both > 0. Default is \"-1,-1\" which means \"don't turn off\".\n"
 		"  -q     Quantization factor to apply to input IMU values to remove small variations. Criteria is floor(x * QF) / QF. Default is 10000.\n"
+		"  -B     Read and parse the input file in a background thread, handing the rows to the processing through a ring buffer. Enter as \"capacity,wait\".\n"
+		"         capacity: number of rows in the ring (rounded up to power of 2), 0 disables the thread. wait: 0 spin, 1 yield, 2 sleep while ring is full/empty.\n"
+		"         Default is \"0,1\".\n"
+		"  -j     Parallel ingest: decode the whole input CSV in memory at start using this number of threads, then process from memory.\n"
+		"         Values above the number of cores use all the cores. Set to 0 to read row by row. Takes precedence over -B. Default is 0.\n"
+		"  -s     Time window to process, in seconds of the timestamp column (-S). Enter as \"start,end,warmup\", -1 for the start or the end of the input.\n"
+		"         warmup: seconds processed before start for the filter to converge, not written to the outputs. The input CSV is seeked to the window\n"
+		"         with a sparse index of the timestamps, built on the 1st run and saved next to the input file (*_SEEK.txt). Default is \"-1,-1,0\".\n"
+		"  -Z     Decode compressed input files in a background thread, overlapping with the processing. Enable (set to 1), disable (set to 0). Default is 0.\n"
+		"  -b     Rows of the blocks of epochs read ahead and preprocessed at once (bias, quantization, platform to body, units). Live inputs use 1.\n"
+		"         Set to 1 to read and preprocess row by row. Default is 64.\n"
+		"  -e     Method of the ECEF to LLH conversions: 0 iterative, 1 closed form (Bowring, single iteration, error below 0.1 mm). Default is 0.\n"
+		"  -k     Kalman Filter engine: 0 Armadillo matrices, 1 fixed-size arrays (no heap temporaries, no BLAS), 2 fixed-size arrays skipping\n"
+		"         the zero blocks of the state transition and noise control matrices in the covariance prediction (same results as 1),\n"
+		"         3 Armadillo matrices of the states selected by -x and -z only (9 of 15 states with the defaults), 4 fixed-size arrays\n"
+		"         with the covariance stored as its upper triangle and the GPS coordinates applied one by one (no inverse), 5 same updates\n"
+		"         in float, with the covariance factorized as U * D * U' (Bierman-Thornton), which keeps it positive definite. Default is 0.\n"
+		"  -c     IMU epochs per propagation of the Kalman Filter covariance, only with -k 0. The state is predicted every epoch, the transitions\n"
+		"         are accumulated and the covariance propagated once with them, and always before a GPS update. Set to 0 to propagate it\n"
+		"         only before the updates. Default is 1, every epoch.\n"
+		"  -u     Steady-state gain of the Kalman Filter, only with -k 0. Enter as \"convergence,rate,acceleration,gap\". When the gain and the\n"
+		"         covariance change less than convergence (relative) from an update to the next, they are kept and only the state is\n"
+		"         predicted and updated, until the angular rate [rad/s] or the acceleration [m/s^2] measured exceed theirs, or no GPS\n"
+		"         update comes for gap [s]. Set convergence to 0 to disable. Default is \"0,0.05,0.5,2\".\n"
+		"  -n     IMU samples per navigation epoch. The gyrometer and accelerometer samples are preintegrated into angle and velocity\n"
+		"         increments, with coning and sculling compensations, and the INS mechanization, the Kalman Filter and the outputs run\n"
+		"         once per epoch. An epoch closes earlier when a GPS fix arrives. Default is 1, every sample.\n"
 	);
 }
 
@@ -268,6 +323,14 @@ void UI::handleInputCmdLine(void)
 		(mapInputArgs.find("C") != mapInputArgs.end()) &&
 		((mapInputArgs.find("Y") != mapInputArgs.end()) || (mapInputArgs.find("M") != mapInputArgs.end())) &&
 		((mapInputArgs.find("H") != mapInputArgs.end()) || (mapInputArgs.find("h") != mapInputArgs.end()));
+		// The geodetic and Kalman Filter benchmarks run on their own data, without input file
+		checkMandatory = checkMandatory || (mapInputArgs.find(INPUT_SUBARGS_GEODETIC) != mapInputArgs.end());
+		checkMandatory = checkMandatory || (mapInputArgs.find(INPUT_SUBARGS_KF) != mapInputArgs.end());
+		// The conversion mode only needs the input and output, and the GPS columns
+		checkMandatory = checkMandatory || ((mapInputArgs.find(INPUT_SUBARGS_CONVERT) != mapInputArgs.end()) &&
+			(mapInputArgs.find("I") != mapInputArgs.end()) &&
+			(mapInputArgs.find("O") != mapInputArgs.end()) &&
+			(mapInputArgs.find("C") != mapInputArgs.end()));
 
 		if (!checkMandatory)
 		{
@@ -310,7 +373,7 @@ void UI::convertInputCmdLineToString(void)
 			isStrCmdArgLabel = isStrCmdArgSubLabel = false;
 			// Check if the string read is within the input argument or subargument label lists predefined
 			auto itIsStrLabel = str.substr(0, 1).find("-"); // Check if the string read is label or sublabel syntax
-			if (itIsStrLabel != str.npos)
+			if ((itIsStrLabel != str.npos) && (str != FILE_STREAM_STDIN)) // A lone "-" is the standard input entered as argument of "-I"
 			{
 				isStrCmdArgLabel = true;
 				// Here we check if it is a label argument, i.e. start with "-" or subargument e.g., "--idx".
@@ -391,11 +454,21 @@ void UI::loadDefaultValues(void)
 	inputCmdLineStr.push_back("-f 0");					// [bool]
 	inputCmdLineStr.push_back("-m 0"); 					// [bool]
 	inputCmdLineStr.push_back("-g 0"); 					// [bool]
-	inputCmdLineStr.push_back("-y 1");					// [bool]
+	inputCmdLineStr.push_back("-y 1");					// {input, Euler, quaternion}
 
 	inputCmdLineStr.push_back("-t 1"); 					// [scalar]
 	inputCmdLineStr.push_back("-T -1,-1"); 				// [s]
 	inputCmdLineStr.push_back("-q 10000"); 				// [scalar]
+	inputCmdLineStr.push_back("-B 0,1"); 				// {capacity, wait}
+	inputCmdLineStr.push_back("-j 0"); 					// [threads]
+	inputCmdLineStr.push_back("-s -1,-1,0"); 			// {start, end, warmup} [s]
+	inputCmdLineStr.push_back("-Z 0"); 					// [bool]
+	inputCmdLineStr.push_back("-b 64"); 				// [rows]
+	inputCmdLineStr.push_back("-e 0"); 					// {iterative, closed form}
+	inputCmdLineStr.push_back("-k 0"); 					// {Armadillo, fixed-size, fixed-size by blocks, reduced, packed, UD float}
+	inputCmdLineStr.push_back("-c 1"); 					// [epochs]
+	inputCmdLineStr.push_back("-u 0,0.05,0.5,2"); 		// {convergence, rate [rad/s], acceleration [m/s^2], GPS gap [s]}
+	inputCmdLineStr.push_back("-n 1"); 					// [samples]
 
 	// Load default values
 	cInputCmdLine.readInputCmdLine(inputCmdLineStr, mapInputArgs);
@@ -450,8 +523,8 @@ void UI::loadParams()
 	string cmdArgLabel;
 	string cmdArg;
 	string filename;
-	bool flagIndexHandled, inputFilenameHandled;
-	flagIndexHandled = inputFilenameHandled = false;
+	bool flagIndexHandled, flagBinaryHandled, flagBenchHandled, flagGeodeticHandled, flagConvertHandled, flagKfHandled, inputFilenameHandled;
+	flagIndexHandled = flagBinaryHandled = flagBenchHandled = flagGeodeticHandled = flagConvertHandled = flagKfHandled = inputFilenameHandled = false;
 	try
 	{
 		for (auto mapEntry : mapInputArgs)
@@ -465,6 +538,26 @@ void UI::loadParams()
 				{
 					flagIndexHandled = true;
 				}
+				else if (string(INPUT_SUBARGS_BINARY) == cmdArgLabel)
+				{
+					flagBinaryHandled = true;
+				}
+				else if (string(INPUT_SUBARGS_BENCH) == cmdArgLabel)
+				{
+					flagBenchHandled = true;
+				}
+				else if (string(INPUT_SUBARGS_GEODETIC) == cmdArgLabel)
+				{
+					flagGeodeticHandled = true;
+				}
+				else if (string(INPUT_SUBARGS_CONVERT) == cmdArgLabel)
+				{
+					flagConvertHandled = true;
+				}
+				else if (string(INPUT_SUBARGS_KF) == cmdArgLabel)
+				{
+					flagKfHandled = true;
+				}
 			}
 			else
 			{
@@ -474,6 +567,21 @@ void UI::loadParams()
 					cInput.cFilesHandler.at(FILE_INPUT).setFilename(Input::removeStartingWhiteSpace(cmdArg));
 					inputFilenameHandled = true;
 					break;
+				case INPUT_ARGS_INFILE_GNSS:
+					cInput.cFilesHandler.at(FILE_INPUT_GNSS).setFilename(Input::removeStartingWhiteSpace(cmdArg));
+					break;
+				case INPUT_ARGS_INFILE_AUX:
+					cInput.cFilesHandler.at(FILE_INPUT_AUX).setFilename(Input::removeStartingWhiteSpace(cmdArg));
+					break;
+				case INPUT_ARGS_TIMESTAMPS:
+				{
+					std::array<int, 3> timestamps{ -1, -1, -1 };
+					strvecToArray(cmdArg, timestamps);
+					cInputIds.TIMESTAMP = timestamps.at(0);
+					cInputIds.TIMESTAMP_GNSS = timestamps.at(1);
+					cInputIds.TIMESTAMP_AUX = timestamps.at(2);
+					break;
+				}
 				case INPUT_ARGS_OUTFILE:
 					sInputValues.outputDir = cmdArg.c_str();
 					// Set output filename
@@ -486,6 +594,9 @@ void UI::loadParams()
 					cInput.cFilesHandler.at(FILE_OUTPUT_KML_INS).setFilename(filename);
 					filename = Input::removeStartingWhiteSpace(sInputValues.outputDir + "/" + OUTPUT_FILENAME_FUSION);
 					cInput.cFilesHandler.at(FILE_OUTPUT_KML_FUSION).setFilename(filename);
+					// Set conversion mode filename
+					filename = Input::removeStartingWhiteSpace(sInputValues.outputDir + "/" + OUTPUT_FILENAME_CONVERSION);
+					cInput.cFilesHandler.at(FILE_OUTPUT_CONVERSION).setFilename(filename);
 					break;
 				case INPUT_ARGS_INTERVAL_GPS_OFF:
 					std::array<int16_t, 2> intervalGpsOff;
@@ -501,6 +612,70 @@ void UI::loadParams()
 				case INPUT_QUANTIZATION_FACTOR:
 					sInputValues.quantFactor = atoi(cmdArg.c_str());
 					break;
+				case INPUT_ARGS_READER_RING:
+					sInputValues.readerRingCapacity = atoi(cmdArg.substr(0, cmdArg.find(",")).c_str());
+					sInputValues.readerRingPolicy = atoi(cmdArg.substr(cmdArg.find(",") + 1).c_str());
+					ret = checkInputScalar(atoi(cmdArg.substr(0, cmdArg.find(",")).c_str()), 0, READER_RING_MAX_CAPACITY, "Reader Ring Capacity");
+					if (ret == ERROR_RETURN_NOERROR)
+					{
+						ret = checkInputScalar(atoi(cmdArg.substr(cmdArg.find(",") + 1).c_str()), 0, RING_WAIT_TOTAL - 1, "Reader Ring Wait");
+					}
+					break;
+				case INPUT_ARGS_INGEST_THREADS:
+					sInputValues.ingestThreads = atoi(cmdArg.c_str());
+					ret = checkInputScalar(sInputValues.ingestThreads, 0, INGEST_MAX_THREADS, "Ingest Threads");
+					break;
+				case INPUT_ARGS_BLOCK_ROWS:
+					sInputValues.blockRows = atoi(cmdArg.c_str());
+					ret = checkInputScalar(atoi(cmdArg.c_str()), 1, (int)INPUT_BLOCK_MAX_ROWS, "Block Rows");
+					break;
+				case INPUT_ARGS_GEODETIC:
+					sInputValues.geodeticMethod = atoi(cmdArg.c_str());
+					ret = checkInputScalar(atoi(cmdArg.c_str()), 0, Frames::GEODETIC_TOTAL - 1, "Geodetic Method");
+					break;
+				case INPUT_ARGS_KF_ENGINE:
+					sInputValues.kfEngine = atoi(cmdArg.c_str());
+					ret = checkInputScalar(atoi(cmdArg.c_str()), 0, KF_ENGINE_TOTAL - 1, "KF Engine");
+					break;
+				case INPUT_ARGS_KF_COVARIANCE:
+					sInputValues.kfCovarianceEpochs = atoi(cmdArg.c_str());
+					ret = checkInputScalar(atoi(cmdArg.c_str()), 0, UINT16_MAX, "KF Covariance Epochs");
+					break;
+				case INPUT_ARGS_KF_STEADY:
+				{
+					std::array<double, 4> kfSteady{ 0, 0, 0, 0 };
+					strvecToArray(cmdArg, kfSteady);
+					sInputValues.kfSteady = kfSteady;
+					if ((kfSteady.at(0) < 0) || (kfSteady.at(1) < 0) || (kfSteady.at(2) < 0) || (kfSteady.at(3) < 0))
+					{
+						updateDisplayOutputConsoleCpp("KF Steady State: value entered out of range", true);
+						ret = ERROR_RETURN_OUT_RANGE;
+					}
+					break;
+				}
+				case INPUT_ARGS_NAV_DECIMATION:
+					sInputValues.navDecimation = atoi(cmdArg.c_str());
+					ret = checkInputScalar(atoi(cmdArg.c_str()), 1, UINT16_MAX, "Navigation Decimation");
+					break;
+				case INPUT_ARGS_DECODE_THREAD:
+					ret = checkInputScalar(atoi(cmdArg.c_str()), 0, 1, "Decode Thread");
+					for (int fileIndex : { FILE_INPUT, FILE_INPUT_GNSS, FILE_INPUT_AUX })
+					{
+						cInput.cFilesHandler.at(fileIndex).setDecodeThreaded(atoi(cmdArg.c_str()) != 0);
+					}
+					break;
+				case INPUT_ARGS_TIME_WINDOW:
+				{
+					std::array<double, 3> timeWindow{ -1, -1, 0 };
+					strvecToArray(cmdArg, timeWindow);
+					sInputValues.timeWindow = timeWindow;
+					if (((timeWindow.at(0) >= 0) && (timeWindow.at(1) >= 0) && (timeWindow.at(1) < timeWindow.at(0))) || (timeWindow.at(2) < 0))
+					{
+						updateDisplayOutputConsoleCpp("Time Window: value entered out of range", true);
+						ret = ERROR_RETURN_OUT_RANGE;
+					}
+					break;
+				}
 				case INPUT_ARGS_HEIGHT_VAL:
 					sInputValues.heightVal = atof(cmdArg.c_str());
 					break;
@@ -548,9 +723,9 @@ void UI::loadParams()
 					sInputValues.inputAnglesInRadians = (bool)sInputValues.inputAnglesInRadians;
 					break;
 				case INPUT_ARGS_PROGRESS_ANGLES:
-					sInputValues.progressAngles = atoi(cmdArg.c_str());
-					ret = checkInputScalar(sInputValues.progressAngles, 0, 1, "Progress Angles");
-					sInputValues.progressAngles = (bool)sInputValues.progressAngles;
+					ret = checkInputScalar(atoi(cmdArg.c_str()), 0, 2, "Progress Angles");
+					sInputValues.progressAngles = (atoi(cmdArg.c_str()) != 0);
+					sInputValues.progressQuaternion = (atoi(cmdArg.c_str()) == 2);
 					break;
 				case INPUT_ARGS_GRAVITYCORR:
 					sInputValues.correctForGravity = atoi(cmdArg.c_str());
@@ -626,6 +801,19 @@ void UI::loadParams()
 			}
 		}
 
+		// The covariance propagation interval only applies to the Armadillo engine, checked once all arguments are read
+		if ((sInputValues.kfEngine != KF_ENGINE_ARMADILLO) && (sInputValues.kfCovarianceEpochs != 1))
+		{
+			updateDisplayOutputConsoleCpp("KF Covariance Epochs: only available with KF Engine 0", true);
+			throw MonitorException(ERROR_RETURN_INCONSISTENT_INPUTS);
+		}
+		// Same for the steady-state gain, enabled by a convergence above 0
+		if ((sInputValues.kfEngine != KF_ENGINE_ARMADILLO) && (sInputValues.kfSteady.at(0) > 0))
+		{
+			updateDisplayOutputConsoleCpp("KF Steady State: only available with KF Engine 0", true);
+			throw MonitorException(ERROR_RETURN_INCONSISTENT_INPUTS);
+		}
+
 		// If flag --idx is set, then read the 1st CSV line and write the inputs
 		if (flagIndexHandled && inputFilenameHandled)
 		{
@@ -634,6 +822,89 @@ void UI::loadParams()
 			updateDisplayOutputConsoleCpp("File with indexes written in input folder.", true);
 		}
 
+		// If flag --bin is set, then convert the input CSV into a binary log
+		if (flagBinaryHandled && inputFilenameHandled && (ret == ERROR_RETURN_NOERROR))
+		{
+			cInput.writeBinaryLog(cInputIds, sInputValues.fsImu, sInputValues.fsGps);
+			ret = ERROR_RETURN_BIN_HANDLED;
+			updateDisplayOutputConsoleCpp("Binary log written in input folder.", true);
+		}
+
+		// If flag --bench is set, then benchmark the field parser on the input CSV
+		if (flagBenchHandled && inputFilenameHandled && (ret == ERROR_RETURN_NOERROR))
+		{
+			cInput.benchmarkFieldParser();
+			ret = ERROR_RETURN_BENCH_HANDLED;
+		}
+
+		// If flag --geo is set, then check and benchmark the ECEF to LLH conversions
+		if (flagGeodeticHandled && (ret == ERROR_RETURN_NOERROR))
+		{
+			const Frames::GeodeticBenchmark_t results = Frames::benchmarkEcef2llh();
+			const char* methodNames[Frames::GEODETIC_TOTAL] = { "iterative", "closed form" };
+			for (int method = 0; method < Frames::GEODETIC_TOTAL; method++)
+			{
+				ostringstream msg;
+				msg << std::setprecision(3) << "Geodetic benchmark, " << methodNames[method] << ": " << results.points << " points, max error horizontal "
+					<< results.maxErrorHorizontal[method] << " m, vertical " << results.maxErrorVertical[method] << " m, "
+					<< std::fixed << std::setprecision(2) << results.nsPerConversion[method] << " ns/conversion, speedup "
+					<< results.nsPerConversion[Frames::GEODETIC_ITERATIVE] / results.nsPerConversion[method] << "x.";
+				updateDisplayOutputConsoleCpp(msg.str(), true);
+			}
+			// The closed form must stay within 1 mm
+			if (std::max(results.maxErrorHorizontal[Frames::GEODETIC_CLOSED_FORM], results.maxErrorVertical[Frames::GEODETIC_CLOSED_FORM]) >= 1e-3)
+			{
+				updateDisplayOutputConsoleCpp("WARNING: closed form ECEF to LLH error above 1 mm.", true);
+			}
+			// The batch conversions must match the Frames functions, and the SIMD kernels the scalar one bit for bit
+			const Frames::BatchBenchmark_t batchResults = Frames::benchmarkBatch();
+			string kernelsChecked;
+			for (int kernel = 0; kernel < Frames::BATCH_KERNEL_TOTAL; kernel++)
+			{
+				if (batchResults.isKernelChecked[kernel])
+				{
+					kernelsChecked += string(" ") + Frames::getBatchKernelName((Frames::BatchKernel_e)kernel);
+				}
+			}
+			ostringstream msg;
+			msg << "Batch conversions: " << batchResults.points << " points, " << Frames::getBatchKernelName(Frames::getBatchKernel()) << " kernel. "
+				<< std::fixed << std::setprecision(2) << "Batch " << batchResults.nsPerPointBatch << " ns/point, Frames functions "
+				<< batchResults.nsPerPointFrames << " ns/point, speedup " << batchResults.nsPerPointFrames / batchResults.nsPerPointBatch << "x. "
+				<< std::scientific << "Max difference to Frames functions: " << batchResults.maxDifference << " m"
+				<< ". Kernels checked against scalar:" << (kernelsChecked.empty() ? " none" : kernelsChecked) << (batchResults.isSameAsScalar ? ", same bits." : ", DIFFERENT bits.");
+			updateDisplayOutputConsoleCpp(msg.str(), true);
+			if (!batchResults.isSameAsScalar)
+			{
+				updateDisplayOutputConsoleCpp("WARNING: SIMD batch conversions differ from the scalar one.", true);
+			}
+			ret = ERROR_RETURN_GEO_HANDLED;
+		}
+
+		// If flag --conv is set, then convert the GPS coordinates of the input CSV
+		if (flagConvertHandled && inputFilenameHandled && (ret == ERROR_RETURN_NOERROR))
+		{
+			cInput.convertCoordinates(cInputIds, sInputValues.heightVal);
+			ret = ERROR_RETURN_CONV_HANDLED;
+		}
+
+		// If flag --kf is set, then benchmark the Kalman Filter engines
+		if (flagKfHandled && (ret == ERROR_RETURN_NOERROR))
+		{
+			const KfBenchmark_t results = KalmanFilter::benchmark(sInputValues.attitudeSelector, sInputValues.bodySelector);
+			const char* engineNames[KF_ENGINE_TOTAL] = { "Armadillo", "fixed-size", "fixed-size by blocks", "reduced", "packed", "UD float" };
+			for (int engine = 0; engine < KF_ENGINE_TOTAL; engine++)
+			{
+				ostringstream msg;
+				msg << std::fixed << std::setprecision(1) << "KF benchmark, " << engineNames[engine] << ": " << results.epochs << " epochs, "
+					<< results.updates << " updates, " << results.multiplyAdds[engine] << " multiplications/prediction, " << results.nsPerPrediction[engine] << " ns/prediction, " << results.nsPerUpdate[engine]
+					<< " ns/epoch with update, speedup " << std::setprecision(2) << results.nsPerPrediction[KF_ENGINE_ARMADILLO] / results.nsPerPrediction[engine]
+					<< "x, " << std::scientific << std::setprecision(2) << "max difference state " << results.maxDiffState[engine]
+					<< ", covariance (relative) " << results.maxDiffCovariance[engine] << ".";
+				updateDisplayOutputConsoleCpp(msg.str(), true);
+			}
+			ret = ERROR_RETURN_KF_HANDLED;
+		}
+
 		// Return if there was an error in any of the called functions
 		if (ret != ERROR_RETURN_NOERROR)
 		{
@@ -28,9 +28,12 @@ void updateDisplayOutputConsoleCpp(const std::string str, const bool forceDispla
 #endif // WFUI_INTERFACE
 
 /** Constants related to input arguments */
-constexpr int INPUT_ARGS_NUM = 29;
+constexpr int INPUT_ARGS_NUM = 42;
 
 constexpr char INPUT_ARGS_INFILE 			= 'I';
+constexpr char INPUT_ARGS_INFILE_GNSS 		= 'G';
+constexpr char INPUT_ARGS_INFILE_AUX 		= 'U';
+constexpr char INPUT_ARGS_TIMESTAMPS 		= 'S';
 constexpr char INPUT_ARGS_OUTFILE 			= 'O';
 constexpr char INPUT_ARGS_INTERVAL_GPS_OFF 	= 'T';
 constexpr char INPUT_ARGS_KFCFG 			= 'K';
@@ -58,10 +61,23 @@ constexpr char INPUT_ARGS_TAU				= 't';
 constexpr char INPUT_MECHANICS_LOCAL		= 'm';
 constexpr char INPUT_QUANTIZATION_FACTOR	= 'q';
 constexpr char INPUT_ARGS_INDEX				= 'i';
+constexpr char INPUT_ARGS_READER_RING		= 'B';
+constexpr char INPUT_ARGS_INGEST_THREADS	= 'j';
+constexpr char INPUT_ARGS_TIME_WINDOW		= 's';
+constexpr char INPUT_ARGS_DECODE_THREAD	= 'Z';
+constexpr char INPUT_ARGS_BLOCK_ROWS		= 'b';
+constexpr char INPUT_ARGS_GEODETIC			= 'e';
+constexpr char INPUT_ARGS_KF_ENGINE			= 'k';
+constexpr char INPUT_ARGS_KF_COVARIANCE		= 'c';
+constexpr char INPUT_ARGS_KF_STEADY			= 'u';
+constexpr char INPUT_ARGS_NAV_DECIMATION	= 'n';
 constexpr char INPUT_ARGS_HELP 				= '?';
 
 constexpr std::array<char, INPUT_ARGS_NUM> INPUT_ARGS_LABELS{
 	INPUT_ARGS_INFILE,
+	INPUT_ARGS_INFILE_GNSS,
+	INPUT_ARGS_INFILE_AUX,
+	INPUT_ARGS_TIMESTAMPS,
 	INPUT_ARGS_OUTFILE,
 	INPUT_ARGS_INTERVAL_GPS_OFF,
 	INPUT_ARGS_KFCFG,
@@ -88,19 +104,40 @@ constexpr std::array<char, INPUT_ARGS_NUM> INPUT_ARGS_LABELS{
 	INPUT_MECHANICS_LOCAL,
 	INPUT_QUANTIZATION_FACTOR,
 	INPUT_ARGS_TAU,
+	INPUT_ARGS_READER_RING,
+	INPUT_ARGS_INGEST_THREADS,
+	INPUT_ARGS_TIME_WINDOW,
+	INPUT_ARGS_DECODE_THREAD,
+	INPUT_ARGS_BLOCK_ROWS,
+	INPUT_ARGS_GEODETIC,
+	INPUT_ARGS_KF_ENGINE,
+	INPUT_ARGS_KF_COVARIANCE,
+	INPUT_ARGS_KF_STEADY,
+	INPUT_ARGS_NAV_DECIMATION,
 	INPUT_ARGS_HELP
 };
 
-constexpr int INPUT_SUBARGS_NUM = 1;
+constexpr int INPUT_SUBARGS_NUM = 6;
 constexpr char INPUT_SUBARGS_INDEX[] = "idx";
-constexpr std::array<char[4], INPUT_SUBARGS_NUM> INPUT_SUBARGS_LABELS{
-	"idx"
+constexpr char INPUT_SUBARGS_BINARY[] = "bin";
+constexpr char INPUT_SUBARGS_BENCH[] = "bench";
+constexpr char INPUT_SUBARGS_GEODETIC[] = "geo";
+constexpr char INPUT_SUBARGS_CONVERT[] = "conv";
+constexpr char INPUT_SUBARGS_KF[] = "kf";
+constexpr std::array<char[6], INPUT_SUBARGS_NUM> INPUT_SUBARGS_LABELS{
+	"idx",
+	"bin",
+	"bench",
+	"geo",
+	"conv",
+	"kf"
 };
 
 const string OUTPUT_FILENAME = "output.csv";
 const string OUTPUT_FILENAME_GPS = "kml_gps.kml";
 const string OUTPUT_FILENAME_IRS = "kml_irs.kml";
 const string OUTPUT_FILENAME_FUSION = "kml_fusion.kml";
+const string OUTPUT_FILENAME_CONVERSION = "conversion.csv";
 
 /* Fileanames entered at input command */
 enum FilenamesInput_e {
@@ -116,6 +153,16 @@ typedef struct InputValues_s
 {
 	std::array<int16_t,2> intervalGpsOff;
 	uint32_t quantFactor;
+	uint32_t readerRingCapacity;
+	uint8_t readerRingPolicy;
+	int16_t ingestThreads;
+	uint16_t blockRows; // Rows of the blocks of epochs preprocessed at once
+	uint8_t geodeticMethod; // Frames::GeodeticMethod_e of the ECEF to LLH conversions
+	uint8_t kfEngine; // KfEngine_e of the Kalman Filter
+	uint16_t kfCovarianceEpochs; // IMU epochs per Kalman Filter covariance propagation, 0 only before the updates
+	std::array<double, 4> kfSteady; // Kalman Filter steady-state gain: convergence threshold (0 disabled), max angular rate [rad/s], acceleration [m/s^2] and GPS gap [s]
+	uint16_t navDecimation; // IMU samples preintegrated per navigation epoch (INS, Kalman Filter and outputs), 1 processes every sample
+	std::array<double, 3> timeWindow; // start, end and warm-up in seconds of the timestamp column
 	uint8_t fsImu, fsGps;
 	double tau;
 	double heightVal;
@@ -124,6 +171,7 @@ typedef struct InputValues_s
 	bool doPlatformAlignment;
 	bool modeMechanicsLocal;
 	bool progressAngles;
+	bool progressQuaternion; // Progress the attitude with a quaternion instead of Euler derivatives
 	bool feedbackBias;
 	arma::vec attitudeSelector, bodySelector;
 	arma::vec diagPlat2Body;
@@ -146,11 +194,13 @@ public:
 		GYR.fill(-1);
 		MAG.fill(-1);
 		ROLL = PITCH = YAW = TIMESTAMP = HDOP = HEIGHT = -1;
+		TIMESTAMP_GNSS = TIMESTAMP_AUX = -1;
 	}
 
 	std::array<int8_t, 2> GPS;
 	std::array<int8_t, 3> ACC, GYR, MAG;
 	int8_t ROLL, PITCH, YAW, TIMESTAMP, HDOP, HEIGHT;
+	int8_t TIMESTAMP_GNSS, TIMESTAMP_AUX; // Timestamp columns of the GNSS and magnetometer/attitude input files
 };
 
 
@@ -64,6 +64,25 @@ int main(int argc, char* argv[])
 		*/
 		cInput.readline();
 
+		/* Build the column projection plan: only the CSV columns referenced by the input IDs are decoded on each row */
+		cInput.buildProjectionPlan(ui.getInputIds());
+
+		/* Seek the input to the time window, if entered */
+		cInput.seekTimeWindow(ui.getInputIds(), ui.getInputValues().timeWindow.at(0), ui.getInputValues().timeWindow.at(1), ui.getInputValues().timeWindow.at(2));
+
+		/* Decode the whole input file in parallel, or read and parse it in background, if enabled */
+		if (ui.getInputValues().ingestThreads != 0)
+		{
+			cInput.ingestParallel(ui.getInputValues().ingestThreads);
+		}
+		else if (ui.getInputValues().readerRingCapacity > 0)
+		{
+			cInput.startReader(ui.getInputValues().readerRingCapacity, (RingWaitPolicy_e)ui.getInputValues().readerRingPolicy);
+		}
+
+		/* Read the rows by blocks, preprocessed at once by the navdata interface */
+		cInput.startBlocks(ui.getInputValues().blockRows);
+
    }
    catch (const MonitorException& monExc)
    {
@@ -80,10 +99,32 @@ int main(int argc, char* argv[])
   
   /* Start loop processing */
   updateDisplayOutputConsoleCpp("PROCESSING STARTING", true);
+  const bool isInputLive = cInput.cFilesHandler.at(FILE_INPUT).isStream();
   
   /* Loop along the file */
-  while (cInput.readline(false, cInterfaceNavdata.getEpochCounter()))  /* Read the row and put into Fields. */
+  while (true)
   {
+	/* Read the row and put into Fields. Read errors, e.g. a truncated compressed input, end the processing. */
+	try
+	{
+		if (!cInput.readline(false, cInterfaceNavdata.getEpochCounter()))
+		{
+			break;
+		}
+	}
+   catch (const MonitorException& monExc)
+   {
+	   cMonitor.exitCode(monExc);
+	   cInput.closeFiles();
+	   return cMonitor.getExitCode();
+   }
+   catch (...)
+   {
+	   cMonitor.exitCode(MonitorException(ERROR_RETURN_UNKNOWN));
+	   cInput.closeFiles();
+	   return cMonitor.getExitCode();
+   }
+
 	/* Update monitor, not part of processing but contorls when to show display information */
 	cMonitor.update();
 
@@ -106,24 +147,56 @@ int main(int argc, char* argv[])
    }
    
 
-	/* Process systems: GNSS, INS and FUSION */
-	cSystems.process();
-
-	/* Write output files */
-	cOutputInterface.writeContent();
+	/* Process systems: GNSS, INS and FUSION, once per navigation epoch (-n IMU samples, or fewer when a GPS fix arrives) */
+	if (cInterfaceNavdata.getIsNavEpoch())
+	{
+		cSystems.process();
+
+		/* Write output files, except during the warm-up before a time window. On live input the epoch is flushed right away, not when the output buffers fill up. */
+		if (!cInput.isInWarmup())
+		{
+			cSystems.updateAttitudeAngles();
+			cOutputInterface.writeContent();
+			if (isInputLive)
+			{
+				cOutputInterface.flush();
+			}
+		}
+	}
 	
 	// Display some results on screen
 	if (cMonitor.flagsMonitorVariables_e.test(MON_DISPLAY_DATA_CHECK))
 	{
-		// Variable to hold the percentage of bytes read on the input file.
-		double ReadBytesPercentage = (double)cInput.cFilesHandler.at(FILE_INPUT).getReadBytes() / cInput.cFilesHandler.at(FILE_INPUT).getFileSize();
-		updateProgressBarCpp((int)(ReadBytesPercentage * 100));
+		const long long inputFileSize = cInput.cFilesHandler.at(FILE_INPUT).getFileSize();
+		if (inputFileSize > 0)
+		{
+			// Variable to hold the percentage of bytes read on the input file.
+			double ReadBytesPercentage = (double)cInput.getReadBytes() / inputFileSize;
+			updateProgressBarCpp((int)(ReadBytesPercentage * 100));
+		}
+		else
+		{
+			// Size unknown on live input, only the amount processed so far is shown
+			ostringstream msg;
+			msg << "Processing: " << cInterfaceNavdata.getEpochCounter() << " epochs, " << cInput.getReadBytes() << " bytes read.";
+			updateDisplayOutputConsoleCpp(msg.str());
+		}
 	}
  }
 	
 	/* Write eKML output footer and close input files */
 	cOutputInterface.kmlWriteFooter();
 	updateDisplayOutputConsoleCpp("PROCESSING COMPLETED!", true);
+
+	/* Run statistics of the Kalman Filter steady-state gain */
+	if (cInterfaceNavdata.getInputValues().kfSteady.at(0) > 0)
+	{
+		const DatatypesKF_t& sKf = NavsystemsHolder::getInstance().getPtrKf();
+		ostringstream msg;
+		msg << "Kalman Filter steady-state gain: " << sKf.steadyEpochs << " of " << sKf.epochs << " epochs, "
+			<< sKf.steadyEntries << " switches to it, " << sKf.steadyExits << " back to full propagation.";
+		updateDisplayOutputConsoleCpp(msg.str(), true);
+	}
 	cInput.closeFiles();
  
 	return cMonitor.getExitCode();
@@ -27,6 +27,11 @@ enum ErrorCodes_e {
 	ERROR_RETURN_NUMBER_KF_STD,
 	ERROR_RETURN_IDX_HANDLED,
 	ERROR_RETURN_UNKNOWN,
+	ERROR_RETURN_BIN_HANDLED,
+	ERROR_RETURN_BENCH_HANDLED,
+	ERROR_RETURN_GEO_HANDLED,
+	ERROR_RETURN_CONV_HANDLED,
+	ERROR_RETURN_KF_HANDLED,
 	ERROR_RETURN_TOTALERRORCODES
 };
 
@@ -49,12 +54,18 @@ class MonitorExceptionMap
 		excMap.insert(std::pair<int, string>(ERROR_RETURN_FILE_OPEN_ERROR,"File open error."));
 		excMap.insert(std::pair<int, string>(ERROR_RETURN_FILE_CLOSE_ERROR,"File close error."));
 		excMap.insert(std::pair<int, string>(ERROR_RETURN_FILE_WRITE_ERROR,"File write error."));
+		excMap.insert(std::pair<int, string>(ERROR_RETURN_FILE_READ_ERROR,"File read error."));
 		excMap.insert(std::pair<int, string>(ERROR_RETURN_OUT_RANGE,"Out of range value."));
 		excMap.insert(std::pair<int, string>(ERROR_RETURN_NUMBER_INPUTS,"Error in number of inputs."));
 		excMap.insert(std::pair<int, string>(ERROR_RETURN_INCONSISTENT_INPUTS,"Inconsistent input argument."));
 		excMap.insert(std::pair<int, string>(ERROR_RETURN_NUMBER_KF_STD,"Error in number KF noises entries."));
 		excMap.insert(std::pair<int, string>(ERROR_RETURN_IDX_HANDLED,"IDX written in file."));
 		excMap.insert(std::pair<int, string>(ERROR_RETURN_UNKNOWN,"Error unknown."));
+		excMap.insert(std::pair<int, string>(ERROR_RETURN_BIN_HANDLED,"Binary log written in file."));
+		excMap.insert(std::pair<int, string>(ERROR_RETURN_BENCH_HANDLED,"Parser benchmark done."));
+		excMap.insert(std::pair<int, string>(ERROR_RETURN_GEO_HANDLED,"Geodetic benchmark done."));
+		excMap.insert(std::pair<int, string>(ERROR_RETURN_CONV_HANDLED,"Coordinates conversion done."));
+		excMap.insert(std::pair<int, string>(ERROR_RETURN_KF_HANDLED,"Kalman Filter benchmark done."));
 	}
 	
 	std::map<int, std::string> excMap;
@@ -4,9 +4,13 @@
  @brief Description: In this file the processes of frames.h are implemented.
 */
 
+#include <string.h>
+#include <algorithm>
+#include <chrono>
+#include <vector>
 #include <processing/frames/frames.h>
 
-arma::vec Frames::llh2ecef(const arma::vec llh)
+arma::vec3 Frames::llh2ecef(const arma::vec3& llh)
 {
 	double phi, lambda, h, N;
 	double x, y, z;
@@ -27,9 +31,9 @@ arma::vec Frames::llh2ecef(const arma::vec llh)
 	return { x, y, z };
 }
 
-arma::vec Frames::ecef2llh(const arma::vec ecef)
+arma::vec3 Frames::ecef2llh(const arma::vec3& ecef)
 {
-	arma::vec LLH = arma::zeros(3, 1);
+	arma::vec3 LLH;
 	double diff_tan_u = 1;
 	double cos2u, sin2u, tan_phi, phi, lambda, h, u, N;
 	cos2u = sin2u = tan_phi = phi = lambda = h = u = N = 0;
@@ -42,7 +46,8 @@ arma::vec Frames::ecef2llh(const arma::vec ecef)
 	{
 		cos2u = (p > 0) ? (1 / (1 + pow(tan_u, 2))) : 0;
 		sin2u = 1 - cos2u;
-		tan_phi = ecef(2) + pow(ECC_SEC, 2) * SEMI_MINOR_B * pow(sqrt(sin2u), 3);
+		// sin(u)^3 keeps the sign of u (of Z), south of the equator it is negative
+		tan_phi = ecef(2) + pow(ECC_SEC, 2) * SEMI_MINOR_B * std::copysign(pow(sqrt(sin2u), 3), tan_u);
 		tan_phi /= (p - pow((double)ECC, 2) * SEMI_MAJOR_A * pow(sqrt(cos2u), 3));
 		diff_tan_u = tan_u;
 		tan_u = (double)SEMI_MINOR_B / SEMI_MAJOR_A * tan_phi;
@@ -77,37 +82,95 @@ arma::vec Frames::ecef2llh(const arma::vec ecef)
 	return LLH;
 }
 
-arma::vec Frames::ecef2enu(const arma::vec llh, const arma::vec ecef, const arma::vec xyz0)
+arma::vec3 Frames::ecef2llhClosedForm(const arma::vec3& ecef)
+{
+	const double a = SEMI_MAJOR_A;
+	const double b = SEMI_MINOR_B;
+	const double e2 = ECC * ECC;
+	const double ep2 = ECC_SEC * ECC_SEC;
+	const double p = sqrt(ecef(0) * ecef(0) + ecef(1) * ecef(1));
+
+	/* Parametric latitude from tan(beta) = a * z / (b * p), its sine and cosine are taken from the normalized terms instead of trigonometric functions */
+	const double rBeta = sqrt((a * ecef(2)) * (a * ecef(2)) + (b * p) * (b * p));
+	const double sinBeta = a * ecef(2) / rBeta;
+	const double cosBeta = b * p / rBeta;
+
+	/* Bowring: tan(phi) = (z + e'^2 * b * sin^3(beta)) / (p - e^2 * a * cos^3(beta)), signs kept in both terms */
+	const double num = ecef(2) + ep2 * b * sinBeta * sinBeta * sinBeta;
+	const double den = p - e2 * a * cosBeta * cosBeta * cosBeta;
+	const double rPhi = sqrt(num * num + den * den);
+	const double sinPhi = num / rPhi;
+	const double cosPhi = den / rPhi;
+
+	/* Height projected on the normal, valid at the poles as well */
+	const double N = a / sqrt(1 - e2 * sinPhi * sinPhi);
+	const double h = p * cosPhi + ecef(2) * sinPhi - a * a / N;
+
+	return { atan2(num, den), atan2(ecef(1), ecef(0)), h };
+}
+
+arma::vec3 Frames::ecef2llh(const arma::vec3& ecef, const int method)
 {
-	arma::Mat<double> rEcef2Enu = matrixEcef2Enu(llh);
+	return (method == GEODETIC_CLOSED_FORM) ? ecef2llhClosedForm(ecef) : ecef2llh(ecef);
+}
 
-	return rEcef2Enu * (ecef - xyz0);
+arma::vec3 Frames::ecef2enu(const arma::vec3& llh, const arma::vec3& ecef, const arma::vec3& xyz0)
+{
+	const arma::mat33 rEcef2Enu = matrixEcef2Enu(llh);
+	const arma::vec3 diff = ecef - xyz0;
+
+	return rEcef2Enu * diff;
 }
 
-arma::vec Frames::enu2ecef(const arma::vec llh, const arma::vec enu, const arma::vec xyz0)
+arma::vec3 Frames::enu2ecef(const arma::vec3& llh, const arma::vec3& enu, const arma::vec3& xyz0)
 {
-	arma::Mat<double> rEnu2Ecef = matrixEcef2Enu(llh).t();
+	const arma::mat33 rEnu2Ecef = matrixEcef2Enu(llh).t();
+	const arma::vec3 rotated = rEnu2Ecef * enu;
 
-	return rEnu2Ecef * enu + xyz0;
+	return rotated + xyz0;
 }
 
-arma::Mat<double> Frames::genRotRx(const float angle)
+arma::mat33 Frames::genRotRx(const float angle)
 {
-	arma::Mat<double> Rx = arma::zeros(3, 3);
-	Rx.col(0) = arma::vec({ 1, 0, 0 });
-	Rx.col(1) = arma::vec({ 0, cos(angle), -sin(angle) });
-	Rx.col(2) = arma::vec({ 0, sin(angle), cos(angle) });
+	arma::mat33 Rx(arma::fill::zeros);
+	Rx(0, 0) = 1;
+	Rx(1, 1) = cos(angle);
+	Rx(2, 1) = -sin(angle);
+	Rx(1, 2) = sin(angle);
+	Rx(2, 2) = cos(angle);
 	return Rx;
 }
 
-arma::Mat<double> Frames::matrixEcef2Enu(const arma::vec llh)
+arma::mat33 Frames::genRotRy(const float angle)
+{
+	arma::mat33 Ry(arma::fill::zeros);
+	Ry(1, 1) = 1;
+	Ry(2, 2) = cos(angle);
+	Ry(0, 2) = -sin(angle);
+	Ry(2, 0) = sin(angle);
+	Ry(0, 0) = cos(angle);
+	return Ry;
+}
+
+arma::mat33 Frames::genRotRz(const float angle)
+{
+	arma::mat33 Rz(arma::fill::zeros);
+	Rz(2, 2) = 1;
+	Rz(0, 0) = cos(angle);
+	Rz(1, 0) = -sin(angle);
+	Rz(0, 1) = sin(angle);
+	Rz(1, 1) = cos(angle);
+	return Rz;
+}
+
+arma::mat33 Frames::matrixEcef2Enu(const arma::vec3& llh)
 {
 	const double cosLat = cos(llh(0));
 	const double sinLat = sin(llh(0));
 	const double cosLon = cos(llh(1));
 	const double sinLon = sin(llh(1));
 
-	arma::mat rEcef2Enu = {
+	const arma::mat33 rEcef2Enu = {
 							{-sinLon         ,  cosLon         ,  0     },
 							{-sinLat * cosLon, -sinLat * sinLon, cosLat },
 							{ cosLat*cosLon  , cosLat * sinLon , sinLat}
@@ -116,22 +179,40 @@ arma::Mat<double> Frames::matrixEcef2Enu(const arma::vec llh)
 	return rEcef2Enu;
 }
 
+Frames::AttitudeTrig_t Frames::attitudeTrig(const arma::vec3& rpy)
+{
+	AttitudeTrig_t trig;
+	trig.sinRoll = sin(rpy(0));
+	trig.cosRoll = cos(rpy(0));
+	trig.sinPitch = sin(rpy(1));
+	trig.cosPitch = cos(rpy(1));
+	trig.tanPitch = tan(rpy(1));
+	trig.sinYaw = sin(rpy(2));
+	trig.cosYaw = cos(rpy(2));
+	return trig;
+}
+
 // Body 2 enu rotation matrix
-arma::Mat<double> Frames::matrixBody2Enu(const arma::vec rpy)
+arma::mat33 Frames::matrixBody2Enu(const arma::vec3& rpy)
+{
+	return matrixBody2Enu(attitudeTrig(rpy));
+}
+
+arma::mat33 Frames::matrixBody2Enu(const AttitudeTrig_t& trig)
 {
-	double roll = rpy(0);
-	double pitch = rpy(1);
-	double yaw = rpy(2);
+	const double sr = trig.sinRoll, cr = trig.cosRoll;
+	const double sp = trig.sinPitch, cp = trig.cosPitch;
+	const double sy = trig.sinYaw, cy = trig.cosYaw;
 	// Rotation is the same as doing: (ROT_RY(roll) * (ROT_RX(pitch) * ROT_RZ(-yaw))).t();
-	arma::mat rBody2Enu = {
-							{sin(yaw)*cos(pitch),  cos(yaw)*cos(roll) + sin(yaw)*sin(pitch)*sin(roll), -cos(yaw)*sin(roll) + sin(yaw)*sin(pitch)*cos(roll)},
-							{cos(yaw)*cos(pitch), -sin(yaw)*cos(roll) + cos(yaw)*sin(pitch)*sin(roll),  cos(yaw)*sin(pitch)*cos(roll)+sin(yaw)*cos(roll)  },
-							{sin(pitch)         , -cos(pitch)*sin(roll)                              , -cos(pitch)*cos(roll)                              }
+	arma::mat33 rBody2Enu = {
+							{sy*cp,  cy*cr + sy*sp*sr, -cy*sr + sy*sp*cr},
+							{cy*cp, -sy*cr + cy*sp*sr,  cy*sp*cr+sy*cr  },
+							{sp   , -cp*sr           , -cp*cr           }
 						  };
 	return  rBody2Enu.replace(arma::datum::nan, 0);
 }
 
-arma::mat Frames::matrixBody2H(const arma::vec rpy)
+arma::mat33 Frames::matrixBody2H(const arma::vec3& rpy)
 {
 	return ROT_RX(-rpy(0)) * ROT_RY(-rpy(1));
 }
@@ -142,26 +223,130 @@ arma::mat Frames::matrixPlatform2Body(arma::vec diagvec)
 	return Rp2n; 
 }
 
-arma::mat Frames::matrixRateAttitudeDynamics(const arma::vec rpy)
+arma::mat33 Frames::matrixRateAttitudeDynamics(const arma::vec3& rpy)
+{
+	return matrixRateAttitudeDynamics(attitudeTrig(rpy));
+}
+
+arma::mat33 Frames::matrixRateAttitudeDynamics(const AttitudeTrig_t& trig)
 {
-	arma::Mat<double> rpyRatesMatrix = arma::zeros(3, 3);
+	arma::mat33 rpyRatesMatrix(arma::fill::zeros);
 
 	rpyRatesMatrix(0, 0) = 1;
-	rpyRatesMatrix(0, 1) = sin(rpy(0)) * tan(rpy(1));
-	rpyRatesMatrix(0, 2) = cos(rpy(0)) * tan(rpy(1));
+	rpyRatesMatrix(0, 1) = trig.sinRoll * trig.tanPitch;
+	rpyRatesMatrix(0, 2) = trig.cosRoll * trig.tanPitch;
 
-	rpyRatesMatrix(1, 1) = cos(rpy(0));
-	rpyRatesMatrix(1, 2) = -sin(rpy(0));
+	rpyRatesMatrix(1, 1) = trig.cosRoll;
+	rpyRatesMatrix(1, 2) = -trig.sinRoll;
 
-	rpyRatesMatrix(2, 1) = sin(rpy(0)) / cos(rpy(1));
-	rpyRatesMatrix(2, 2) = cos(rpy(0)) / cos(rpy(1));
+	rpyRatesMatrix(2, 1) = trig.sinRoll / trig.cosPitch;
+	rpyRatesMatrix(2, 2) = trig.cosRoll / trig.cosPitch;
 
 	return rpyRatesMatrix.replace(arma::datum::nan, 0);
 }
 
-arma::mat Frames::skew(const arma::vec x)
+arma::vec4 Frames::quaternionFromRpy(const arma::vec3& rpy)
 {
-	arma::mat skewMat = {
+	const AttitudeTrig_t trig = attitudeTrig(rpy);
+	const double sr = trig.sinRoll, cr = trig.cosRoll;
+	const double sp = trig.sinPitch, cp = trig.cosPitch;
+	const double sy = trig.sinYaw, cy = trig.cosYaw;
+	// Same as matrixBody2Enu(), with the (1,2) element orthonormal: cy*sp*cr + sy*sr
+	const arma::mat33 R = {
+							{sy*cp,  cy*cr + sy*sp*sr, -cy*sr + sy*sp*cr},
+							{cy*cp, -sy*cr + cy*sp*sr,  cy*sp*cr + sy*sr},
+							{sp   , -cp*sr           , -cp*cr           }
+						  };
+
+	// Shepperd's method: the largest of the 4 components is computed first, so that there is no division by a small number
+	arma::vec4 q;
+	const double trace = R(0, 0) + R(1, 1) + R(2, 2);
+	if (trace > 0)
+	{
+		const double s = 2 * sqrt(trace + 1);
+		q = { s / 4, (R(2, 1) - R(1, 2)) / s, (R(0, 2) - R(2, 0)) / s, (R(1, 0) - R(0, 1)) / s };
+	}
+	else if ((R(0, 0) > R(1, 1)) && (R(0, 0) > R(2, 2)))
+	{
+		const double s = 2 * sqrt(1 + R(0, 0) - R(1, 1) - R(2, 2));
+		q = { (R(2, 1) - R(1, 2)) / s, s / 4, (R(0, 1) + R(1, 0)) / s, (R(0, 2) + R(2, 0)) / s };
+	}
+	else if (R(1, 1) > R(2, 2))
+	{
+		const double s = 2 * sqrt(1 + R(1, 1) - R(0, 0) - R(2, 2));
+		q = { (R(0, 2) - R(2, 0)) / s, (R(0, 1) + R(1, 0)) / s, s / 4, (R(1, 2) + R(2, 1)) / s };
+	}
+	else
+	{
+		const double s = 2 * sqrt(1 + R(2, 2) - R(0, 0) - R(1, 1));
+		q = { (R(1, 0) - R(0, 1)) / s, (R(0, 2) + R(2, 0)) / s, (R(1, 2) + R(2, 1)) / s, s / 4 };
+	}
+	return q;
+}
+
+arma::vec4 Frames::quaternionPropagate(const arma::vec4& q, const arma::vec3& rotation)
+{
+	// Rotation quaternion [cos(|r|/2), sin(|r|/2) * r/|r|], series up to 4th order below 0.01 rad (error below 1e-17)
+	const double angle2 = rotation(0) * rotation(0) + rotation(1) * rotation(1) + rotation(2) * rotation(2);
+	double dw, scale;
+	if (angle2 < 1e-4)
+	{
+		dw = 1 - angle2 / 8 + angle2 * angle2 / 384;
+		scale = 0.5 - angle2 / 48 + angle2 * angle2 / 3840;
+	}
+	else
+	{
+		const double angle = sqrt(angle2);
+		dw = cos(angle / 2);
+		scale = sin(angle / 2) / angle;
+	}
+	const double dx = rotation(0) * scale, dy = rotation(1) * scale, dz = rotation(2) * scale;
+
+	// q * dq, rotation in Body frame
+	arma::vec4 result = {
+		q(0) * dw - q(1) * dx - q(2) * dy - q(3) * dz,
+		q(0) * dx + q(1) * dw + q(2) * dz - q(3) * dy,
+		q(0) * dy - q(1) * dz + q(2) * dw + q(3) * dx,
+		q(0) * dz + q(1) * dy - q(2) * dx + q(3) * dw
+	};
+	const double norm = sqrt(result(0) * result(0) + result(1) * result(1) + result(2) * result(2) + result(3) * result(3));
+	return result / norm;
+}
+
+arma::mat33 Frames::matrixBody2EnuQuaternion(const arma::vec4& q)
+{
+	const double w = q(0), x = q(1), y = q(2), z = q(3);
+	const arma::mat33 rBody2Enu = {
+							{1 - 2 * (y*y + z*z), 2 * (x*y - w*z)    , 2 * (x*z + w*y)    },
+							{2 * (x*y + w*z)    , 1 - 2 * (x*x + z*z), 2 * (y*z - w*x)    },
+							{2 * (x*z - w*y)    , 2 * (y*z + w*x)    , 1 - 2 * (x*x + y*y)}
+						  };
+	return rBody2Enu;
+}
+
+arma::vec3 Frames::rpyFromMatrixBody2Enu(const arma::mat33& rBody2Enu)
+{
+	// Elements of matrixBody2Enu(): (2,0) = sp, (2,1) = -cp*sr, (2,2) = -cp*cr, (0,0) = sy*cp, (1,0) = cy*cp
+	const double sinPitch = std::min(1.0, std::max(-1.0, rBody2Enu(2, 0)));
+	return { atan2(-rBody2Enu(2, 1), -rBody2Enu(2, 2)), asin(sinPitch), atan2(rBody2Enu(0, 0), rBody2Enu(1, 0)) };
+}
+
+Frames::AttitudeTrig_t Frames::attitudeTrig(const arma::mat33& rBody2Enu)
+{
+	AttitudeTrig_t trig;
+	trig.sinPitch = rBody2Enu(2, 0);
+	trig.cosPitch = sqrt(rBody2Enu(2, 1) * rBody2Enu(2, 1) + rBody2Enu(2, 2) * rBody2Enu(2, 2));
+	trig.tanPitch = trig.sinPitch / trig.cosPitch;
+	trig.sinRoll = -rBody2Enu(2, 1) / trig.cosPitch;
+	trig.cosRoll = -rBody2Enu(2, 2) / trig.cosPitch;
+	trig.sinYaw = rBody2Enu(0, 0) / trig.cosPitch;
+	trig.cosYaw = rBody2Enu(1, 0) / trig.cosPitch;
+	return trig;
+}
+
+arma::mat33 Frames::skew(const arma::vec3& x)
+{
+	const arma::mat33 skewMat = {
 							{0    , -x(2),  x(1)},
 				      		{x(2) ,  0   , -x(0)},
 					  		{-x(1),  x(0),  0   }
@@ -169,9 +354,9 @@ arma::mat Frames::skew(const arma::vec x)
 	return skewMat;
 }
 
-const arma::mat Frames::skewInertialEarth(const double lat)
+arma::mat33 Frames::skewInertialEarth(const double lat)
 {
-	const arma::vec wbn = arma::vec({0, Frames::EARTH_ROTATION * cos(lat), Frames::EARTH_ROTATION * sin(lat)});
+	const arma::vec3 wbn = {0, Frames::EARTH_ROTATION * cos(lat), Frames::EARTH_ROTATION * sin(lat)};
 	return Frames::skew(wbn);
 }
 
@@ -234,3 +419,212 @@ double Frames::gravityCorrectionForComponentZ(double lat, double hei)
 	return glocalCalculated;
 }
 
+std::vector<arma::vec3> Frames::benchmarkSweep(void)
+{
+	// Heights below and above the ellipsoid
+	const double heights[] = { -10000, -100, 0, 100, 1000, 10000, 100000 };
+	std::vector<arma::vec3> llhs;
+	for (int latIndex = 0; latIndex <= 360; latIndex++)
+	{
+		for (int lonIndex = 0; lonIndex < 24; lonIndex++)
+		{
+			for (const double height : heights)
+			{
+				llhs.push_back({ (-90 + latIndex * 0.5) * DEG2RAD, (-180 + lonIndex * 15) * DEG2RAD, height });
+			}
+		}
+	}
+	return llhs;
+}
+
+Frames::GeodeticBenchmark_t Frames::benchmarkEcef2llh(void)
+{
+	GeodeticBenchmark_t results;
+	results.points = 0;
+	for (int method = 0; method < GEODETIC_TOTAL; method++)
+	{
+		results.maxErrorHorizontal[method] = results.maxErrorVertical[method] = results.nsPerConversion[method] = 0;
+	}
+
+	const std::vector<arma::vec3> llhs = benchmarkSweep();
+	std::vector<arma::vec3> ecefs;
+	for (const arma::vec3& llh : llhs)
+	{
+		ecefs.push_back(llh2ecef(llh));
+	}
+	results.points = llhs.size();
+
+	for (int method = 0; method < GEODETIC_TOTAL; method++)
+	{
+		// Errors as distances: along the meridian, along the parallel and along the normal
+		for (size_t point = 0; point < llhs.size(); point++)
+		{
+			const arma::vec3& llh = llhs[point];
+			const arma::vec3 result = ecef2llh(ecefs[point], method);
+			const double N = SEMI_MAJOR_A / sqrt(1 - ECC * ECC * sin(llh(0)) * sin(llh(0)));
+			const double errorNorth = SEMI_MAJOR_A * (result(0) - llh(0));
+			const double errorEast = (N + llh(2)) * cos(llh(0)) * remainder(result(1) - llh(1), 2 * PI);
+			results.maxErrorHorizontal[method] = std::max(results.maxErrorHorizontal[method], sqrt(errorNorth * errorNorth + errorEast * errorEast));
+			results.maxErrorVertical[method] = std::max(results.maxErrorVertical[method], std::abs(result(2) - llh(2)));
+		}
+
+		// Time over the sweep, repeated up to a minimum number of conversions. The sum keeps the conversions from being optimized out.
+		const size_t iterations = std::max((size_t)1, (size_t)1000000 / ecefs.size());
+		volatile double sink = 0;
+		const auto start = std::chrono::steady_clock::now();
+		for (size_t iteration = 0; iteration < iterations; iteration++)
+		{
+			for (const arma::vec3& ecef : ecefs)
+			{
+				sink = sink + ecef2llh(ecef, method)(0);
+			}
+		}
+		const auto stop = std::chrono::steady_clock::now();
+		results.nsPerConversion[method] = std::chrono::duration<double, std::nano>(stop - start).count() / (double)(iterations * ecefs.size());
+	}
+
+	return results;
+}
+
+/* Adapters for dynamic-size vectors */
+arma::vec Frames::llh2ecef(const arma::vec llh)
+{
+	return llh2ecef(arma::vec3(llh));
+}
+
+arma::vec Frames::ecef2llh(const arma::vec ecef)
+{
+	return ecef2llh(arma::vec3(ecef));
+}
+
+arma::vec Frames::ecef2enu(const arma::vec llh, const arma::vec ecef, const arma::vec xyz0)
+{
+	return ecef2enu(arma::vec3(llh), arma::vec3(ecef), arma::vec3(xyz0));
+}
+
+arma::vec Frames::enu2ecef(const arma::vec llh, const arma::vec enu, const arma::vec xyz0)
+{
+	return enu2ecef(arma::vec3(llh), arma::vec3(enu), arma::vec3(xyz0));
+}
+
+arma::mat Frames::matrixEcef2Enu(const arma::vec llh)
+{
+	return matrixEcef2Enu(arma::vec3(llh));
+}
+
+arma::mat Frames::matrixBody2Enu(const arma::vec rpy)
+{
+	return matrixBody2Enu(arma::vec3(rpy));
+}
+
+arma::mat Frames::matrixBody2H(const arma::vec rpy)
+{
+	return matrixBody2H(arma::vec3(rpy));
+}
+
+arma::mat Frames::matrixRateAttitudeDynamics(const arma::vec rpy)
+{
+	return matrixRateAttitudeDynamics(arma::vec3(rpy));
+}
+
+arma::mat Frames::skew(const arma::vec x)
+{
+	return skew(arma::vec3(x));
+}
+
+/*****************************************
+* Methods definition for Class: FrameCache *
+******************************************/
+
+FrameCache& FrameCache::getInstance(void)
+{
+	static FrameCache instance;
+	return instance;
+}
+
+FrameCache::FrameCache()
+{
+	for (AttitudeEntry_t& entry : attitudes)
+	{
+		entry.isValid = false;
+	}
+	for (LatitudeEntry_t& entry : latitudes)
+	{
+		entry.isValid = false;
+	}
+	nextAttitude = 0;
+	nextLatitude = 0;
+}
+
+/* Find attitude entry */
+FrameCache::AttitudeEntry_t& FrameCache::findAttitude(const arma::vec3& rpy)
+{
+	const double key[3] = { rpy(0), rpy(1), rpy(2) };
+	for (AttitudeEntry_t& entry : attitudes)
+	{
+		// Bit by bit, so that e.g. -0 and +0 are different keys, as they may give different matrices
+		if (entry.isValid && (memcmp(entry.rpy, key, sizeof(key)) == 0))
+		{
+			return entry;
+		}
+	}
+
+	AttitudeEntry_t& entry = attitudes[nextAttitude];
+	nextAttitude = (nextAttitude + 1) % FRAME_CACHE_ENTRIES;
+	memcpy(entry.rpy, key, sizeof(key));
+	entry.isValid = true;
+	entry.trig = Frames::attitudeTrig(rpy);
+	entry.isBody2Enu = entry.isBody2H = entry.isRateAttitude = false;
+	return entry;
+}
+
+const arma::mat33& FrameCache::matrixBody2Enu(const arma::vec3& rpy)
+{
+	AttitudeEntry_t& entry = findAttitude(rpy);
+	if (!entry.isBody2Enu)
+	{
+		entry.body2Enu = Frames::matrixBody2Enu(entry.trig);
+		entry.isBody2Enu = true;
+	}
+	return entry.body2Enu;
+}
+
+const arma::mat33& FrameCache::matrixBody2H(const arma::vec3& rpy)
+{
+	AttitudeEntry_t& entry = findAttitude(rpy);
+	if (!entry.isBody2H)
+	{
+		entry.body2H = Frames::matrixBody2H(rpy);
+		entry.isBody2H = true;
+	}
+	return entry.body2H;
+}
+
+const arma::mat33& FrameCache::matrixRateAttitudeDynamics(const arma::vec3& rpy)
+{
+	AttitudeEntry_t& entry = findAttitude(rpy);
+	if (!entry.isRateAttitude)
+	{
+		entry.rateAttitude = Frames::matrixRateAttitudeDynamics(entry.trig);
+		entry.isRateAttitude = true;
+	}
+	return entry.rateAttitude;
+}
+
+const arma::mat33& FrameCache::skewInertialEarth(const double lat)
+{
+	for (const LatitudeEntry_t& entry : latitudes)
+	{
+		if (entry.isValid && (memcmp(&entry.lat, &lat, sizeof(lat)) == 0))
+		{
+			return entry.skewInertialEarth;
+		}
+	}
+
+	LatitudeEntry_t& entry = latitudes[nextLatitude];
+	nextLatitude = (nextLatitude + 1) % FRAME_CACHE_ENTRIES;
+	entry.lat = lat;
+	entry.isValid = true;
+	entry.skewInertialEarth = Frames::skewInertialEarth(lat);
+	return entry.skewInertialEarth;
+}
@@ -15,18 +15,37 @@
 #ifndef FRAMES_HEADER
 #define FRAMES_HEADER
 
+#include <array>
+#include <vector>
 #include <armadillo>
 
 // More compact way to make matrix rotations around XYZ axes.
 #define ROT_RX(angle) Frames::genRotRx(angle)
-#define ROT_RY(angle) arma::shift(arma::shift(ROT_RX(angle),+1,1),+1,0)
-#define ROT_RZ(angle) arma::shift(arma::shift(ROT_RX(angle),-1,1),-1,0)
+#define ROT_RY(angle) Frames::genRotRy(angle)
+#define ROT_RZ(angle) Frames::genRotRz(angle)
 
 /*!
  @brief Frames namespace. This contains the functions to convert between coordinate frames.
  It is intended to be a class of the object whose coordinates we want to handle, since it stores parameters related to that object (GPS, INS, FUSION)
+ Coordinates and matrices are fixed-size (arma::vec3, arma::mat33), held on the stack and passed by reference. The functions taking
+ dynamic-size arma::vec by value are kept as adapters of the fixed-size ones.
 */
 namespace Frames{
+	/* Methods for the conversion from ECEF to geodetic coordinates */
+	enum GeodeticMethod_e {
+		GEODETIC_ITERATIVE,
+		GEODETIC_CLOSED_FORM,
+		GEODETIC_TOTAL
+	};
+
+	/* Results of benchmarkEcef2llh(): points of the sweep, maximum horizontal and vertical errors [m] and time per conversion [ns] of each method */
+	typedef struct GeodeticBenchmark_s {
+		size_t points;
+		double maxErrorHorizontal[GEODETIC_TOTAL];
+		double maxErrorVertical[GEODETIC_TOTAL];
+		double nsPerConversion[GEODETIC_TOTAL];
+	} GeodeticBenchmark_t;
+
 	/*!
 	@brief  LLH to ECEF conversion (WGS84). Reference:
 	Understanding GPS Principles and Applications
@@ -34,7 +53,7 @@ namespace Frames{
 	@param llh: input LLH coordinates to convert to ECEF.
 	@return ECEF coordinates
 	*/
-	arma::vec llh2ecef(const arma::vec llh);
+	arma::vec3 llh2ecef(const arma::vec3& llh);
 	/*!
 	@brief ECEF to LLH conversion (WGS84). Reference:
 	Understanding GPS Principles and Applications
@@ -42,7 +61,22 @@ namespace Frames{
 	@param ecef: input ECEF coordinates to convert to LLH.
 	@return LLH coordinates
 	*/
-	arma::vec ecef2llh(const arma::vec ecef);
+	arma::vec3 ecef2llh(const arma::vec3& ecef);
+	/*!
+	@brief ECEF to LLH conversion (WGS84), closed form: Bowring's formula with a single fixed iteration from the parametric latitude.
+	Reference: B. R. Bowring, "Transformation from spatial to geographical coordinates", Survey Review, 1976.
+	Error below 0.1 mm from -10 km to 100 km of height, poles included. Undefined at the centre of the Earth.
+	@param ecef: input ECEF coordinates to convert to LLH.
+	@return LLH coordinates
+	*/
+	arma::vec3 ecef2llhClosedForm(const arma::vec3& ecef);
+	/*!
+	@brief ECEF to LLH conversion (WGS84) with the selected method.
+	@param ecef: input ECEF coordinates to convert to LLH.
+	@param method: GeodeticMethod_e.
+	@return LLH coordinates
+	*/
+	arma::vec3 ecef2llh(const arma::vec3& ecef, const int method);
 	/*!
 	@brief  ECEF to ENU conversion
 	@param llh: input needed to pefrorm ECEF rotation
@@ -50,7 +84,7 @@ namespace Frames{
 	@param xyz0: input corresponding to 1st ECEF location, i.e. reference to compute ENU.
 	@return ENU coordinates
 	*/
-	arma::vec ecef2enu(const arma::vec llh, const arma::vec ecef, const arma::vec xyz0);
+	arma::vec3 ecef2enu(const arma::vec3& llh, const arma::vec3& ecef, const arma::vec3& xyz0);
 	
 	/*!
 	@brief  ENU to ECEF conversion
@@ -59,28 +93,44 @@ namespace Frames{
 	@param xyz0: input corresponding to 1st ECEF location, i.e. reference to compensate.
 	@return ECEF coordinates
 	*/
-	arma::vec enu2ecef(const arma::vec llh, const arma::vec enu, const arma::vec xyz0);
+	arma::vec3 enu2ecef(const arma::vec3& llh, const arma::vec3& enu, const arma::vec3& xyz0);
 
 	/*! 
 	@brief Generate matrix to rotate from ECEF to ENU
 	@param llh: input llh coordinates.
 	\return 3x3 rotation matrix
 	*/
-	arma::Mat<double> matrixEcef2Enu(const arma::vec llh);
+	arma::mat33 matrixEcef2Enu(const arma::vec3& llh);
+
+	/* Trigonometric terms of the attitude angles, shared by the matrices built from them */
+	typedef struct AttitudeTrig_s {
+		double sinRoll, cosRoll;
+		double sinPitch, cosPitch, tanPitch;
+		double sinYaw, cosYaw;
+	} AttitudeTrig_t;
+
+	/*!
+	@brief Compute the trigonometric terms of the attitude angles.
+	@param rpy: input Roll, Pitch and Yaw 3x1 angles array.
+	@return sines, cosines and tangent of pitch
+	*/
+	AttitudeTrig_t attitudeTrig(const arma::vec3& rpy);
 
 	/*! 
 	@brief Generate matrix to rotate from Body (XYZ) to ENU plane.
 	@param rpy: input Roll, Pitch and Yaw 3x1 angles array.
 	\return 3x3 rotation matrix
 	*/
-	arma::Mat<double> matrixBody2Enu(const arma::vec rpy);
+	arma::mat33 matrixBody2Enu(const arma::vec3& rpy);
+	/*! Generate matrix to rotate from Body (XYZ) to ENU plane from the trigonometric terms of the attitude angles */
+	arma::mat33 matrixBody2Enu(const AttitudeTrig_t& trig);
 
 	/*! 
 	@brief Generate matrix to align to horizontal plane.
 	@param rpy: input Roll, Pitch and Yaw 3x1 angles array.
 	\return 3x3 rotation matrix
 	*/
-	arma::mat matrixBody2H(const arma::vec rpy);
+	arma::mat33 matrixBody2H(const arma::vec3& rpy);
 
 	/*! 
 	@brief Generate matrix to align platform to body
@@ -95,21 +145,48 @@ namespace Frames{
 	@param angle: input angle to use for rotation
 	@return 3x3 rotation matrix
 	*/
-	arma::Mat<double> genRotRx(const float angle);
+	arma::mat33 genRotRx(const float angle);
+	/*! Generate rotation matrix around Y axis, same as shifting the one around X axis one row and one column forward */
+	arma::mat33 genRotRy(const float angle);
+	/*! Generate rotation matrix around Z axis, same as shifting the one around X axis one row and one column backward */
+	arma::mat33 genRotRz(const float angle);
 
 	/*!
 	@brief Generate matrix with attitude angles rates.
 	@param rpy: current attitude angles
 	@return 3x3 rotation matrix
 	*/
-	arma::mat matrixRateAttitudeDynamics(const arma::vec rpy);
+	arma::mat33 matrixRateAttitudeDynamics(const arma::vec3& rpy);
+	/*! Generate matrix with attitude angles rates from the trigonometric terms of the attitude angles */
+	arma::mat33 matrixRateAttitudeDynamics(const AttitudeTrig_t& trig);
+
+	/*!
+	@brief Quaternion [w, x, y, z] of the rotation from Body to ENU given by the attitude angles, i.e. the orthonormal form of matrixBody2Enu().
+	Uses trigonometric functions, only meant for the initialization of the attitude.
+	@param rpy: input Roll, Pitch and Yaw 3x1 angles array.
+	@return 4x1 unit quaternion
+	*/
+	arma::vec4 quaternionFromRpy(const arma::vec3& rpy);
+	/*!
+	@brief Propagate the quaternion with a rotation of the body, e.g. the gyrometer increment over an epoch. Normalized after the rotation.
+	@param q: quaternion from Body to ENU.
+	@param rotation: rotation vector in Body frame [rad], small angles are expanded in series.
+	@return 4x1 unit quaternion
+	*/
+	arma::vec4 quaternionPropagate(const arma::vec4& q, const arma::vec3& rotation);
+	/*! Generate matrix to rotate from Body to ENU from the quaternion, with multiplications only */
+	arma::mat33 matrixBody2EnuQuaternion(const arma::vec4& q);
+	/*! Get the attitude angles (roll, pitch, yaw) of a Body to ENU matrix built from a quaternion */
+	arma::vec3 rpyFromMatrixBody2Enu(const arma::mat33& rBody2Enu);
+	/*! Get the trigonometric terms of the attitude angles from a Body to ENU matrix built from a quaternion, without trigonometric functions */
+	AttitudeTrig_t attitudeTrig(const arma::mat33& rBody2Enu);
 
 	/*!
 	@brief Form skwe matrix.
 	@param x: 3x1 vector of inputs.
 	@return 3x3 skew matrix
 	*/
-	arma::mat skew(const arma::vec x);
+	arma::mat33 skew(const arma::vec3& x);
 
 	/*!
 	@brief Adjust yaw to be within [0,360] (in radians).
@@ -127,7 +204,7 @@ namespace Frames{
 	@param lat: latitude angle.
 	@return skew symmetric matrix.
 	*/
-	const arma::mat skewInertialEarth(const double lat);
+	arma::mat33 skewInertialEarth(const double lat);
 	
 	/*!
 	@brief Correct for gravity in Z direction following [Farrel and Barth 1999]
@@ -138,6 +215,31 @@ namespace Frames{
 	/*! Correct gravity for zenith component */
 	double gravityCorrectionForComponentZ(double lat, double hei);
 
+	/*!
+	@brief Points of the geodetic benchmarks: every 0.5 degrees of latitude from pole to pole, every 15 degrees of longitude,
+	and heights from -10 km to 100 km.
+	@return LLH coordinates [rad, rad, m].
+	*/
+	std::vector<arma::vec3> benchmarkSweep(void);
+
+	/*!
+	@brief Benchmark the conversions from ECEF to LLH on a sweep of latitude (poles included), longitude and height (-10 km to 100 km).
+	Each point is converted to ECEF with llh2ecef() and back with each method, the errors are the distances to the original point.
+	@return errors and timings of each method.
+	*/
+	GeodeticBenchmark_t benchmarkEcef2llh(void);
+
+	/* Adapters for dynamic-size vectors: copy to the fixed-size type and call the functions above */
+	arma::vec llh2ecef(const arma::vec llh);
+	arma::vec ecef2llh(const arma::vec ecef);
+	arma::vec ecef2enu(const arma::vec llh, const arma::vec ecef, const arma::vec xyz0);
+	arma::vec enu2ecef(const arma::vec llh, const arma::vec enu, const arma::vec xyz0);
+	arma::mat matrixEcef2Enu(const arma::vec llh);
+	arma::mat matrixBody2Enu(const arma::vec rpy);
+	arma::mat matrixBody2H(const arma::vec rpy);
+	arma::mat matrixRateAttitudeDynamics(const arma::vec rpy);
+	arma::mat skew(const arma::vec x);
+
 	// Constants
 	const double SEMI_MAJOR_A 		= 6378137;
 	const double SEMI_MINOR_B 		= 6356752.3142;
@@ -154,4 +256,56 @@ namespace Frames{
 	const double ADJUST_ANGLE_MARGIN = 0.001;
 };
 
+/* Entries of the frame cache for each kind of key: attitudes and latitudes used within an epoch (INS, fusion after the correction, gravity correction) */
+constexpr int FRAME_CACHE_ENTRIES = 4;
+
+/*!
+ @brief Cache of the frame matrices built from an attitude or a latitude. On each epoch the same matrices are needed by several stages:
+ e.g. Body to ENU by the gravity correction, INS mechanization, KF state transition and fusion correction. Each matrix is computed once for
+ its key and rebuilt when the key changes, i.e. when the attitude is updated within the epoch. Keys are compared bit by bit, so a cached
+ matrix is exactly the one computed by the Frames function. The references returned are valid until the next call.
+ \class FrameCache
+*/
+class FrameCache {
+public:
+	/*! Singleton class, function returns static object from private constructor */
+	static FrameCache& getInstance(void);
+	FrameCache(const FrameCache&) = delete;
+	FrameCache& operator=(const FrameCache&) = delete;
+
+	/*! Body to ENU rotation matrix, see Frames::matrixBody2Enu() */
+	const arma::mat33& matrixBody2Enu(const arma::vec3& rpy);
+	/*! Alignment to the horizontal plane, see Frames::matrixBody2H() */
+	const arma::mat33& matrixBody2H(const arma::vec3& rpy);
+	/*! Matrix with attitude angles rates, see Frames::matrixRateAttitudeDynamics() */
+	const arma::mat33& matrixRateAttitudeDynamics(const arma::vec3& rpy);
+	/*! Skew matrix of Earth frame relative to inertial frame, see Frames::skewInertialEarth() */
+	const arma::mat33& skewInertialEarth(const double lat);
+
+private:
+	/* Matrices of an attitude, built on first use */
+	typedef struct AttitudeEntry_s {
+		double rpy[3];
+		bool isValid;
+		Frames::AttitudeTrig_t trig;
+		bool isBody2Enu, isBody2H, isRateAttitude;
+		arma::mat33 body2Enu, body2H, rateAttitude;
+	} AttitudeEntry_t;
+	/* Matrix of a latitude */
+	typedef struct LatitudeEntry_s {
+		double lat;
+		bool isValid;
+		arma::mat33 skewInertialEarth;
+	} LatitudeEntry_t;
+
+	FrameCache();
+	/*! Find the entry of an attitude, replacing the oldest one if missing */
+	AttitudeEntry_t& findAttitude(const arma::vec3& rpy);
+
+	std::array<AttitudeEntry_t, FRAME_CACHE_ENTRIES> attitudes;
+	std::array<LatitudeEntry_t, FRAME_CACHE_ENTRIES> latitudes;
+	int nextAttitude;
+	int nextLatitude;
+};
+
 #endif // FRAMES_HEADER
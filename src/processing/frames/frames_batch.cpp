@@ -0,0 +1,631 @@
+/*!
+ @file frames_batch.cpp
+ @author Nicolas Padron
+ @brief In this file the processes of frames_batch.h are implemented.
+*/
+
+#include <math.h>
+#include <string.h>
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <vector>
+#include <processing/frames/frames.h>
+#include <processing/frames/frames_batch.h>
+
+// SIMD kernels are built with the target attribute of GCC/Clang, so that the rest of the program does not need -mavx2
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define FRAMES_BATCH_X86
+#include <immintrin.h>
+#define FRAMES_TARGET_AVX2 __attribute__((target("avx2")))
+#define FRAMES_TARGET_AVX512 __attribute__((target("avx512f")))
+#endif
+
+/* WGS84 terms of the conversions, products computed once as in the scalar functions */
+static const double BATCH_A = Frames::SEMI_MAJOR_A;
+static const double BATCH_B = Frames::SEMI_MINOR_B;
+static const double BATCH_E2 = Frames::ECC * Frames::ECC;
+static const double BATCH_ONE_MINUS_E2 = 1 - Frames::ECC * Frames::ECC;
+static const double BATCH_EP2_B = Frames::ECC_SEC * Frames::ECC_SEC * Frames::SEMI_MINOR_B;
+static const double BATCH_E2_A = Frames::ECC * Frames::ECC * Frames::SEMI_MAJOR_A;
+static const double BATCH_A2 = Frames::SEMI_MAJOR_A * Frames::SEMI_MAJOR_A;
+
+/* Detect kernel: the widest one supported */
+static Frames::BatchKernel_e detectBatchKernel(void)
+{
+	for (int kernel = Frames::BATCH_KERNEL_TOTAL - 1; kernel > Frames::BATCH_KERNEL_SCALAR; kernel--)
+	{
+		if (Frames::isBatchKernelSupported((Frames::BatchKernel_e)kernel))
+		{
+			return (Frames::BatchKernel_e)kernel;
+		}
+	}
+	return Frames::BATCH_KERNEL_SCALAR;
+}
+
+static Frames::BatchKernel_e batchKernel = detectBatchKernel();
+
+/*****************************************
+*	Scalar kernels: arithmetic of a chunk, trigonometric terms given
+*****************************************/
+
+static void llh2ecefScalar(const double* sinLat, const double* cosLat, const double* sinLon, const double* cosLon, const double* hei, double* x, double* y, double* z, size_t count)
+{
+	for (size_t i = 0; i < count; i++)
+	{
+		const double N = BATCH_A / sqrt(1 - BATCH_E2 * sinLat[i] * sinLat[i]);
+		const double r = (N + hei[i]) * cosLat[i];
+		x[i] = r * cosLon[i];
+		y[i] = r * sinLon[i];
+		z[i] = (N * BATCH_ONE_MINUS_E2 + hei[i]) * sinLat[i];
+	}
+}
+
+/* Bowring with a single iteration, as ecef2llhClosedForm(). Outputs the terms of tan(lat) and the height. */
+static void ecef2llhScalar(const double* x, const double* y, const double* z, double* num, double* den, double* hei, size_t count)
+{
+	for (size_t i = 0; i < count; i++)
+	{
+		const double p = sqrt(x[i] * x[i] + y[i] * y[i]);
+		const double az = BATCH_A * z[i];
+		const double bp = BATCH_B * p;
+		const double rBeta = sqrt(az * az + bp * bp);
+		const double sinBeta = az / rBeta;
+		const double cosBeta = bp / rBeta;
+		num[i] = z[i] + BATCH_EP2_B * sinBeta * sinBeta * sinBeta;
+		den[i] = p - BATCH_E2_A * cosBeta * cosBeta * cosBeta;
+		const double rPhi = sqrt(num[i] * num[i] + den[i] * den[i]);
+		const double sinPhi = num[i] / rPhi;
+		const double cosPhi = den[i] / rPhi;
+		const double N = BATCH_A / sqrt(1 - BATCH_E2 * sinPhi * sinPhi);
+		hei[i] = p * cosPhi + z[i] * sinPhi - BATCH_A2 / N;
+	}
+}
+
+static void ecef2enuScalar(const double* sinLat, const double* cosLat, const double* sinLon, const double* cosLon, const double* x, const double* y, const double* z, const double* xyz0, double* e, double* n, double* u, size_t count)
+{
+	for (size_t i = 0; i < count; i++)
+	{
+		const double dx = x[i] - xyz0[0];
+		const double dy = y[i] - xyz0[1];
+		const double dz = z[i] - xyz0[2];
+		const double t = cosLon[i] * dx + sinLon[i] * dy;
+		e[i] = cosLon[i] * dy - sinLon[i] * dx;
+		n[i] = cosLat[i] * dz - sinLat[i] * t;
+		u[i] = cosLat[i] * t + sinLat[i] * dz;
+	}
+}
+
+static void enu2ecefScalar(const double* sinLat, const double* cosLat, const double* sinLon, const double* cosLon, const double* e, const double* n, const double* u, const double* xyz0, double* x, double* y, double* z, size_t count)
+{
+	for (size_t i = 0; i < count; i++)
+	{
+		const double t = cosLat[i] * u[i] - sinLat[i] * n[i];
+		x[i] = (cosLon[i] * t - sinLon[i] * e[i]) + xyz0[0];
+		y[i] = (sinLon[i] * t + cosLon[i] * e[i]) + xyz0[1];
+		z[i] = (cosLat[i] * n[i] + sinLat[i] * u[i]) + xyz0[2];
+	}
+}
+
+#ifdef FRAMES_BATCH_X86
+/*****************************************
+*	AVX2 kernels: 4 points per iteration, the rest with the scalar kernel.
+*	The upper halves of the registers are cleared on exit, since libm and the rest of the program use SSE (no -mavx).
+*****************************************/
+
+FRAMES_TARGET_AVX2
+static void llh2ecefAvx2(const double* sinLat, const double* cosLat, const double* sinLon, const double* cosLon, const double* hei, double* x, double* y, double* z, size_t count)
+{
+	const __m256d one = _mm256_set1_pd(1);
+	const __m256d a = _mm256_set1_pd(BATCH_A);
+	const __m256d e2 = _mm256_set1_pd(BATCH_E2);
+	const __m256d oneMinusE2 = _mm256_set1_pd(BATCH_ONE_MINUS_E2);
+	size_t i = 0;
+	for (; i + 4 <= count; i += 4)
+	{
+		const __m256d sLat = _mm256_loadu_pd(sinLat + i);
+		const __m256d h = _mm256_loadu_pd(hei + i);
+		const __m256d N = _mm256_div_pd(a, _mm256_sqrt_pd(_mm256_sub_pd(one, _mm256_mul_pd(_mm256_mul_pd(e2, sLat), sLat))));
+		const __m256d r = _mm256_mul_pd(_mm256_add_pd(N, h), _mm256_loadu_pd(cosLat + i));
+		_mm256_storeu_pd(x + i, _mm256_mul_pd(r, _mm256_loadu_pd(cosLon + i)));
+		_mm256_storeu_pd(y + i, _mm256_mul_pd(r, _mm256_loadu_pd(sinLon + i)));
+		_mm256_storeu_pd(z + i, _mm256_mul_pd(_mm256_add_pd(_mm256_mul_pd(N, oneMinusE2), h), sLat));
+	}
+	_mm256_zeroupper();
+	llh2ecefScalar(sinLat + i, cosLat + i, sinLon + i, cosLon + i, hei + i, x + i, y + i, z + i, count - i);
+}
+
+FRAMES_TARGET_AVX2
+static void ecef2llhAvx2(const double* x, const double* y, const double* z, double* num, double* den, double* hei, size_t count)
+{
+	const __m256d one = _mm256_set1_pd(1);
+	const __m256d a = _mm256_set1_pd(BATCH_A);
+	const __m256d b = _mm256_set1_pd(BATCH_B);
+	const __m256d e2 = _mm256_set1_pd(BATCH_E2);
+	const __m256d ep2b = _mm256_set1_pd(BATCH_EP2_B);
+	const __m256d e2a = _mm256_set1_pd(BATCH_E2_A);
+	const __m256d a2 = _mm256_set1_pd(BATCH_A2);
+	size_t i = 0;
+	for (; i + 4 <= count; i += 4)
+	{
+		const __m256d vx = _mm256_loadu_pd(x + i);
+		const __m256d vy = _mm256_loadu_pd(y + i);
+		const __m256d vz = _mm256_loadu_pd(z + i);
+		const __m256d p = _mm256_sqrt_pd(_mm256_add_pd(_mm256_mul_pd(vx, vx), _mm256_mul_pd(vy, vy)));
+		const __m256d az = _mm256_mul_pd(a, vz);
+		const __m256d bp = _mm256_mul_pd(b, p);
+		const __m256d rBeta = _mm256_sqrt_pd(_mm256_add_pd(_mm256_mul_pd(az, az), _mm256_mul_pd(bp, bp)));
+		const __m256d sinBeta = _mm256_div_pd(az, rBeta);
+		const __m256d cosBeta = _mm256_div_pd(bp, rBeta);
+		const __m256d vNum = _mm256_add_pd(vz, _mm256_mul_pd(_mm256_mul_pd(_mm256_mul_pd(ep2b, sinBeta), sinBeta), sinBeta));
+		const __m256d vDen = _mm256_sub_pd(p, _mm256_mul_pd(_mm256_mul_pd(_mm256_mul_pd(e2a, cosBeta), cosBeta), cosBeta));
+		const __m256d rPhi = _mm256_sqrt_pd(_mm256_add_pd(_mm256_mul_pd(vNum, vNum), _mm256_mul_pd(vDen, vDen)));
+		const __m256d sinPhi = _mm256_div_pd(vNum, rPhi);
+		const __m256d cosPhi = _mm256_div_pd(vDen, rPhi);
+		const __m256d N = _mm256_div_pd(a, _mm256_sqrt_pd(_mm256_sub_pd(one, _mm256_mul_pd(_mm256_mul_pd(e2, sinPhi), sinPhi))));
+		_mm256_storeu_pd(num + i, vNum);
+		_mm256_storeu_pd(den + i, vDen);
+		_mm256_storeu_pd(hei + i, _mm256_sub_pd(_mm256_add_pd(_mm256_mul_pd(p, cosPhi), _mm256_mul_pd(vz, sinPhi)), _mm256_div_pd(a2, N)));
+	}
+	_mm256_zeroupper();
+	ecef2llhScalar(x + i, y + i, z + i, num + i, den + i, hei + i, count - i);
+}
+
+FRAMES_TARGET_AVX2
+static void ecef2enuAvx2(const double* sinLat, const double* cosLat, const double* sinLon, const double* cosLon, const double* x, const double* y, const double* z, const double* xyz0, double* e, double* n, double* u, size_t count)
+{
+	const __m256d x0 = _mm256_set1_pd(xyz0[0]);
+	const __m256d y0 = _mm256_set1_pd(xyz0[1]);
+	const __m256d z0 = _mm256_set1_pd(xyz0[2]);
+	size_t i = 0;
+	for (; i + 4 <= count; i += 4)
+	{
+		const __m256d sLat = _mm256_loadu_pd(sinLat + i);
+		const __m256d cLat = _mm256_loadu_pd(cosLat + i);
+		const __m256d sLon = _mm256_loadu_pd(sinLon + i);
+		const __m256d cLon = _mm256_loadu_pd(cosLon + i);
+		const __m256d dx = _mm256_sub_pd(_mm256_loadu_pd(x + i), x0);
+		const __m256d dy = _mm256_sub_pd(_mm256_loadu_pd(y + i), y0);
+		const __m256d dz = _mm256_sub_pd(_mm256_loadu_pd(z + i), z0);
+		const __m256d t = _mm256_add_pd(_mm256_mul_pd(cLon, dx), _mm256_mul_pd(sLon, dy));
+		_mm256_storeu_pd(e + i, _mm256_sub_pd(_mm256_mul_pd(cLon, dy), _mm256_mul_pd(sLon, dx)));
+		_mm256_storeu_pd(n + i, _mm256_sub_pd(_mm256_mul_pd(cLat, dz), _mm256_mul_pd(sLat, t)));
+		_mm256_storeu_pd(u + i, _mm256_add_pd(_mm256_mul_pd(cLat, t), _mm256_mul_pd(sLat, dz)));
+	}
+	_mm256_zeroupper();
+	ecef2enuScalar(sinLat + i, cosLat + i, sinLon + i, cosLon + i, x + i, y + i, z + i, xyz0, e + i, n + i, u + i, count - i);
+}
+
+FRAMES_TARGET_AVX2
+static void enu2ecefAvx2(const double* sinLat, const double* cosLat, const double* sinLon, const double* cosLon, const double* e, const double* n, const double* u, const double* xyz0, double* x, double* y, double* z, size_t count)
+{
+	const __m256d x0 = _mm256_set1_pd(xyz0[0]);
+	const __m256d y0 = _mm256_set1_pd(xyz0[1]);
+	const __m256d z0 = _mm256_set1_pd(xyz0[2]);
+	size_t i = 0;
+	for (; i + 4 <= count; i += 4)
+	{
+		const __m256d sLat = _mm256_loadu_pd(sinLat + i);
+		const __m256d cLat = _mm256_loadu_pd(cosLat + i);
+		const __m256d sLon = _mm256_loadu_pd(sinLon + i);
+		const __m256d cLon = _mm256_loadu_pd(cosLon + i);
+		const __m256d ve = _mm256_loadu_pd(e + i);
+		const __m256d vn = _mm256_loadu_pd(n + i);
+		const __m256d vu = _mm256_loadu_pd(u + i);
+		const __m256d t = _mm256_sub_pd(_mm256_mul_pd(cLat, vu), _mm256_mul_pd(sLat, vn));
+		_mm256_storeu_pd(x + i, _mm256_add_pd(_mm256_sub_pd(_mm256_mul_pd(cLon, t), _mm256_mul_pd(sLon, ve)), x0));
+		_mm256_storeu_pd(y + i, _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(sLon, t), _mm256_mul_pd(cLon, ve)), y0));
+		_mm256_storeu_pd(z + i, _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(cLat, vn), _mm256_mul_pd(sLat, vu)), z0));
+	}
+	_mm256_zeroupper();
+	enu2ecefScalar(sinLat + i, cosLat + i, sinLon + i, cosLon + i, e + i, n + i, u + i, xyz0, x + i, y + i, z + i, count - i);
+}
+
+/*****************************************
+*	AVX-512 kernels: 8 points per iteration, the rest with the scalar kernel
+*****************************************/
+
+/* Square root of all the lanes. The zero-masked form gives the same result as _mm512_sqrt_pd(), whose undefined passthrough
+ register GCC 12 reports as maybe uninitialized in optimized builds. */
+FRAMES_TARGET_AVX512
+static inline __m512d sqrtAvx512(const __m512d x)
+{
+	return _mm512_maskz_sqrt_pd((__mmask8)0xFF, x);
+}
+
+FRAMES_TARGET_AVX512
+static void llh2ecefAvx512(const double* sinLat, const double* cosLat, const double* sinLon, const double* cosLon, const double* hei, double* x, double* y, double* z, size_t count)
+{
+	const __m512d one = _mm512_set1_pd(1);
+	const __m512d a = _mm512_set1_pd(BATCH_A);
+	const __m512d e2 = _mm512_set1_pd(BATCH_E2);
+	const __m512d oneMinusE2 = _mm512_set1_pd(BATCH_ONE_MINUS_E2);
+	size_t i = 0;
+	for (; i + 8 <= count; i += 8)
+	{
+		const __m512d sLat = _mm512_loadu_pd(sinLat + i);
+		const __m512d h = _mm512_loadu_pd(hei + i);
+		const __m512d N = _mm512_div_pd(a, sqrtAvx512(_mm512_sub_pd(one, _mm512_mul_pd(_mm512_mul_pd(e2, sLat), sLat))));
+		const __m512d r = _mm512_mul_pd(_mm512_add_pd(N, h), _mm512_loadu_pd(cosLat + i));
+		_mm512_storeu_pd(x + i, _mm512_mul_pd(r, _mm512_loadu_pd(cosLon + i)));
+		_mm512_storeu_pd(y + i, _mm512_mul_pd(r, _mm512_loadu_pd(sinLon + i)));
+		_mm512_storeu_pd(z + i, _mm512_mul_pd(_mm512_add_pd(_mm512_mul_pd(N, oneMinusE2), h), sLat));
+	}
+	_mm256_zeroupper();
+	llh2ecefScalar(sinLat + i, cosLat + i, sinLon + i, cosLon + i, hei + i, x + i, y + i, z + i, count - i);
+}
+
+FRAMES_TARGET_AVX512
+static void ecef2llhAvx512(const double* x, const double* y, const double* z, double* num, double* den, double* hei, size_t count)
+{
+	const __m512d one = _mm512_set1_pd(1);
+	const __m512d a = _mm512_set1_pd(BATCH_A);
+	const __m512d b = _mm512_set1_pd(BATCH_B);
+	const __m512d e2 = _mm512_set1_pd(BATCH_E2);
+	const __m512d ep2b = _mm512_set1_pd(BATCH_EP2_B);
+	const __m512d e2a = _mm512_set1_pd(BATCH_E2_A);
+	const __m512d a2 = _mm512_set1_pd(BATCH_A2);
+	size_t i = 0;
+	for (; i + 8 <= count; i += 8)
+	{
+		const __m512d vx = _mm512_loadu_pd(x + i);
+		const __m512d vy = _mm512_loadu_pd(y + i);
+		const __m512d vz = _mm512_loadu_pd(z + i);
+		const __m512d p = sqrtAvx512(_mm512_add_pd(_mm512_mul_pd(vx, vx), _mm512_mul_pd(vy, vy)));
+		const __m512d az = _mm512_mul_pd(a, vz);
+		const __m512d bp = _mm512_mul_pd(b, p);
+		const __m512d rBeta = sqrtAvx512(_mm512_add_pd(_mm512_mul_pd(az, az), _mm512_mul_pd(bp, bp)));
+		const __m512d sinBeta = _mm512_div_pd(az, rBeta);
+		const __m512d cosBeta = _mm512_div_pd(bp, rBeta);
+		const __m512d vNum = _mm512_add_pd(vz, _mm512_mul_pd(_mm512_mul_pd(_mm512_mul_pd(ep2b, sinBeta), sinBeta), sinBeta));
+		const __m512d vDen = _mm512_sub_pd(p, _mm512_mul_pd(_mm512_mul_pd(_mm512_mul_pd(e2a, cosBeta), cosBeta), cosBeta));
+		const __m512d rPhi = sqrtAvx512(_mm512_add_pd(_mm512_mul_pd(vNum, vNum), _mm512_mul_pd(vDen, vDen)));
+		const __m512d sinPhi = _mm512_div_pd(vNum, rPhi);
+		const __m512d cosPhi = _mm512_div_pd(vDen, rPhi);
+		const __m512d N = _mm512_div_pd(a, sqrtAvx512(_mm512_sub_pd(one, _mm512_mul_pd(_mm512_mul_pd(e2, sinPhi), sinPhi))));
+		_mm512_storeu_pd(num + i, vNum);
+		_mm512_storeu_pd(den + i, vDen);
+		_mm512_storeu_pd(hei + i, _mm512_sub_pd(_mm512_add_pd(_mm512_mul_pd(p, cosPhi), _mm512_mul_pd(vz, sinPhi)), _mm512_div_pd(a2, N)));
+	}
+	_mm256_zeroupper();
+	ecef2llhScalar(x + i, y + i, z + i, num + i, den + i, hei + i, count - i);
+}
+
+FRAMES_TARGET_AVX512
+static void ecef2enuAvx512(const double* sinLat, const double* cosLat, const double* sinLon, const double* cosLon, const double* x, const double* y, const double* z, const double* xyz0, double* e, double* n, double* u, size_t count)
+{
+	const __m512d x0 = _mm512_set1_pd(xyz0[0]);
+	const __m512d y0 = _mm512_set1_pd(xyz0[1]);
+	const __m512d z0 = _mm512_set1_pd(xyz0[2]);
+	size_t i = 0;
+	for (; i + 8 <= count; i += 8)
+	{
+		const __m512d sLat = _mm512_loadu_pd(sinLat + i);
+		const __m512d cLat = _mm512_loadu_pd(cosLat + i);
+		const __m512d sLon = _mm512_loadu_pd(sinLon + i);
+		const __m512d cLon = _mm512_loadu_pd(cosLon + i);
+		const __m512d dx = _mm512_sub_pd(_mm512_loadu_pd(x + i), x0);
+		const __m512d dy = _mm512_sub_pd(_mm512_loadu_pd(y + i), y0);
+		const __m512d dz = _mm512_sub_pd(_mm512_loadu_pd(z + i), z0);
+		const __m512d t = _mm512_add_pd(_mm512_mul_pd(cLon, dx), _mm512_mul_pd(sLon, dy));
+		_mm512_storeu_pd(e + i, _mm512_sub_pd(_mm512_mul_pd(cLon, dy), _mm512_mul_pd(sLon, dx)));
+		_mm512_storeu_pd(n + i, _mm512_sub_pd(_mm512_mul_pd(cLat, dz), _mm512_mul_pd(sLat, t)));
+		_mm512_storeu_pd(u + i, _mm512_add_pd(_mm512_mul_pd(cLat, t), _mm512_mul_pd(sLat, dz)));
+	}
+	_mm256_zeroupper();
+	ecef2enuScalar(sinLat + i, cosLat + i, sinLon + i, cosLon + i, x + i, y + i, z + i, xyz0, e + i, n + i, u + i, count - i);
+}
+
+FRAMES_TARGET_AVX512
+static void enu2ecefAvx512(const double* sinLat, const double* cosLat, const double* sinLon, const double* cosLon, const double* e, const double* n, const double* u, const double* xyz0, double* x, double* y, double* z, size_t count)
+{
+	const __m512d x0 = _mm512_set1_pd(xyz0[0]);
+	const __m512d y0 = _mm512_set1_pd(xyz0[1]);
+	const __m512d z0 = _mm512_set1_pd(xyz0[2]);
+	size_t i = 0;
+	for (; i + 8 <= count; i += 8)
+	{
+		const __m512d sLat = _mm512_loadu_pd(sinLat + i);
+		const __m512d cLat = _mm512_loadu_pd(cosLat + i);
+		const __m512d sLon = _mm512_loadu_pd(sinLon + i);
+		const __m512d cLon = _mm512_loadu_pd(cosLon + i);
+		const __m512d ve = _mm512_loadu_pd(e + i);
+		const __m512d vn = _mm512_loadu_pd(n + i);
+		const __m512d vu = _mm512_loadu_pd(u + i);
+		const __m512d t = _mm512_sub_pd(_mm512_mul_pd(cLat, vu), _mm512_mul_pd(sLat, vn));
+		_mm512_storeu_pd(x + i, _mm512_add_pd(_mm512_sub_pd(_mm512_mul_pd(cLon, t), _mm512_mul_pd(sLon, ve)), x0));
+		_mm512_storeu_pd(y + i, _mm512_add_pd(_mm512_add_pd(_mm512_mul_pd(sLon, t), _mm512_mul_pd(cLon, ve)), y0));
+		_mm512_storeu_pd(z + i, _mm512_add_pd(_mm512_add_pd(_mm512_mul_pd(cLat, vn), _mm512_mul_pd(sLat, vu)), z0));
+	}
+	_mm256_zeroupper();
+	enu2ecefScalar(sinLat + i, cosLat + i, sinLon + i, cosLon + i, e + i, n + i, u + i, xyz0, x + i, y + i, z + i, count - i);
+}
+#endif // FRAMES_BATCH_X86
+
+/* Trigonometric terms of a chunk of angles */
+static void sinCosChunk(const double* angle, double* sinAngle, double* cosAngle, size_t count)
+{
+	for (size_t i = 0; i < count; i++)
+	{
+		sinAngle[i] = sin(angle[i]);
+		cosAngle[i] = cos(angle[i]);
+	}
+}
+
+/*****************************************
+*	Kernel selection
+*****************************************/
+
+Frames::BatchKernel_e Frames::getBatchKernel(void)
+{
+	return batchKernel;
+}
+
+bool Frames::setBatchKernel(BatchKernel_e kernel)
+{
+	if (!isBatchKernelSupported(kernel))
+	{
+		return false;
+	}
+	batchKernel = kernel;
+	return true;
+}
+
+bool Frames::isBatchKernelSupported(BatchKernel_e kernel)
+{
+	switch (kernel)
+	{
+	case BATCH_KERNEL_SCALAR:
+		return true;
+#ifdef FRAMES_BATCH_X86
+	// Called during static initialization as well, before the CPU features are initialized by the runtime
+	case BATCH_KERNEL_AVX2:
+		__builtin_cpu_init();
+		return __builtin_cpu_supports("avx2");
+	case BATCH_KERNEL_AVX512:
+		__builtin_cpu_init();
+		return __builtin_cpu_supports("avx512f");
+#endif
+	default:
+		return false;
+	}
+}
+
+const char* Frames::getBatchKernelName(BatchKernel_e kernel)
+{
+	switch (kernel)
+	{
+	case BATCH_KERNEL_SCALAR:
+		return "scalar";
+	case BATCH_KERNEL_AVX2:
+		return "AVX2";
+	case BATCH_KERNEL_AVX512:
+		return "AVX-512";
+	default:
+		return "unknown";
+	}
+}
+
+/*****************************************
+*	Batch conversions: by chunks, trigonometric terms first and then the kernel
+*****************************************/
+
+void Frames::llh2ecefBatch(const double* lat, const double* lon, const double* hei, double* x, double* y, double* z, size_t count)
+{
+	double sinLat[FRAMES_BATCH_CHUNK], cosLat[FRAMES_BATCH_CHUNK], sinLon[FRAMES_BATCH_CHUNK], cosLon[FRAMES_BATCH_CHUNK];
+	for (size_t start = 0; start < count; start += FRAMES_BATCH_CHUNK)
+	{
+		const size_t chunk = std::min(FRAMES_BATCH_CHUNK, count - start);
+		sinCosChunk(lat + start, sinLat, cosLat, chunk);
+		sinCosChunk(lon + start, sinLon, cosLon, chunk);
+		switch (batchKernel)
+		{
+#ifdef FRAMES_BATCH_X86
+		case BATCH_KERNEL_AVX512:
+			llh2ecefAvx512(sinLat, cosLat, sinLon, cosLon, hei + start, x + start, y + start, z + start, chunk);
+			break;
+		case BATCH_KERNEL_AVX2:
+			llh2ecefAvx2(sinLat, cosLat, sinLon, cosLon, hei + start, x + start, y + start, z + start, chunk);
+			break;
+#endif
+		default:
+			llh2ecefScalar(sinLat, cosLat, sinLon, cosLon, hei + start, x + start, y + start, z + start, chunk);
+			break;
+		}
+	}
+}
+
+void Frames::ecef2llhBatch(const double* x, const double* y, const double* z, double* lat, double* lon, double* hei, size_t count)
+{
+	double num[FRAMES_BATCH_CHUNK], den[FRAMES_BATCH_CHUNK];
+	for (size_t start = 0; start < count; start += FRAMES_BATCH_CHUNK)
+	{
+		const size_t chunk = std::min(FRAMES_BATCH_CHUNK, count - start);
+		switch (batchKernel)
+		{
+#ifdef FRAMES_BATCH_X86
+		case BATCH_KERNEL_AVX512:
+			ecef2llhAvx512(x + start, y + start, z + start, num, den, hei + start, chunk);
+			break;
+		case BATCH_KERNEL_AVX2:
+			ecef2llhAvx2(x + start, y + start, z + start, num, den, hei + start, chunk);
+			break;
+#endif
+		default:
+			ecef2llhScalar(x + start, y + start, z + start, num, den, hei + start, chunk);
+			break;
+		}
+		for (size_t i = 0; i < chunk; i++)
+		{
+			lat[start + i] = atan2(num[i], den[i]);
+			lon[start + i] = atan2(y[start + i], x[start + i]);
+		}
+	}
+}
+
+void Frames::ecef2enuBatch(const double* lat, const double* lon, const double* x, const double* y, const double* z, const arma::vec3& xyz0, double* e, double* n, double* u, size_t count)
+{
+	double sinLat[FRAMES_BATCH_CHUNK], cosLat[FRAMES_BATCH_CHUNK], sinLon[FRAMES_BATCH_CHUNK], cosLon[FRAMES_BATCH_CHUNK];
+	const double ref[3] = { xyz0(0), xyz0(1), xyz0(2) };
+	for (size_t start = 0; start < count; start += FRAMES_BATCH_CHUNK)
+	{
+		const size_t chunk = std::min(FRAMES_BATCH_CHUNK, count - start);
+		sinCosChunk(lat + start, sinLat, cosLat, chunk);
+		sinCosChunk(lon + start, sinLon, cosLon, chunk);
+		switch (batchKernel)
+		{
+#ifdef FRAMES_BATCH_X86
+		case BATCH_KERNEL_AVX512:
+			ecef2enuAvx512(sinLat, cosLat, sinLon, cosLon, x + start, y + start, z + start, ref, e + start, n + start, u + start, chunk);
+			break;
+		case BATCH_KERNEL_AVX2:
+			ecef2enuAvx2(sinLat, cosLat, sinLon, cosLon, x + start, y + start, z + start, ref, e + start, n + start, u + start, chunk);
+			break;
+#endif
+		default:
+			ecef2enuScalar(sinLat, cosLat, sinLon, cosLon, x + start, y + start, z + start, ref, e + start, n + start, u + start, chunk);
+			break;
+		}
+	}
+}
+
+void Frames::enu2ecefBatch(const double* lat, const double* lon, const double* e, const double* n, const double* u, const arma::vec3& xyz0, double* x, double* y, double* z, size_t count)
+{
+	double sinLat[FRAMES_BATCH_CHUNK], cosLat[FRAMES_BATCH_CHUNK], sinLon[FRAMES_BATCH_CHUNK], cosLon[FRAMES_BATCH_CHUNK];
+	const double ref[3] = { xyz0(0), xyz0(1), xyz0(2) };
+	for (size_t start = 0; start < count; start += FRAMES_BATCH_CHUNK)
+	{
+		const size_t chunk = std::min(FRAMES_BATCH_CHUNK, count - start);
+		sinCosChunk(lat + start, sinLat, cosLat, chunk);
+		sinCosChunk(lon + start, sinLon, cosLon, chunk);
+		switch (batchKernel)
+		{
+#ifdef FRAMES_BATCH_X86
+		case BATCH_KERNEL_AVX512:
+			enu2ecefAvx512(sinLat, cosLat, sinLon, cosLon, e + start, n + start, u + start, ref, x + start, y + start, z + start, chunk);
+			break;
+		case BATCH_KERNEL_AVX2:
+			enu2ecefAvx2(sinLat, cosLat, sinLon, cosLon, e + start, n + start, u + start, ref, x + start, y + start, z + start, chunk);
+			break;
+#endif
+		default:
+			enu2ecefScalar(sinLat, cosLat, sinLon, cosLon, e + start, n + start, u + start, ref, x + start, y + start, z + start, chunk);
+			break;
+		}
+	}
+}
+
+/*****************************************
+*	Benchmark
+*****************************************/
+
+Frames::BatchBenchmark_t Frames::benchmarkBatch(void)
+{
+	BatchBenchmark_t results;
+	const std::vector<arma::vec3> sweep = benchmarkSweep();
+	const size_t count = sweep.size();
+	results.points = count;
+
+	// Points as structure of arrays, and results of each conversion: ECEF, ENU, ECEF back and LLH back
+	std::array<std::vector<double>, 3> llh;
+	for (int component = 0; component < 3; component++)
+	{
+		llh[component].resize(count);
+		for (size_t point = 0; point < count; point++)
+		{
+			llh[component][point] = sweep[point](component);
+		}
+	}
+	auto allocate = [count](std::array<std::vector<double>, 3>* results)
+	{
+		for (int set = 0; set < 4; set++)
+		{
+			for (std::vector<double>& component : results[set])
+			{
+				component.assign(count, 0);
+			}
+		}
+	};
+	auto convertBatch = [count, &llh](std::array<std::vector<double>, 3>* results)
+	{
+		std::array<std::vector<double>, 3>& ecef = results[0];
+		std::array<std::vector<double>, 3>& enu = results[1];
+		std::array<std::vector<double>, 3>& ecefBack = results[2];
+		std::array<std::vector<double>, 3>& llhBack = results[3];
+		llh2ecefBatch(llh[0].data(), llh[1].data(), llh[2].data(), ecef[0].data(), ecef[1].data(), ecef[2].data(), count);
+		const arma::vec3 ecefRef = { ecef[0][0], ecef[1][0], ecef[2][0] };
+		ecef2enuBatch(llh[0].data(), llh[1].data(), ecef[0].data(), ecef[1].data(), ecef[2].data(), ecefRef, enu[0].data(), enu[1].data(), enu[2].data(), count);
+		enu2ecefBatch(llh[0].data(), llh[1].data(), enu[0].data(), enu[1].data(), enu[2].data(), ecefRef, ecefBack[0].data(), ecefBack[1].data(), ecefBack[2].data(), count);
+		ecef2llhBatch(ecefBack[0].data(), ecefBack[1].data(), ecefBack[2].data(), llhBack[0].data(), llhBack[1].data(), llhBack[2].data(), count);
+	};
+
+	// Batch round trip with the kernel in use
+	std::array<std::vector<double>, 3> batch[4];
+	allocate(batch);
+	auto start = std::chrono::steady_clock::now();
+	convertBatch(batch);
+	results.nsPerPointBatch = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / (double)count;
+
+	// Same round trip point by point with the Frames functions
+	std::array<std::vector<double>, 3> frames[4];
+	allocate(frames);
+	const arma::vec3 ecefRef = { batch[0][0][0], batch[0][1][0], batch[0][2][0] };
+	start = std::chrono::steady_clock::now();
+	for (size_t point = 0; point < count; point++)
+	{
+		const arma::vec3& pointLlh = sweep[point];
+		const arma::vec3 pointEcef = llh2ecef(pointLlh);
+		const arma::vec3 pointEnu = ecef2enu(pointLlh, pointEcef, ecefRef);
+		const arma::vec3 pointEcefBack = enu2ecef(pointLlh, pointEnu, ecefRef);
+		const arma::vec3 pointLlhBack = ecef2llhClosedForm(pointEcefBack);
+		for (int component = 0; component < 3; component++)
+		{
+			frames[0][component][point] = pointEcef(component);
+			frames[1][component][point] = pointEnu(component);
+			frames[2][component][point] = pointEcefBack(component);
+			frames[3][component][point] = pointLlhBack(component);
+		}
+	}
+	results.nsPerPointFrames = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / (double)count;
+
+	// Largest difference to the Frames functions in meters
+	results.maxDifference = 0;
+	for (int set = 0; set < 4; set++)
+	{
+		for (int component = 0; component < 3; component++)
+		{
+			const double scale = ((set == 3) && (component < 2)) ? SEMI_MAJOR_A : 1;
+			for (size_t point = 0; point < count; point++)
+			{
+				results.maxDifference = std::max(results.maxDifference, std::abs(batch[set][component][point] - frames[set][component][point]) * scale);
+			}
+		}
+	}
+
+	// Every SIMD kernel supported must give the same bits as the scalar one
+	const BatchKernel_e kernel = getBatchKernel();
+	std::array<std::vector<double>, 3> scalar[4], simd[4];
+	allocate(scalar);
+	allocate(simd);
+	(void)setBatchKernel(BATCH_KERNEL_SCALAR);
+	convertBatch(scalar);
+	results.isSameAsScalar = true;
+	for (int otherKernel = BATCH_KERNEL_SCALAR; otherKernel < BATCH_KERNEL_TOTAL; otherKernel++)
+	{
+		results.isKernelChecked[otherKernel] = (otherKernel != BATCH_KERNEL_SCALAR) && setBatchKernel((BatchKernel_e)otherKernel);
+		if (!results.isKernelChecked[otherKernel])
+		{
+			continue;
+		}
+		convertBatch(simd);
+		for (int set = 0; set < 4; set++)
+		{
+			for (int component = 0; component < 3; component++)
+			{
+				results.isSameAsScalar = results.isSameAsScalar && (memcmp(simd[set][component].data(), scalar[set][component].data(), count * sizeof(double)) == 0);
+			}
+		}
+	}
+	(void)setBatchKernel(kernel);
+	return results;
+}
@@ -0,0 +1,101 @@
+/*!
+ @file frames_batch.h
+ @author Nicolas Padron
+* @brief Description: This file contains the batch versions of the geodetic conversions of frames.h:
+*				- LLH to ECEF and viceversa
+*				- ECEF to ENU and viceversa
+*			Points are given as structure of arrays (one array per component) and converted by chunks.
+*			The trigonometric functions are called per point (libm), the rest of each conversion runs in SIMD kernels
+*			(AVX2, AVX-512) chosen at runtime, with a scalar fallback. All the kernels give the same bits, since they do
+*			the same operations in the same order without FMA.
+*/
+
+#ifndef FRAMES_BATCH_HEADER
+#define FRAMES_BATCH_HEADER
+
+#include <stddef.h>
+#include <armadillo>
+
+/* Points converted at once by each kernel call, the intermediate values of a chunk stay in the stack */
+constexpr size_t FRAMES_BATCH_CHUNK = 256;
+
+namespace Frames{
+	/* SIMD kernels of the batch conversions */
+	enum BatchKernel_e {
+		BATCH_KERNEL_SCALAR,
+		BATCH_KERNEL_AVX2,
+		BATCH_KERNEL_AVX512,
+		BATCH_KERNEL_TOTAL
+	};
+
+	/*!
+	@brief Get the kernel used by the batch conversions. By default the widest one supported by the CPU.
+	@return BatchKernel_e
+	*/
+	BatchKernel_e getBatchKernel(void);
+	/*!
+	@brief Force the kernel used by the batch conversions, e.g. to compare them.
+	@param kernel: BatchKernel_e.
+	@return false if not supported by this build or CPU, the kernel is then not changed.
+	*/
+	bool setBatchKernel(BatchKernel_e kernel);
+	/*! Check if a kernel is supported by this build and CPU */
+	bool isBatchKernelSupported(BatchKernel_e kernel);
+	/*! Get the name of a kernel */
+	const char* getBatchKernelName(BatchKernel_e kernel);
+
+	/* Results of benchmarkBatch(): points of the sweep, time per point [ns] of the batch round trip and of the same one with the Frames functions,
+	largest difference between them [m] (latitude and longitude scaled by the semi-major axis), kernels compared with the scalar one and
+	if all of them gave the same bits */
+	typedef struct BatchBenchmark_s {
+		size_t points;
+		double nsPerPointBatch;
+		double nsPerPointFrames;
+		double maxDifference;
+		bool isKernelChecked[BATCH_KERNEL_TOTAL];
+		bool isSameAsScalar;
+	} BatchBenchmark_t;
+
+	/*!
+	@brief Benchmark the batch conversions on the sweep of benchmarkSweep(): LLH to ECEF, ECEF to ENU with origin at the 1st point, and back to ECEF
+	and LLH. Checked against the same round trip point by point with the Frames functions, and every SIMD kernel supported against the scalar one.
+	The kernel in use is restored at the end.
+	@return timings and checks.
+	*/
+	BatchBenchmark_t benchmarkBatch(void);
+
+	/*!
+	@brief LLH to ECEF conversion of count points. Same as llh2ecef().
+	@param lat, lon, hei: input LLH coordinates [rad, rad, m].
+	@param x, y, z: output ECEF coordinates [m].
+	@param count: number of points.
+	*/
+	void llh2ecefBatch(const double* lat, const double* lon, const double* hei, double* x, double* y, double* z, size_t count);
+	/*!
+	@brief ECEF to LLH conversion of count points. Same as ecef2llhClosedForm().
+	@param x, y, z: input ECEF coordinates [m].
+	@param lat, lon, hei: output LLH coordinates [rad, rad, m].
+	@param count: number of points.
+	*/
+	void ecef2llhBatch(const double* x, const double* y, const double* z, double* lat, double* lon, double* hei, size_t count);
+	/*!
+	@brief ECEF to ENU conversion of count points, each one rotated at its own latitude and longitude. Same as ecef2enu().
+	@param lat, lon: LLH coordinates of the points [rad].
+	@param x, y, z: input ECEF coordinates [m].
+	@param xyz0: ECEF reference, origin of the ENU frame.
+	@param e, n, u: output ENU coordinates [m].
+	@param count: number of points.
+	*/
+	void ecef2enuBatch(const double* lat, const double* lon, const double* x, const double* y, const double* z, const arma::vec3& xyz0, double* e, double* n, double* u, size_t count);
+	/*!
+	@brief ENU to ECEF conversion of count points, each one rotated at its own latitude and longitude. Same as enu2ecef().
+	@param lat, lon: LLH coordinates of the points [rad].
+	@param e, n, u: input ENU coordinates [m].
+	@param xyz0: ECEF reference, origin of the ENU frame.
+	@param x, y, z: output ECEF coordinates [m].
+	@param count: number of points.
+	*/
+	void enu2ecefBatch(const double* lat, const double* lon, const double* e, const double* n, const double* u, const arma::vec3& xyz0, double* x, double* y, double* z, size_t count);
+};
+
+#endif // FRAMES_BATCH_HEADER
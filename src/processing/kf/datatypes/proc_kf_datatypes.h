@@ -16,6 +16,34 @@ enum ConstantsKF_e {
 	KF_STD_LENGTH = 15, // 3 zeros, 3 acc bias, 3 acc noise bias, 3 gyro bias, 3 gyro noise bias, 3 DOPs
 };
 
+/* Block of the state vector known at compile time: first index, length and last index */
+template <int First, int Length>
+struct KfBlock {
+	enum { first = First, length = Length, last = First + Length - 1 };
+	/*! Span of the block, to index Armadillo vectors and matrices */
+	static arma::span span(void) { return arma::span(first, last); }
+};
+
+/* Blocks of the state vector */
+namespace KfStates {
+	typedef KfBlock<0, 3> Position;
+	typedef KfBlock<3, 3> Velocity;
+	typedef KfBlock<6, 3> Attitude;
+	typedef KfBlock<9, 3> AccBias;
+	typedef KfBlock<12, 3> GyrBias;
+};
+
+/* Kalman Filter engines */
+enum KfEngine_e {
+	KF_ENGINE_ARMADILLO,	// Dynamic-size Armadillo matrices
+	KF_ENGINE_FIXED,		// Fixed-size arrays, KfEngine
+	KF_ENGINE_BLOCK,		// Fixed-size arrays skipping the zero blocks of F and G, KfBlockEngine
+	KF_ENGINE_REDUCED,		// Armadillo matrices of the selected states only
+	KF_ENGINE_PACKED,		// Fixed-size arrays, packed covariance and scalar updates, KfPackedEngine
+	KF_ENGINE_UD,			// Fixed-size float arrays, covariance factorized as U * D * U', KfUdEngine
+	KF_ENGINE_TOTAL
+};
+
 // Kalman Filter variables data structure
 typedef struct DatatypesKF_t {
 	arma::Mat<double> F = arma::zeros(KF_STATE_VECTOR_LENGTH, KF_STATE_VECTOR_LENGTH);
@@ -33,6 +61,12 @@ typedef struct DatatypesKF_t {
 	arma::vec         I = arma::zeros(KF_MEASUREMENTS_VECTOR_LENGTH, 1);
 	arma::vec		  v = arma::zeros(KF_STATE_VECTOR_LENGTH,1);
 	arma::vec		  w = arma::zeros(KF_MEASUREMENTS_VECTOR_LENGTH,1);
+	// Epochs processed by the filter, one per navigation epoch (-n IMU samples)
+	size_t epochs = 0;
+	// Steady-state gain statistics: switches to it, switches back to the full propagation and epochs run with it
+	size_t steadyEntries = 0;
+	size_t steadyExits = 0;
+	size_t steadyEpochs = 0;
 } DatatypesKF_t;
 
 #endif // PROC_KF_DATATYPES_HEADER
\ No newline at end of file
@@ -0,0 +1,1169 @@
+/*!
+ @file proc_kf_engine.h
+ @author Nicolas Padron
+ @brief Description: This file contains the fixed-size Kalman Filter engine, templated on the number of states N, of measurements M
+ and on the scalar type. It runs the same discretization, prediction and update as KalmanFilter does with Armadillo, but on
+ arrays held in the object: no heap temporaries and no BLAS dispatch. The kernels loop over compile-time bounds, so that the
+ compiler unrolls and vectorizes them for the sizes used.
+ KfBlockEngine runs the covariance prediction by blocks of states and skips the blocks of F and G known to be zero.
+ KfPackedEngine keeps the covariance as its packed upper triangle and updates with one scalar measurement at a time.
+ KfUdEngine keeps the covariance factorized as U * D * U', which stays positive definite in float.
+ KfEngineHandle holds any of them behind one interface, so that a filter only holds the engine selected.
+ Matrices coming from Armadillo are read in its column-major order.
+*/
+
+#ifndef PROC_KF_ENGINE_HEADER
+#define PROC_KF_ENGINE_HEADER
+
+#include <stddef.h>
+#include <math.h>
+
+/* With GCC on x86 Linux the hot functions are also built for AVX2, the clone is picked at load time from the CPU (the build targets
+the baseline instruction set). Without FMA, all the clones give the same bits. */
+#if defined(__GNUC__) && !defined(__clang__) && (defined(__x86_64__) || defined(__i386__)) && defined(__linux__)
+#define KF_ENGINE_CLONES __attribute__((target_clones("avx2", "default")))
+#else
+#define KF_ENGINE_CLONES
+#endif
+
+/* Kernels built from many template instances, inlined whatever their size so that they get the instruction set of the clone calling them */
+#if defined(__GNUC__)
+#define KF_ENGINE_INLINE inline __attribute__((always_inline))
+#else
+#define KF_ENGINE_INLINE inline
+#endif
+
+/* Small-matrix kernels on arrays of compile-time size */
+namespace KfKernels {
+	/* c = a * b. Each row of c is accumulated in a local row along the columns of b, so that it is vectorized. */
+	template <size_t R, size_t K, size_t C, typename Scalar>
+	inline void multiply(const Scalar (&a)[R][K], const Scalar (&b)[K][C], Scalar (&c)[R][C])
+	{
+		for (size_t i = 0; i < R; i++)
+		{
+			Scalar row[C];
+			for (size_t j = 0; j < C; j++)
+			{
+				row[j] = 0;
+			}
+			for (size_t k = 0; k < K; k++)
+			{
+				const Scalar aik = a[i][k];
+				for (size_t j = 0; j < C; j++)
+				{
+					row[j] += aik * b[k][j];
+				}
+			}
+			for (size_t j = 0; j < C; j++)
+			{
+				c[i][j] = row[j];
+			}
+		}
+	}
+
+	/* c = a * b', through the transpose of b so that the inner loop runs along rows as in multiply() */
+	template <size_t R, size_t K, size_t C, typename Scalar>
+	inline void multiplyTransposed(const Scalar (&a)[R][K], const Scalar (&b)[C][K], Scalar (&c)[R][C])
+	{
+		Scalar bt[K][C];
+		for (size_t j = 0; j < C; j++)
+		{
+			for (size_t k = 0; k < K; k++)
+			{
+				bt[k][j] = b[j][k];
+			}
+		}
+		multiply(a, bt, c);
+	}
+
+	/* y = a * x */
+	template <size_t R, size_t C, typename Scalar>
+	inline void multiply(const Scalar (&a)[R][C], const Scalar (&x)[C], Scalar (&y)[R])
+	{
+		for (size_t i = 0; i < R; i++)
+		{
+			Scalar sum = 0;
+			for (size_t j = 0; j < C; j++)
+			{
+				sum += a[i][j] * x[j];
+			}
+			y[i] = sum;
+		}
+	}
+
+	/* Inverse by Gauss-Jordan elimination with partial pivoting. Returns false if singular, ai is then not valid. */
+	template <size_t M, typename Scalar>
+	inline bool invert(const Scalar (&a)[M][M], Scalar (&ai)[M][M])
+	{
+		Scalar work[M][M];
+		for (size_t i = 0; i < M; i++)
+		{
+			for (size_t j = 0; j < M; j++)
+			{
+				work[i][j] = a[i][j];
+				ai[i][j] = (i == j) ? 1 : 0;
+			}
+		}
+		for (size_t col = 0; col < M; col++)
+		{
+			size_t pivot = col;
+			for (size_t i = col + 1; i < M; i++)
+			{
+				if (fabs(work[i][col]) > fabs(work[pivot][col]))
+				{
+					pivot = i;
+				}
+			}
+			if (work[pivot][col] == 0)
+			{
+				return false;
+			}
+			if (pivot != col)
+			{
+				for (size_t j = 0; j < M; j++)
+				{
+					Scalar tmp = work[col][j]; work[col][j] = work[pivot][j]; work[pivot][j] = tmp;
+					tmp = ai[col][j]; ai[col][j] = ai[pivot][j]; ai[pivot][j] = tmp;
+				}
+			}
+			const Scalar scale = 1 / work[col][col];
+			for (size_t j = 0; j < M; j++)
+			{
+				work[col][j] *= scale;
+				ai[col][j] *= scale;
+			}
+			for (size_t i = 0; i < M; i++)
+			{
+				if (i != col)
+				{
+					const Scalar factor = work[i][col];
+					for (size_t j = 0; j < M; j++)
+					{
+						work[i][j] -= factor * work[col][j];
+						ai[i][j] -= factor * ai[col][j];
+					}
+				}
+			}
+		}
+		return true;
+	}
+
+	/* c = a * b, a being made of L x L blocks of which only those set in blocks can be non-zero. Same as multiply() skipping the
+	zero blocks of a: the other terms are summed in the same order, so that the results have the same bits. */
+	template <size_t L, size_t R, size_t K, size_t C, typename Scalar>
+	inline void multiplyBlocks(const Scalar (&a)[R][K], const bool (&blocks)[R / L][K / L], const Scalar (&b)[K][C], Scalar (&c)[R][C])
+	{
+		for (size_t i = 0; i < R; i++)
+		{
+			Scalar row[C];
+			for (size_t j = 0; j < C; j++)
+			{
+				row[j] = 0;
+			}
+			for (size_t bk = 0; bk < K / L; bk++)
+			{
+				if (blocks[i / L][bk])
+				{
+					for (size_t k = bk * L; k < (bk + 1) * L; k++)
+					{
+						const Scalar aik = a[i][k];
+						for (size_t j = 0; j < C; j++)
+						{
+							row[j] += aik * b[k][j];
+						}
+					}
+				}
+			}
+			for (size_t j = 0; j < C; j++)
+			{
+				c[i][j] = row[j];
+			}
+		}
+	}
+
+	/* c += a * b' on the L x L blocks at (i0, k0) of a, (j0, k0) of b and (i0, j0) of c, same order as multiplyTransposed() */
+	template <size_t L, size_t N, typename Scalar>
+	inline void multiplyAddBlockTransposed(const Scalar (&a)[N][N], const Scalar (&b)[N][N], Scalar (&c)[N][N], const size_t i0, const size_t k0, const size_t j0)
+	{
+		for (size_t i = i0; i < i0 + L; i++)
+		{
+			for (size_t k = k0; k < k0 + L; k++)
+			{
+				const Scalar aik = a[i][k];
+				for (size_t j = j0; j < j0 + L; j++)
+				{
+					c[i][j] += aik * b[j][k];
+				}
+			}
+		}
+	}
+
+	/* at = a' */
+	template <size_t R, size_t C, typename Scalar>
+	inline void transpose(const Scalar (&a)[R][C], Scalar (&at)[C][R])
+	{
+		for (size_t i = 0; i < R; i++)
+		{
+			for (size_t j = 0; j < C; j++)
+			{
+				at[j][i] = a[i][j];
+			}
+		}
+	}
+
+	/* Rows I to N - 1 of the upper triangle of c = a * bt, packed row by row from c. Each row is an instance, so that it runs on
+	compile-time bounds and stays in registers: from the first column of the AVX2 vector (4 doubles) holding the diagonal, the
+	few products left of the diagonal are dropped. */
+	template <size_t I, size_t N, typename Scalar>
+	struct UpperRows {
+		static KF_ENGINE_INLINE void multiply(const Scalar (&a)[N][N], const Scalar (&bt)[N][N], Scalar* c)
+		{
+			enum { FIRST = I & ~(size_t)3 };
+			Scalar row[N - FIRST];
+			for (size_t j = 0; j < N - FIRST; j++)
+			{
+				row[j] = 0;
+			}
+			for (size_t k = 0; k < N; k++)
+			{
+				const Scalar aik = a[I][k];
+				for (size_t j = 0; j < N - FIRST; j++)
+				{
+					row[j] += aik * bt[k][FIRST + j];
+				}
+			}
+			for (size_t j = I - FIRST; j < N - FIRST; j++)
+			{
+				*c++ = row[j];
+			}
+			UpperRows<I + 1, N, Scalar>::multiply(a, bt, c);
+		}
+	};
+	template <size_t N, typename Scalar>
+	struct UpperRows<N, N, Scalar> {
+		static KF_ENGINE_INLINE void multiply(const Scalar (&)[N][N], const Scalar (&)[N][N], Scalar*) {}
+	};
+
+	/* Upper triangle of c = a * b', packed row by row */
+	template <size_t N, typename Scalar>
+	KF_ENGINE_INLINE void multiplyTransposedUpper(const Scalar (&a)[N][N], const Scalar (&b)[N][N], Scalar* c)
+	{
+		Scalar bt[N][N];
+		transpose(b, bt);
+		UpperRows<0, N, Scalar>::multiply(a, bt, c);
+	}
+
+	/* Set an array to zero */
+	template <size_t R, size_t C, typename Scalar>
+	inline void zero(Scalar (&a)[R][C])
+	{
+		for (size_t i = 0; i < R; i++)
+		{
+			for (size_t j = 0; j < C; j++)
+			{
+				a[i][j] = 0;
+			}
+		}
+	}
+
+	/* Copy a column-major R x C matrix (e.g. arma::mat memory) to an array */
+	template <size_t R, size_t C, typename Scalar>
+	inline void loadColumnMajor(const double* src, Scalar (&dst)[R][C])
+	{
+		for (size_t j = 0; j < C; j++)
+		{
+			for (size_t i = 0; i < R; i++)
+			{
+				dst[i][j] = (Scalar)src[j * R + i];
+			}
+		}
+	}
+
+	/* Copy an array to a column-major R x C matrix */
+	template <size_t R, size_t C, typename Scalar>
+	inline void storeColumnMajor(const Scalar (&src)[R][C], double* dst)
+	{
+		for (size_t j = 0; j < C; j++)
+		{
+			for (size_t i = 0; i < R; i++)
+			{
+				dst[j * R + i] = (double)src[i][j];
+			}
+		}
+	}
+};
+
+/*!
+ @brief Kalman Filter with N states and M measurements of fixed size.
+ The model (F, G, process noise STDs) is discretized every epoch, the observation matrix and measurement noise are set at start.
+ \class KfEngine
+*/
+template <size_t N, size_t M, typename Scalar = double>
+class KfEngine {
+public:
+	/*! Constructor: zero state, covariance and matrices */
+	KfEngine()
+	{
+		for (size_t i = 0; i < N; i++)
+		{
+			X[i] = 0;
+			for (size_t j = 0; j < N; j++)
+			{
+				Fk[i][j] = Qk[i][j] = S[i][j] = 0;
+			}
+			for (size_t j = 0; j < M; j++)
+			{
+				K[i][j] = H[j][i] = 0;
+			}
+		}
+		for (size_t i = 0; i < M; i++)
+		{
+			I[i] = r[i] = 0;
+		}
+	}
+
+	/*! Set the covariance from a column-major N x N matrix (e.g. arma::mat memory) */
+	void setCovariance(const double* s)
+	{
+		KfKernels::loadColumnMajor(s, S);
+	}
+
+	/*!
+	@brief Set the observation model.
+	@param h: column-major M x N observation matrix.
+	@param variances: M measurement noise variances, diagonal of R.
+	*/
+	void setObservation(const double* h, const double* variances)
+	{
+		KfKernels::loadColumnMajor(h, H);
+		for (size_t i = 0; i < M; i++)
+		{
+			r[i] = (Scalar)variances[i];
+		}
+	}
+
+	/*!
+	@brief Discretize the continuous model of the epoch, Fk = I + F * dt and Qk = G * Q * G' * dt, and filter the states out:
+	the columns of Fk and Qk are multiplied by the mask of the states.
+	@param f: column-major N x N state transition matrix.
+	@param g: column-major N x N noise control matrix.
+	@param stds: N process noise STDs, the diagonal of Q is their square.
+	@param dt: sampling period.
+	@param mask: 1 for the states selected, 0 for the states filtered out.
+	*/
+	KF_ENGINE_CLONES void discretize(const double* f, const double* g, const double* stds, const Scalar dt, const Scalar (&mask)[N])
+	{
+		Scalar G[N][N];
+		Scalar GQ[N][N];
+		loadModel(f, g, stds, dt, mask, G, GQ);
+		KfKernels::multiplyTransposed(GQ, G, Qk);
+		scaleNoise(dt, mask);
+	}
+
+	/*! Multiply the state by its mask */
+	void maskState(const Scalar (&mask)[N])
+	{
+		for (size_t i = 0; i < N; i++)
+		{
+			X[i] *= mask[i];
+		}
+	}
+
+	/*! Predict: X = Fk * X, S = Fk * S * Fk' + Qk */
+	KF_ENGINE_CLONES void predict(void)
+	{
+		Scalar Xp[N];
+		Scalar FS[N][N];
+		KfKernels::multiply(Fk, X, Xp);
+		KfKernels::multiply(Fk, S, FS);
+		KfKernels::multiplyTransposed(FS, Fk, S);
+		for (size_t i = 0; i < N; i++)
+		{
+			X[i] = Xp[i];
+			for (size_t j = 0; j < N; j++)
+			{
+				S[i][j] += Qk[i][j];
+			}
+		}
+	}
+
+	/*!
+	@brief Update with the observation differences.
+	@return false if the innovation covariance is singular, the filter is then not updated.
+	*/
+	KF_ENGINE_CLONES bool update(const double* diffs)
+	{
+		// Innovation
+		Scalar HX[M];
+		KfKernels::multiply(H, X, HX);
+		for (size_t i = 0; i < M; i++)
+		{
+			I[i] = (Scalar)diffs[i] - HX[i];
+		}
+
+		// Innovation variance: V = H * S * H' + R
+		Scalar HS[M][N];
+		Scalar V[M][M];
+		Scalar Vi[M][M];
+		KfKernels::multiply(H, S, HS);
+		KfKernels::multiplyTransposed(HS, H, V);
+		for (size_t i = 0; i < M; i++)
+		{
+			V[i][i] += r[i];
+		}
+		if (!KfKernels::invert(V, Vi))
+		{
+			return false;
+		}
+
+		// Kalman gain: K = S * H' * V^-1
+		Scalar SH[N][M];
+		KfKernels::multiplyTransposed(S, H, SH);
+		KfKernels::multiply(SH, Vi, K);
+
+		// State and covariance: X += K * I, S = (I - K * H) * S
+		Scalar KI[N];
+		Scalar IKH[N][N];
+		Scalar Sp[N][N];
+		KfKernels::multiply(K, I, KI);
+		KfKernels::multiply(K, H, IKH);
+		for (size_t i = 0; i < N; i++)
+		{
+			X[i] += KI[i];
+			for (size_t j = 0; j < N; j++)
+			{
+				IKH[i][j] = ((i == j) ? 1 : 0) - IKH[i][j];
+			}
+		}
+		KfKernels::multiply(IKH, S, Sp);
+		for (size_t i = 0; i < N; i++)
+		{
+			for (size_t j = 0; j < N; j++)
+			{
+				S[i][j] = Sp[i][j];
+			}
+		}
+		return true;
+	}
+
+	/*! Get the state */
+	const Scalar (&getState(void) const)[N] { return X; }
+	/*! Get the covariance */
+	const Scalar (&getCovariance(void) const)[N][N] { return S; }
+
+	/*! Copy the state to N doubles */
+	void storeState(double* dst) const
+	{
+		for (size_t i = 0; i < N; i++)
+		{
+			dst[i] = (double)X[i];
+		}
+	}
+	/*! Copy the covariance to a column-major N x N matrix */
+	void storeCovariance(double* dst) const
+	{
+		KfKernels::storeColumnMajor(S, dst);
+	}
+
+	/*! Multiplications of a prediction, discretize() and predict(): G * Q * G', Fk * S * Fk', G * Q and Fk * X */
+	static size_t getMultiplyAdds(void) { return 3 * N * N * N + 2 * N * N; }
+
+protected:
+	/* Form Fk = (I + F * dt) masked by columns, G and G * Q from the column-major model */
+	inline void loadModel(const double* f, const double* g, const double* stds, const Scalar dt, const Scalar (&mask)[N], Scalar (&G)[N][N], Scalar (&GQ)[N][N])
+	{
+		for (size_t j = 0; j < N; j++)
+		{
+			const Scalar q = (Scalar)(stds[j] * stds[j]);
+			for (size_t i = 0; i < N; i++)
+			{
+				Fk[i][j] = (((i == j) ? 1 : 0) + (Scalar)f[j * N + i] * dt) * mask[j];
+				G[i][j] = (Scalar)g[j * N + i];
+				GQ[i][j] = G[i][j] * q;
+			}
+		}
+	}
+
+	/* Qk = G * Q * G' * dt, masked by columns */
+	inline void scaleNoise(const Scalar dt, const Scalar (&mask)[N])
+	{
+		for (size_t i = 0; i < N; i++)
+		{
+			for (size_t j = 0; j < N; j++)
+			{
+				Qk[i][j] = Qk[i][j] * dt * mask[j];
+			}
+		}
+	}
+
+	// Discrete model
+	Scalar Fk[N][N], Qk[N][N];
+	// Observation matrix and diagonal of R
+	Scalar H[M][N], r[M];
+	// State, covariance, gain and innovation
+	Scalar X[N], S[N][N], K[N][M], I[M];
+};
+
+/*!
+ @brief Kalman Filter of KfEngine whose states are grouped in blocks of L states, with only some blocks of F and G non-zero.
+ The blocks which can be non-zero are set at start (diagonal blocks of F always are, since Fk = I + F * dt), then discretize() and
+ predict() go block by block and skip the products of zero blocks: Qk is the sum of the products G(bi,bk) * Q(bk) * G(bj,bk)' of
+ the non-zero blocks of G, and Fk * S * Fk' only takes the non-zero blocks of Fk. The terms skipped are exact zeros and the others
+ are summed in the same order as KfEngine, so that both engines give the same bits.
+ \class KfBlockEngine
+*/
+template <size_t N, size_t M, size_t L, typename Scalar = double>
+class KfBlockEngine : public KfEngine<N, M, Scalar> {
+	static_assert(N % L == 0, "The states must be a whole number of blocks");
+public:
+	/*! Constructor: only the diagonal blocks of F non-zero, no block of G */
+	KfBlockEngine()
+	{
+		for (size_t bi = 0; bi < B; bi++)
+		{
+			for (size_t bj = 0; bj < B; bj++)
+			{
+				blocksF[bi][bj] = (bi == bj);
+				blocksG[bi][bj] = false;
+			}
+		}
+	}
+
+	/*! Set the block of F at the rows of block Row and columns of block Col as non-zero. Blocks have first and length (KfBlock). */
+	template <class Row, class Col>
+	void setTransitionBlock(void)
+	{
+		static_assert(Row::length == L && Col::length == L && Row::first % L == 0 && Col::first % L == 0, "Not a block of the engine");
+		blocksF[Row::first / L][Col::first / L] = true;
+	}
+
+	/*! Set the block of G at the rows of block Row and columns of block Col as non-zero */
+	template <class Row, class Col>
+	void setNoiseBlock(void)
+	{
+		static_assert(Row::length == L && Col::length == L && Row::first % L == 0 && Col::first % L == 0, "Not a block of the engine");
+		blocksG[Row::first / L][Col::first / L] = true;
+	}
+
+	/*! Same as KfEngine::discretize(), Qk by the non-zero blocks of G */
+	KF_ENGINE_CLONES void discretize(const double* f, const double* g, const double* stds, const Scalar dt, const Scalar (&mask)[N])
+	{
+		Scalar G[N][N];
+		Scalar GQ[N][N];
+		this->loadModel(f, g, stds, dt, mask, G, GQ);
+		KfKernels::zero(this->Qk);
+		for (size_t bi = 0; bi < B; bi++)
+		{
+			for (size_t bj = 0; bj < B; bj++)
+			{
+				for (size_t bk = 0; bk < B; bk++)
+				{
+					if (blocksG[bi][bk] && blocksG[bj][bk])
+					{
+						KfKernels::multiplyAddBlockTransposed<L>(GQ, G, this->Qk, bi * L, bk * L, bj * L);
+					}
+				}
+			}
+		}
+		this->scaleNoise(dt, mask);
+	}
+
+	/*! Same as KfEngine::predict(), Fk * S * Fk' by the non-zero blocks of Fk */
+	KF_ENGINE_CLONES void predict(void)
+	{
+		Scalar Xp[N];
+		Scalar FS[N][N];
+		KfKernels::multiply(this->Fk, this->X, Xp);
+
+		// FS * Fk' through its transpose Fk * FS': same products, summed in the same order
+		Scalar FSt[N][N];
+		Scalar St[N][N];
+		KfKernels::multiplyBlocks<L>(this->Fk, blocksF, this->S, FS);
+		KfKernels::transpose(FS, FSt);
+		KfKernels::multiplyBlocks<L>(this->Fk, blocksF, FSt, St);
+		for (size_t i = 0; i < N; i++)
+		{
+			this->X[i] = Xp[i];
+			for (size_t j = 0; j < N; j++)
+			{
+				this->S[i][j] = St[j][i] + this->Qk[i][j];
+			}
+		}
+	}
+
+	/*! Multiplications of a prediction with the blocks set, as KfEngine::getMultiplyAdds() */
+	size_t getMultiplyAdds(void) const
+	{
+		size_t blockProducts = 0;
+		for (size_t bi = 0; bi < B; bi++)
+		{
+			for (size_t bj = 0; bj < B; bj++)
+			{
+				// Fk(bi,bj) enters a block row of Fk * S and one of (Fk * S) * Fk'
+				blockProducts += blocksF[bi][bj] ? 2 * B : 0;
+				for (size_t bk = 0; bk < B; bk++)
+				{
+					blockProducts += (blocksG[bi][bk] && blocksG[bj][bk]) ? 1 : 0;
+				}
+			}
+		}
+		return blockProducts * L * L * L + 2 * N * N;
+	}
+
+private:
+	enum { B = N / L };
+	// Non-zero blocks of F (and Fk) and of G
+	bool blocksF[B][B], blocksG[B][B];
+};
+
+/*!
+ @brief Kalman Filter with N states and M measurements of fixed size, whose symmetric covariance is stored as its packed upper triangle
+ (row by row). The M measurements are applied one after the other as scalar updates, which holds for a diagonal R: no matrix inverse,
+ and the covariance is updated in Joseph form, S = (I - k * h) * S * (I - k * h)' + k * r * k', on its upper triangle only.
+ Same discretization as KfEngine, but Qk is masked by rows and columns, so that it stays symmetric: the states filtered out get no noise.
+ \class KfPackedEngine
+*/
+template <size_t N, size_t M, typename Scalar = double>
+class KfPackedEngine {
+public:
+	/*! Elements of a packed N x N symmetric matrix */
+	enum { PACKED_LENGTH = N * (N + 1) / 2 };
+
+	/*! Constructor: zero state, covariance and matrices */
+	KfPackedEngine()
+	{
+		for (size_t i = 0; i < N; i++)
+		{
+			X[i] = 0;
+			for (size_t j = 0; j < N; j++)
+			{
+				Fk[i][j] = 0;
+			}
+			for (size_t j = 0; j < M; j++)
+			{
+				H[j][i] = 0;
+			}
+		}
+		for (size_t i = 0; i < PACKED_LENGTH; i++)
+		{
+			Qk[i] = S[i] = 0;
+		}
+		for (size_t i = 0; i < M; i++)
+		{
+			r[i] = 0;
+		}
+	}
+
+	/*! Set the covariance from a column-major N x N matrix, keeping its upper triangle */
+	void setCovariance(const double* s)
+	{
+		for (size_t i = 0; i < N; i++)
+		{
+			for (size_t j = i; j < N; j++)
+			{
+				S[index(i, j)] = (Scalar)s[j * N + i];
+			}
+		}
+	}
+
+	/*! Set the observation model, as KfEngine::setObservation() */
+	void setObservation(const double* h, const double* variances)
+	{
+		KfKernels::loadColumnMajor(h, H);
+		for (size_t i = 0; i < M; i++)
+		{
+			r[i] = (Scalar)variances[i];
+		}
+	}
+
+	/*! Same as KfEngine::discretize(), but Qk is packed and masked by rows and columns */
+	KF_ENGINE_CLONES void discretize(const double* f, const double* g, const double* stds, const Scalar dt, const Scalar (&mask)[N])
+	{
+		Scalar G[N][N];
+		Scalar GQ[N][N];
+		for (size_t j = 0; j < N; j++)
+		{
+			const Scalar q = (Scalar)(stds[j] * stds[j]);
+			for (size_t i = 0; i < N; i++)
+			{
+				Fk[i][j] = (((i == j) ? 1 : 0) + (Scalar)f[j * N + i] * dt) * mask[j];
+				G[i][j] = (Scalar)g[j * N + i];
+				GQ[i][j] = G[i][j] * q;
+			}
+		}
+		KfKernels::multiplyTransposedUpper(GQ, G, Qk);
+		Scalar* packed = Qk;
+		for (size_t i = 0; i < N; i++)
+		{
+			for (size_t j = i; j < N; j++)
+			{
+				*packed = *packed * dt * mask[i] * mask[j];
+				packed++;
+			}
+		}
+	}
+
+	/*! Multiply the state by its mask */
+	void maskState(const Scalar (&mask)[N])
+	{
+		for (size_t i = 0; i < N; i++)
+		{
+			X[i] *= mask[i];
+		}
+	}
+
+	/*! Predict: X = Fk * X, S = Fk * S * Fk' + Qk, the second product on the upper triangle only */
+	KF_ENGINE_CLONES void predict(void)
+	{
+		Scalar Xp[N];
+		Scalar Sf[N][N];
+		Scalar FS[N][N];
+		KfKernels::multiply(Fk, X, Xp);
+		unpack(S, Sf);
+		KfKernels::multiply(Fk, Sf, FS);
+		KfKernels::multiplyTransposedUpper(FS, Fk, S);
+		for (size_t i = 0; i < N; i++)
+		{
+			X[i] = Xp[i];
+		}
+		for (size_t i = 0; i < PACKED_LENGTH; i++)
+		{
+			S[i] += Qk[i];
+		}
+	}
+
+	/*!
+	@brief Update with the observation differences, one measurement after the other.
+	@return false if an innovation variance is not positive, that measurement and the next ones are then not applied.
+	*/
+	KF_ENGINE_CLONES bool update(const double* diffs)
+	{
+		for (size_t m = 0; m < M; m++)
+		{
+			// SH = S * h', innovation variance v = h * S * h' + r
+			Scalar SH[N];
+			Scalar v = r[m];
+			Scalar innovation = (Scalar)diffs[m];
+			for (size_t i = 0; i < N; i++)
+			{
+				Scalar sum = 0;
+				for (size_t j = 0; j < i; j++)
+				{
+					sum += S[index(j, i)] * H[m][j];
+				}
+				const Scalar* row = &S[index(i, i)];
+				for (size_t j = i; j < N; j++)
+				{
+					sum += row[j - i] * H[m][j];
+				}
+				SH[i] = sum;
+			}
+			for (size_t i = 0; i < N; i++)
+			{
+				v += H[m][i] * SH[i];
+				innovation -= H[m][i] * X[i];
+			}
+			if (!(v > 0))
+			{
+				return false;
+			}
+
+			// Gain k = S * h' / v and state
+			Scalar k[N];
+			for (size_t i = 0; i < N; i++)
+			{
+				k[i] = SH[i] / v;
+				X[i] += k[i] * innovation;
+			}
+
+			// Joseph form expanded for a scalar measurement: S += v * k * k' - k * SH' - SH * k'
+			for (size_t i = 0; i < N; i++)
+			{
+				Scalar* row = &S[index(i, i)];
+				for (size_t j = i; j < N; j++)
+				{
+					row[j - i] += v * k[i] * k[j] - k[i] * SH[j] - SH[i] * k[j];
+				}
+			}
+		}
+		return true;
+	}
+
+	/*! Get the state */
+	const Scalar (&getState(void) const)[N] { return X; }
+	/*! Get the packed covariance */
+	const Scalar (&getCovariance(void) const)[PACKED_LENGTH] { return S; }
+
+	/*! Copy the state to N doubles */
+	void storeState(double* dst) const
+	{
+		for (size_t i = 0; i < N; i++)
+		{
+			dst[i] = (double)X[i];
+		}
+	}
+	/*! Copy the covariance to a column-major N x N matrix */
+	void storeCovariance(double* dst) const
+	{
+		Scalar Sf[N][N];
+		unpack(S, Sf);
+		KfKernels::storeColumnMajor(Sf, dst);
+	}
+
+	/*! Multiplications of a prediction, as KfEngine::getMultiplyAdds(), the upper triangles from the vector holding the diagonal */
+	static size_t getMultiplyAdds(void)
+	{
+		size_t upper = 0;
+		for (size_t i = 0; i < N; i++)
+		{
+			upper += N - (i & ~(size_t)3);
+		}
+		return 2 * upper * N + N * N * N + 2 * N * N;
+	}
+
+private:
+	/* Index of (i, j), i <= j, in the packed upper triangle */
+	static inline size_t index(const size_t i, const size_t j) { return i * N - i * (i - 1) / 2 + (j - i); }
+
+	/* Full symmetric matrix of a packed one */
+	static inline void unpack(const Scalar (&packed)[PACKED_LENGTH], Scalar (&full)[N][N])
+	{
+		const Scalar* element = packed;
+		for (size_t i = 0; i < N; i++)
+		{
+			for (size_t j = i; j < N; j++)
+			{
+				full[i][j] = full[j][i] = *element++;
+			}
+		}
+	}
+
+	// Discrete model, Qk packed
+	Scalar Fk[N][N], Qk[PACKED_LENGTH];
+	// Observation matrix and diagonal of R
+	Scalar H[M][N], r[M];
+	// State and packed covariance
+	Scalar X[N], S[PACKED_LENGTH];
+};
+
+/*!
+ @brief Kalman Filter with N states and M measurements of fixed size, whose covariance is factorized as S = U * D * U', U unit upper
+ triangular and D diagonal (Bierman-Thornton). The factors keep S symmetric and positive semi-definite by construction, which allows
+ to run in float. The inputs are given in double as for the other engines and converted to Scalar.
+ - Prediction (Thornton): the rows of W = [Fk * U, G], weighted by [D, Q * dt], are orthogonalized by modified weighted Gram-Schmidt,
+   giving the U and D of Fk * S * Fk' + G * Q * G' * dt without forming it.
+ - Update (Bierman): the M measurements one after the other as scalar updates, which holds for a diagonal R.
+ \class KfUdEngine
+*/
+template <size_t N, size_t M, typename Scalar = double>
+class KfUdEngine {
+public:
+	/*! Constructor: zero state, covariance and matrices */
+	KfUdEngine()
+	{
+		for (size_t i = 0; i < N; i++)
+		{
+			X[i] = D[i] = q[i] = 0;
+			for (size_t j = 0; j < N; j++)
+			{
+				Fk[i][j] = G[i][j] = 0;
+				U[i][j] = (i == j) ? 1 : 0;
+			}
+			for (size_t j = 0; j < M; j++)
+			{
+				H[j][i] = 0;
+			}
+		}
+		for (size_t i = 0; i < M; i++)
+		{
+			r[i] = 0;
+		}
+	}
+
+	/*! Set the covariance from a column-major N x N matrix, factorized as U * D * U' in double (columns from the last one) and then stored in Scalar */
+	void setCovariance(const double* s)
+	{
+		double u[N][N], d[N];
+		for (size_t jj = N; jj > 0; jj--)
+		{
+			const size_t j = jj - 1;
+			double dj = s[j * N + j];
+			for (size_t k = j + 1; k < N; k++)
+			{
+				dj -= d[k] * u[j][k] * u[j][k];
+			}
+			d[j] = dj;
+			for (size_t i = 0; i < N; i++)
+			{
+				u[i][j] = (i == j) ? 1 : 0;
+			}
+			for (size_t i = 0; (i < j) && (dj > 0); i++)
+			{
+				double uij = s[j * N + i];
+				for (size_t k = j + 1; k < N; k++)
+				{
+					uij -= d[k] * u[i][k] * u[j][k];
+				}
+				u[i][j] = uij / dj;
+			}
+		}
+		for (size_t i = 0; i < N; i++)
+		{
+			D[i] = (Scalar)d[i];
+			for (size_t j = 0; j < N; j++)
+			{
+				U[i][j] = (Scalar)u[i][j];
+			}
+		}
+	}
+
+	/*! Set the observation model, as KfEngine::setObservation() */
+	void setObservation(const double* h, const double* variances)
+	{
+		KfKernels::loadColumnMajor(h, H);
+		for (size_t i = 0; i < M; i++)
+		{
+			r[i] = (Scalar)variances[i];
+		}
+	}
+
+	/*!
+	@brief Discretize the model of the epoch as KfEngine::discretize(): Fk = I + F * dt masked by columns, and keep G and the diagonal of
+	Q * dt for the prediction. The noise of the states filtered out is zero (initialize() masks their STDs).
+	*/
+	void discretize(const double* f, const double* g, const double* stds, const double dt, const double (&mask)[N])
+	{
+		for (size_t j = 0; j < N; j++)
+		{
+			q[j] = (Scalar)(stds[j] * stds[j] * dt);
+			for (size_t i = 0; i < N; i++)
+			{
+				Fk[i][j] = (Scalar)((((i == j) ? 1 : 0) + f[j * N + i] * dt) * mask[j]);
+				G[i][j] = (Scalar)g[j * N + i];
+			}
+		}
+	}
+
+	/*! Multiply the state by its mask */
+	void maskState(const double (&mask)[N])
+	{
+		for (size_t i = 0; i < N; i++)
+		{
+			X[i] *= (Scalar)mask[i];
+		}
+	}
+
+	/*! Predict: X = Fk * X, and U, D of Fk * S * Fk' + Qk by Thornton's modified weighted Gram-Schmidt */
+	KF_ENGINE_CLONES void predict(void)
+	{
+		Scalar Xp[N];
+		KfKernels::multiply(Fk, X, Xp);
+		for (size_t i = 0; i < N; i++)
+		{
+			X[i] = Xp[i];
+		}
+
+		// W = [Fk * U, G] and its weights Dw = [D, q]
+		Scalar FU[N][N];
+		Scalar W[N][2 * N];
+		Scalar Dw[2 * N];
+		KfKernels::multiply(Fk, U, FU);
+		for (size_t i = 0; i < N; i++)
+		{
+			for (size_t j = 0; j < N; j++)
+			{
+				W[i][j] = FU[i][j];
+				W[i][N + j] = G[i][j];
+			}
+			Dw[i] = D[i];
+			Dw[N + i] = q[i];
+		}
+
+		// From the last row up: D(j) is the weighted norm of row j, U(i,j) the weighted projection of row i on it, removed from row i
+		for (size_t j = N; j-- > 0; )
+		{
+			Scalar c[2 * N];
+			Scalar d = 0;
+			for (size_t k = 0; k < 2 * N; k++)
+			{
+				c[k] = Dw[k] * W[j][k];
+				d += W[j][k] * c[k];
+			}
+			D[j] = d;
+			U[j][j] = 1;
+			const Scalar scale = (d > 0) ? 1 / d : 0;
+			for (size_t i = 0; i < j; i++)
+			{
+				Scalar projection = 0;
+				for (size_t k = 0; k < 2 * N; k++)
+				{
+					projection += W[i][k] * c[k];
+				}
+				projection *= scale;
+				U[i][j] = projection;
+				for (size_t k = 0; k < 2 * N; k++)
+				{
+					W[i][k] -= projection * W[j][k];
+				}
+			}
+			for (size_t i = j + 1; i < N; i++)
+			{
+				U[i][j] = 0;
+			}
+		}
+	}
+
+	/*!
+	@brief Update with the observation differences, one measurement after the other (Bierman).
+	@return false if an innovation variance is not positive, that measurement and the next ones are then not applied.
+	*/
+	KF_ENGINE_CLONES bool update(const double* diffs)
+	{
+		for (size_t m = 0; m < M; m++)
+		{
+			// f = U' * h', v = D * f, innovation
+			Scalar f[N];
+			Scalar v[N];
+			Scalar innovation = (Scalar)diffs[m];
+			for (size_t j = 0; j < N; j++)
+			{
+				Scalar sum = 0;
+				for (size_t i = 0; i <= j; i++)
+				{
+					sum += U[i][j] * H[m][i];
+				}
+				f[j] = sum;
+				v[j] = D[j] * sum;
+				innovation -= H[m][j] * X[j];
+			}
+
+			// Factors of S - k * v * k', and unscaled gain b
+			Scalar alpha = r[m];
+			if (!(alpha > 0))
+			{
+				return false;
+			}
+			Scalar b[N];
+			for (size_t j = 0; j < N; j++)
+			{
+				const Scalar alphaPrev = alpha;
+				alpha += f[j] * v[j];
+				D[j] *= alphaPrev / alpha;
+				b[j] = v[j];
+				const Scalar p = -f[j] / alphaPrev;
+				for (size_t i = 0; i < j; i++)
+				{
+					const Scalar u = U[i][j];
+					U[i][j] = u + b[i] * p;
+					b[i] += u * v[j];
+				}
+			}
+
+			// State
+			const Scalar gain = innovation / alpha;
+			for (size_t i = 0; i < N; i++)
+			{
+				X[i] += b[i] * gain;
+			}
+		}
+		return true;
+	}
+
+	/*! Copy the state to N doubles */
+	void storeState(double* dst) const
+	{
+		for (size_t i = 0; i < N; i++)
+		{
+			dst[i] = (double)X[i];
+		}
+	}
+	/*! Copy the covariance U * D * U' to a column-major N x N matrix */
+	void storeCovariance(double* dst) const
+	{
+		for (size_t i = 0; i < N; i++)
+		{
+			for (size_t j = 0; j < N; j++)
+			{
+				double sum = 0;
+				for (size_t k = (i > j) ? i : j; k < N; k++)
+				{
+					sum += (double)U[i][k] * (double)D[k] * (double)U[j][k];
+				}
+				dst[j * N + i] = sum;
+			}
+		}
+	}
+
+	/*! Multiplications of a prediction: Fk * U, Fk * X and the Gram-Schmidt of the N rows of 2N elements */
+	static size_t getMultiplyAdds(void) { return N * N * N + N * N + 2 * N * 2 * N + 2 * N * N * (N - 1); }
+
+private:
+	// Discrete model: Fk, G and diagonal of Q * dt
+	Scalar Fk[N][N], G[N][N], q[N];
+	// Observation matrix and diagonal of R
+	Scalar H[M][N], r[M];
+	// State and covariance factors
+	Scalar X[N], U[N][N], D[N];
+};
+
+/*!
+ @brief Interface to a fixed-size engine with N states chosen at run time. A whole epoch is one call, so that the methods of the
+ engine are still inlined in it.
+ \class KfEngineHandle
+*/
+template <size_t N>
+class KfEngineHandle {
+public:
+	/*! Destructor */
+	virtual ~KfEngineHandle() {}
+
+	/*! Set the covariance from a column-major N x N matrix */
+	virtual void setCovariance(const double* s) = 0;
+	/*! Set the observation matrix (column-major M x N) and the measurement noise variances */
+	virtual void setObservation(const double* h, const double* variances) = 0;
+	/*!
+	@brief Discretize, predict and, if updatable, update, keeping the states out of the mask at zero. Then copy the state to x.
+	@param f, g, stds, dt, mask: model of the epoch, as in discretize().
+	@param diffs: difference between observation and prediction.
+	@param isUpdatable: run prediction only or also update.
+	*/
+	virtual void step(const double* f, const double* g, const double* stds, const double dt, const double (&mask)[N], const double* diffs,
+		const bool isUpdatable, double* x) = 0;
+	/*! Copy the covariance to a column-major N x N matrix */
+	virtual void storeCovariance(double* dst) const = 0;
+	/*! Multiplications of a prediction */
+	virtual size_t getMultiplyAdds(void) const = 0;
+};
+
+/*!
+ @brief KfEngineHandle of an engine (KfEngine, KfBlockEngine, KfPackedEngine, KfUdEngine) held in the object.
+ \class KfEngineHolder
+*/
+template <class Engine, size_t N>
+class KfEngineHolder : public KfEngineHandle<N> {
+public:
+	/*! Get the engine, e.g. to set the blocks of KfBlockEngine */
+	Engine& getEngine(void) { return cEngine; }
+
+	void setCovariance(const double* s) { cEngine.setCovariance(s); }
+	void setObservation(const double* h, const double* variances) { cEngine.setObservation(h, variances); }
+	void step(const double* f, const double* g, const double* stds, const double dt, const double (&mask)[N], const double* diffs,
+		const bool isUpdatable, double* x)
+	{
+		cEngine.discretize(f, g, stds, dt, mask);
+		cEngine.predict();
+		cEngine.maskState(mask);
+		if (isUpdatable && cEngine.update(diffs))
+		{
+			cEngine.maskState(mask);
+		}
+		cEngine.storeState(x);
+	}
+	void storeCovariance(double* dst) const { cEngine.storeCovariance(dst); }
+	size_t getMultiplyAdds(void) const { return cEngine.getMultiplyAdds(); }
+
+private:
+	Engine cEngine;
+};
+
+#endif // PROC_KF_ENGINE_HEADER
@@ -4,6 +4,7 @@
  @brief Description: In this file the processes of proc_kf.h are implemented.
 */
 
+#include <chrono>
 #include <general/general.h>
 #include <interface/ui/ui.h>
 #include <monitor/monitor.h>
@@ -68,21 +69,140 @@ void KalmanFilter::initialize(void)
 	}
 
 	// Observation Matrix
-	sData.H(arma::span(0, KF_MEASUREMENTS_VECTOR_LENGTH - 1), arma::span(0, KF_MEASUREMENTS_VECTOR_LENGTH - 1)) = arma::eye(KF_MEASUREMENTS_VECTOR_LENGTH, KF_MEASUREMENTS_VECTOR_LENGTH);
+	sData.H.cols(KfStates::Position::first, KfStates::Position::last) = arma::eye(KF_MEASUREMENTS_VECTOR_LENGTH, KF_MEASUREMENTS_VECTOR_LENGTH);
 
 	sData.S = 0.1 * arma::eye(KF_STATE_VECTOR_LENGTH,KF_STATE_VECTOR_LENGTH);
 
-	sData.v.subvec(6,8) %= cInterfaceNavdata.getInputValues().attitudeSelector;
-	sData.v.subvec(9,11) %= cInterfaceNavdata.getInputValues().bodySelector;
-	sData.v.subvec(12,14) %= cInterfaceNavdata.getInputValues().attitudeSelector;
+	// Mask of the selected states: position and velocity always, attitude and biases as selected
+	stateMask.ones(KF_STATE_VECTOR_LENGTH);
+	stateMask(KfStates::Attitude::span()) = sInputValues.attitudeSelector;
+	stateMask(KfStates::AccBias::span()) = sInputValues.bodySelector;
+	stateMask(KfStates::GyrBias::span()) = sInputValues.attitudeSelector;
+	sData.v %= stateMask;
+
+	engine = sInputValues.kfEngine;
+	dtImu = 1.0 / sInputValues.fsImu;
+	covarianceEpochs = sInputValues.kfCovarianceEpochs;
+	steadyConvergence = sInputValues.kfSteady.at(0);
+	steadyRate = sInputValues.kfSteady.at(1);
+	steadyAcc = sInputValues.kfSteady.at(2);
+	steadyGapEpochs = (int)(sInputValues.kfSteady.at(3) * sInputValues.fsImu / sInputValues.navDecimation);
+
+	initializeEngines();
+}
+
+/* Initialize the selected engine as the Armadillo one */
+void KalmanFilter::initializeEngines(void)
+{
+	// Selected states, e.g. 9 of 15 with the yaw and the body X axis selected, and the reduced engine on them
+	cEngine.reset();
+	activeStates = arma::find(stateMask);
+	if (KF_ENGINE_REDUCED == engine)
+	{
+		reducedX = sData.X(activeStates);
+		reducedS = sData.S.submat(activeStates, activeStates);
+		reducedH = sData.H.cols(activeStates);
+		reducedQ = arma::square(sData.v(activeStates));
+		return;
+	}
+
+	// Fixed-size engines
+	if (KF_ENGINE_FIXED == engine)
+	{
+		cEngine.reset(new KfEngineHolder<KfEngine<KF_STATE_VECTOR_LENGTH, KF_MEASUREMENTS_VECTOR_LENGTH>, KF_STATE_VECTOR_LENGTH>());
+	}
+	else if (KF_ENGINE_BLOCK == engine)
+	{
+		KfEngineHolder<KfBlockEngine<KF_STATE_VECTOR_LENGTH, KF_MEASUREMENTS_VECTOR_LENGTH, 3>, KF_STATE_VECTOR_LENGTH>* pBlockHolder =
+			new KfEngineHolder<KfBlockEngine<KF_STATE_VECTOR_LENGTH, KF_MEASUREMENTS_VECTOR_LENGTH, 3>, KF_STATE_VECTOR_LENGTH>();
+		cEngine.reset(pBlockHolder);
+		KfBlockEngine<KF_STATE_VECTOR_LENGTH, KF_MEASUREMENTS_VECTOR_LENGTH, 3>& cBlockEngine = pBlockHolder->getEngine();
+
+		// Blocks of F filled by stateTransitionMatrix(), the diagonal ones are always taken
+		cBlockEngine.setTransitionBlock<KfStates::Position, KfStates::Velocity>();
+		cBlockEngine.setTransitionBlock<KfStates::Velocity, KfStates::Position>();
+		cBlockEngine.setTransitionBlock<KfStates::Velocity, KfStates::Attitude>();
+		cBlockEngine.setTransitionBlock<KfStates::Velocity, KfStates::AccBias>();
+		cBlockEngine.setTransitionBlock<KfStates::Attitude, KfStates::GyrBias>();
+
+		// G is block diagonal: identity but for velocity and attitude, so Qk is too
+		cBlockEngine.setNoiseBlock<KfStates::Position, KfStates::Position>();
+		cBlockEngine.setNoiseBlock<KfStates::Velocity, KfStates::Velocity>();
+		cBlockEngine.setNoiseBlock<KfStates::Attitude, KfStates::Attitude>();
+		cBlockEngine.setNoiseBlock<KfStates::AccBias, KfStates::AccBias>();
+		cBlockEngine.setNoiseBlock<KfStates::GyrBias, KfStates::GyrBias>();
+	}
+	else if (KF_ENGINE_PACKED == engine)
+	{
+		cEngine.reset(new KfEngineHolder<KfPackedEngine<KF_STATE_VECTOR_LENGTH, KF_MEASUREMENTS_VECTOR_LENGTH>, KF_STATE_VECTOR_LENGTH>());
+	}
+	else if (KF_ENGINE_UD == engine)
+	{
+		cEngine.reset(new KfEngineHolder<KfUdEngine<KF_STATE_VECTOR_LENGTH, KF_MEASUREMENTS_VECTOR_LENGTH, float>, KF_STATE_VECTOR_LENGTH>());
+	}
+	if (!cEngine)
+	{
+		return;
+	}
+	cEngine->setCovariance(sData.S.memptr());
+	cEngine->setObservation(sData.H.memptr(), sData.w.memptr());
+	for (int i = 0; i < KF_STATE_VECTOR_LENGTH; i++)
+	{
+		fixedStateMask[i] = stateMask(i);
+	}
 }
 
 /* Process Kalman Filter */
 template <class DatatypePrediction_s, class DatatypeObservation_s>
 void KalmanFilter::process(const DatatypePrediction_s& sDataIns, const DatatypeObservation_s& sDataGps, const bool isKfUpdatable)
 {
-	/* KF State transition matrix */
+	/* KF State transition matrix, discretized with the period of the navigation epoch */
 	stateTransitionMatrix(sDataIns);
+	dtImu = cInterfaceNavdata.getNavPeriod();
+	sData.epochs++;
+
+	/* Steady-state gain: back to the full propagation when the dynamics change */
+	epochsSinceUpdate = isKfUpdatable ? 0 : epochsSinceUpdate + 1;
+	if (isSteady && isDynamic())
+	{
+		isSteady = false;
+		sData.steadyExits++;
+	}
+
+	/* Discretize, predict and update */
+	step(arma::vec3(sDataGps.ENU - sDataIns.ENU), isKfUpdatable);
+
+	/* Steady-state gain: kept once converged */
+	if ((steadyConvergence > 0) && !isSteady && isKfUpdatable && (KF_ENGINE_ARMADILLO == engine))
+	{
+		checkConvergence();
+	}
+}
+
+/* Discretize, predict and update with the selected engine */
+void KalmanFilter::step(const arma::vec3& diffs, const bool isKfUpdatable)
+{
+	// Fixed-size engines, their state is copied to sData.X
+	if (cEngine)
+	{
+		cEngine->step(sData.F.memptr(), sData.G.memptr(), sData.v.memptr(), dtImu, fixedStateMask, diffs.memptr(), isKfUpdatable, sData.X.memptr());
+		return;
+	}
+	if (KF_ENGINE_REDUCED == engine)
+	{
+		stepReduced(diffs, isKfUpdatable);
+		return;
+	}
+	if (isSteady)
+	{
+		stepSteady(diffs, isKfUpdatable);
+		return;
+	}
+	if (1 != covarianceEpochs)
+	{
+		stepDecimated(diffs, isKfUpdatable);
+		return;
+	}
 
 	/* Discretize State Transition Matrix F and Process Noise Matrix Q (defined above with STDs) */
 	discretize();
@@ -92,43 +212,166 @@ void KalmanFilter::process(const DatatypePrediction_s& sDataIns, const DatatypeO
 
 	/* State prediction */
 	predictState();
-	sData.X.subvec(6,8) %= cInterfaceNavdata.getInstance().getInputValues().attitudeSelector;
-	sData.X.subvec(9,11) %= cInterfaceNavdata.getInstance().getInputValues().bodySelector;
-	sData.X.subvec(12,14) %= cInterfaceNavdata.getInstance().getInputValues().attitudeSelector;
+	sData.X %= stateMask;
 
 	/* Update filter */
 	if (isKfUpdatable)
 	{
-		updateFilter(sDataGps.ENU - sDataIns.ENU);
-		sData.X.subvec(6,8) %= cInterfaceNavdata.getInstance().getInputValues().attitudeSelector;
-		sData.X.subvec(9,11) %= cInterfaceNavdata.getInstance().getInputValues().bodySelector;
-		sData.X.subvec(12,14) %= cInterfaceNavdata.getInstance().getInputValues().attitudeSelector;
+		updateFilter(diffs);
+		sData.X %= stateMask;
+	}
+}
+
+/* Predict the state every epoch and the covariance every covarianceEpochs epochs */
+void KalmanFilter::stepDecimated(const arma::vec3& diffs, const bool isKfUpdatable)
+{
+	/* State prediction */
+	predictStateOnly();
+
+	/* Accumulate the transition, F * dt and the noise control matrix until the covariance is propagated */
+	pendingFk = sData.Fk * pendingFk;
+	pendingF += sData.Fk;
+	pendingF.diag() -= 1;
+	pendingG += sData.G;
+	pendingPeriod += dtImu;
+	pendingEpochs++;
+
+	if (isKfUpdatable || (pendingEpochs == covarianceEpochs))
+	{
+		propagateCovariance();
+	}
+
+	/* Update filter */
+	if (isKfUpdatable)
+	{
+		updateFilter(diffs);
+		sData.X %= stateMask;
+	}
+}
+
+/* Propagate the covariance over the pending epochs */
+void KalmanFilter::propagateCovariance(void)
+{
+	/* Noise of the interval with the mean G, columns filtered as in componentSelection() */
+	const arma::mat G = pendingG / pendingEpochs;
+	arma::mat Q = G * sData.Q * G.t() * pendingPeriod;
+	Q.each_row() %= stateMask.t();
+
+	/* Noise added along the interval and propagated to its end by Simpson's rule, with the transition of the 2nd half from the sum of F * dt */
+	const arma::mat Fmid = arma::eye(KF_STATE_VECTOR_LENGTH, KF_STATE_VECTOR_LENGTH) + pendingF / 2 + pendingF * pendingF / 8;
+	sData.Qk = (Q + 4 * Fmid * Q * Fmid.t() + pendingFk * Q * pendingFk.t()) / 6;
+	sData.S = pendingFk * sData.S * pendingFk.t() + sData.Qk;
+
+	pendingFk.eye();
+	pendingF.zeros();
+	pendingG.zeros();
+	pendingPeriod = 0;
+	pendingEpochs = 0;
+}
+
+/* Predict the state only */
+void KalmanFilter::predictStateOnly(void)
+{
+	sData.Fk = arma::eye(KF_STATE_VECTOR_LENGTH, KF_STATE_VECTOR_LENGTH) + sData.F * dtImu;
+	sData.Fk.each_row() %= stateMask.t();
+	sData.X = sData.Fk * sData.X;
+	sData.X %= stateMask;
+}
+
+/* Predict and update the state with the steady-state gain */
+void KalmanFilter::stepSteady(const arma::vec3& diffs, const bool isKfUpdatable)
+{
+	predictStateOnly();
+	if (isKfUpdatable)
+	{
+		sData.Y = diffs;
+		sData.I = sData.Y - sData.H * sData.X;
+		sData.X += sData.K * sData.I;
+		sData.X %= stateMask;
+	}
+	sData.steadyEpochs++;
+}
+
+/* Dynamics above the steady-state thresholds */
+bool KalmanFilter::isDynamic(void) const
+{
+	const arma::vec3 gyr = cInterfaceNavdata.getEpochInputs().get(KEY_GYR);
+	const arma::vec3 acc = cInterfaceNavdata.getEpochInputs().get(KEY_ACC);
+	return (arma::norm(gyr) > steadyRate) || (arma::norm(acc) > steadyAcc) || (epochsSinceUpdate > steadyGapEpochs);
+}
+
+/* Switch to the steady-state gain once converged, on the selected states: the covariance of the others keeps growing */
+void KalmanFilter::checkConvergence(void)
+{
+	const arma::mat K = sData.K.rows(activeStates);
+	const arma::mat S = sData.S.submat(activeStates, activeStates);
+	const bool isConverged = !previousK.is_empty() &&
+		(arma::norm(K - previousK, "fro") <= steadyConvergence * arma::norm(K, "fro")) &&
+		(arma::norm(S - previousS, "fro") <= steadyConvergence * arma::norm(S, "fro"));
+	previousK = K;
+	previousS = S;
+
+	if (isConverged && !isDynamic())
+	{
+		isSteady = true;
+		sData.steadyEntries++;
+		previousK.reset();
+		previousS.reset();
 	}
 }
 
+/* Discretize, predict and update the selected states */
+void KalmanFilter::stepReduced(const arma::vec3& diffs, const bool isKfUpdatable)
+{
+	const arma::uword length = activeStates.n_elem;
+
+	// Discretize the rows and columns of the selected states, the noise of the others is zero
+	const arma::mat Fk = arma::eye(length, length) + sData.F.submat(activeStates, activeStates) * dtImu;
+	const arma::mat G = sData.G.submat(activeStates, activeStates);
+	const arma::mat Qk = G * arma::diagmat(reducedQ) * G.t() * dtImu;
+
+	// Predict
+	reducedX = Fk * reducedX;
+	reducedS = Fk * reducedS * Fk.t() + Qk;
+
+	// Update
+	if (isKfUpdatable)
+	{
+		const arma::vec innovation = diffs - reducedH * reducedX;
+		const arma::mat V = reducedH * reducedS * reducedH.t() + sData.R;
+		const arma::mat K = reducedS * reducedH.t() * V.i();
+		reducedX += K * innovation;
+		reducedS = (arma::eye(length, length) - K * reducedH) * reducedS;
+	}
+
+	// Scatter to the 15 states
+	sData.X.zeros();
+	sData.X(activeStates) = reducedX;
+}
+
 /* Filter the matrices with the selections made for angles and axes */
 void KalmanFilter::componentSelection(void)
 {
-	arma::vec bodySelector = cInterfaceNavdata.getInputValues().bodySelector;
-	arma::vec attitudeSelector = cInterfaceNavdata.getInputValues().attitudeSelector;
+	const arma::rowvec attitudeSelector = stateMask(KfStates::Attitude::span()).t();
+	const arma::rowvec bodySelector = stateMask(KfStates::AccBias::span()).t();
 
 	/* Filter columns related to velocity rate */
-	sData.Fk.cols(6, 8) %= arma::repmat(attitudeSelector.t(), sData.F.n_rows, 1);
+	sData.Fk.cols(KfStates::Attitude::first, KfStates::Attitude::last) %= arma::repmat(attitudeSelector, sData.F.n_rows, 1);
 
 	/* Filter columns related to accelerometer bias */
-	sData.Fk.cols(9, 11) %= arma::repmat(bodySelector.t(), sData.F.n_rows, 1);
+	sData.Fk.cols(KfStates::AccBias::first, KfStates::AccBias::last) %= arma::repmat(bodySelector, sData.F.n_rows, 1);
 
 	/* Filter columns related to Gyrometer Bias */
-	sData.Fk.cols(12, 14) %= arma::repmat(attitudeSelector.t(), sData.F.n_rows, 1);
+	sData.Fk.cols(KfStates::GyrBias::first, KfStates::GyrBias::last) %= arma::repmat(attitudeSelector, sData.F.n_rows, 1);
 
 	/* Filter columns related to velocity rate */
-	sData.Qk.cols(6, 8) %= arma::repmat(attitudeSelector.t(), sData.F.n_rows, 1);
+	sData.Qk.cols(KfStates::Attitude::first, KfStates::Attitude::last) %= arma::repmat(attitudeSelector, sData.F.n_rows, 1);
 
 	/* Filter columns related to accelerometer bias */
-	sData.Qk.cols(9, 11) %= arma::repmat(bodySelector.t(), sData.F.n_rows, 1);
+	sData.Qk.cols(KfStates::AccBias::first, KfStates::AccBias::last) %= arma::repmat(bodySelector, sData.F.n_rows, 1);
 
 	/* Filter columns related to Gyrometer Bias */
-	sData.Qk.cols(12, 14) %= arma::repmat(attitudeSelector.t(), sData.F.n_rows, 1);
+	sData.Qk.cols(KfStates::GyrBias::first, KfStates::GyrBias::last) %= arma::repmat(attitudeSelector, sData.F.n_rows, 1);
 
 }
 
@@ -138,49 +381,53 @@ void KalmanFilter::stateTransitionMatrix(const Datatype_s& sDataIns)
 {
 	const InputValues_t& inputValues = cInterfaceNavdata.getInputValues();
 
+	// With the quaternion (-y 2) the attitude is its Body to ENU matrix, the Euler-rate matrix comes from its terms without trigonometric functions
+	const bool isQuaternion = inputValues.progressAngles && inputValues.progressQuaternion;
+
 	// Get body to LTP rotation matrix	
-	const arma::mat Rb2n = Frames::matrixBody2Enu(sDataIns.RPY % inputValues.attitudeSelector);
+	const arma::mat33 Rb2n = isQuaternion ? sDataIns.BODY2ENU : FrameCache::getInstance().matrixBody2Enu(sDataIns.RPY % inputValues.attitudeSelector);
 	// Get Rotation matrix depending on mechanization mode (velocity rate in LTP or Body frame): Body-to-LTP or identity, respectively.
 	const arma::mat R = (inputValues.modeMechanicsLocal) ? arma::eye(3,3) : Rb2n;
 	
 	// Get accelerometer and gyrometer
-	const arma::vec gyr = cInterfaceNavdata.getMapInputMonitor().at(KEY_GYR).inputHolder % inputValues.attitudeSelector;
-	const arma::vec acc = cInterfaceNavdata.getMapInputMonitor().at(KEY_ACC).inputHolder % inputValues.bodySelector;
+	const arma::vec3 gyr = cInterfaceNavdata.getEpochInputs().get(KEY_GYR) % inputValues.attitudeSelector;
+	const arma::vec3 acc = cInterfaceNavdata.getEpochInputs().get(KEY_ACC) % inputValues.bodySelector;
 	
 	// Get skew symmetric matrix for accelerometer in LTP plane
-	const arma::mat skew_Rf = Frames::skew(Rb2n * acc);
+	const arma::mat33 skew_Rf = Frames::skew(arma::vec3(Rb2n * acc));
 	// Get skey symmetric matrix for gyrometer in LTP plane
-	const arma::mat skew_Rw = Frames::skew(Rb2n * gyr);
+	const arma::mat33 skew_Rw = Frames::skew(arma::vec3(Rb2n * gyr));
 	// Get skew symmetric matrix for Earth rotation with respect to inertial frame.
-	const arma::mat skew_ie = Frames::skewInertialEarth(sDataIns.LLH(0));
+	const arma::mat33 skew_ie = FrameCache::getInstance().skewInertialEarth(sDataIns.LLH(0));
 
 	// Get Euler angle derivative matrix
-	const arma::mat M = Frames::matrixRateAttitudeDynamics(sDataIns.RPY % inputValues.attitudeSelector);
+	const arma::mat33 M = isQuaternion ? Frames::matrixRateAttitudeDynamics(Frames::attitudeTrig(sDataIns.BODY2ENU)) :
+		FrameCache::getInstance().matrixRateAttitudeDynamics(sDataIns.RPY % inputValues.attitudeSelector);
 	// Get skew symmetric matrix for attitude angles rate
-	const arma::mat skew_rpy = Frames::skew(sDataIns.RPY_dot % inputValues.attitudeSelector);
+	const arma::mat33 skew_rpy = Frames::skew(arma::vec3(sDataIns.RPY_dot % inputValues.attitudeSelector));
 
 	// Position rate error propagation
-	sData.F(arma::span(0,2), arma::span(3,5)) = R * arma::eye(3,3);
+	sData.F(KfStates::Position::span(), KfStates::Velocity::span()) = R * arma::eye(3,3);
 
 	// Velocity rate error propagation
-	sData.F(5,2) = 2 * Frames::G_EQUATOR / Frames::SEMI_MAJOR_A;
-	sData.F(arma::span(3,5), arma::span(3,5)) = -R.t() * skew_ie * 2;
-	sData.F(arma::span(3,5),arma::span(6,8)) = -R.t() * skew_Rf;
-	sData.F(arma::span(3,5), arma::span(9,11)) = R.t() * Rb2n;
+	sData.F(KfStates::Velocity::last, KfStates::Position::last) = 2 * Frames::G_EQUATOR / Frames::SEMI_MAJOR_A;
+	sData.F(KfStates::Velocity::span(), KfStates::Velocity::span()) = -R.t() * skew_ie * 2;
+	sData.F(KfStates::Velocity::span(), KfStates::Attitude::span()) = -R.t() * skew_Rf;
+	sData.F(KfStates::Velocity::span(), KfStates::AccBias::span()) = R.t() * Rb2n;
 
 	// Attitude rate error propagation
-	sData.F(arma::span(6,8), arma::span(6,8)) = skew_rpy;
-	sData.F(arma::span(6,8), arma::span(12,14)) = M;
+	sData.F(KfStates::Attitude::span(), KfStates::Attitude::span()) = skew_rpy;
+	sData.F(KfStates::Attitude::span(), KfStates::GyrBias::span()) = M;
 	
 	// Accelerometer bias rate error propagation
-	sData.F(arma::span(9,11),arma::span(9,11)) = -arma::eye(3,3) / inputValues.tau;
+	sData.F(KfStates::AccBias::span(), KfStates::AccBias::span()) = -arma::eye(3,3) / inputValues.tau;
 	
 	// Gyrometer bias rate error propagation
-	sData.F(arma::span(12,14),arma::span(12,14)) = -arma::eye(3,3) / inputValues.tau;
+	sData.F(KfStates::GyrBias::span(), KfStates::GyrBias::span()) = -arma::eye(3,3) / inputValues.tau;
 
 	// Fill Process Noise matrix Q, Measurement Noise matrix R, and noise control matrix G
-	sData.G(arma::span(3,5),arma::span(3,5)) = R.t() * Rb2n;
-	sData.G(arma::span(6,8),arma::span(6,8)) = M;
+	sData.G(KfStates::Velocity::span(), KfStates::Velocity::span()) = R.t() * Rb2n;
+	sData.G(KfStates::Attitude::span(), KfStates::Attitude::span()) = M;
 
 	sData.Q = arma::diagmat(arma::pow(sData.v,2));
 
@@ -190,7 +437,6 @@ void KalmanFilter::stateTransitionMatrix(const Datatype_s& sDataIns)
 /* Discretize F and Q matrices */
 void KalmanFilter::discretize(void)
 {
-	const double dtImu = 1.0 / cInterfaceNavdata.getInputValues().fsImu;
 	sData.Fk = (arma::eye(KF_STATE_VECTOR_LENGTH, KF_STATE_VECTOR_LENGTH)) + sData.F * dtImu;
 	sData.Qk =  sData.G * sData.Q * sData.G.t() * dtImu;
 	
@@ -222,3 +468,138 @@ void KalmanFilter::updateFilter(arma::vec diffs)
 	// State Vector Covariance Update
 	sData.S = ((arma::eye(KF_STATE_VECTOR_LENGTH, KF_STATE_VECTOR_LENGTH)) - sData.K * sData.H) * sData.S;
 }
+
+/* Benchmark the engines on the same model */
+KfBenchmark_t KalmanFilter::benchmark(const arma::vec& attitudeSelector, const arma::vec& bodySelector)
+{
+	const int fsImu = 300;
+	const size_t seconds = 120;
+	KfBenchmark_t results;
+	results.epochs = fsImu * seconds;
+	results.updates = seconds;
+	for (int engine = 0; engine < KF_ENGINE_TOTAL; engine++)
+	{
+		results.nsPerPrediction[engine] = results.nsPerUpdate[engine] = results.maxDiffState[engine] = results.maxDiffCovariance[engine] = 0;
+	}
+
+	// Filters of each engine, noises of tools/run.py
+	const double stds[KF_STATE_VECTOR_LENGTH] = { 0, 0, 0, 0.05601, 0.01959, 0.18640, 0.01752, 0.03873, 0.0347, 0.01, 0.01, 0.01, 0.01, 0.01, 0.01 };
+	KalmanFilter filters[KF_ENGINE_TOTAL];
+	for (int engine = 0; engine < KF_ENGINE_TOTAL; engine++)
+	{
+		KalmanFilter& filter = filters[engine];
+		filter.engine = engine;
+		filter.dtImu = 1.0 / fsImu;
+		filter.stateMask(KfStates::Attitude::span()) = attitudeSelector;
+		filter.stateMask(KfStates::AccBias::span()) = bodySelector;
+		filter.stateMask(KfStates::GyrBias::span()) = attitudeSelector;
+		filter.sData.v = arma::vec(stds, KF_STATE_VECTOR_LENGTH) % filter.stateMask;
+		filter.sData.w.fill(9);
+		filter.sData.H.cols(KfStates::Position::first, KfStates::Position::last) = arma::eye(KF_MEASUREMENTS_VECTOR_LENGTH, KF_MEASUREMENTS_VECTOR_LENGTH);
+		filter.sData.S = 0.1 * arma::eye(KF_STATE_VECTOR_LENGTH, KF_STATE_VECTOR_LENGTH);
+		filter.sData.Q = arma::diagmat(arma::pow(filter.sData.v, 2));
+		filter.sData.R = arma::diagmat(filter.sData.w);
+		filter.initializeEngines();
+	}
+
+	// Multiplications per prediction: Armadillo multiplies by the dense Q, the reduced engine by the diagonal one
+	results.multiplyAdds[KF_ENGINE_ARMADILLO] = 4 * KF_STATE_VECTOR_LENGTH * KF_STATE_VECTOR_LENGTH * KF_STATE_VECTOR_LENGTH + KF_STATE_VECTOR_LENGTH * KF_STATE_VECTOR_LENGTH;
+	for (int engine : { KF_ENGINE_FIXED, KF_ENGINE_BLOCK, KF_ENGINE_PACKED, KF_ENGINE_UD })
+	{
+		results.multiplyAdds[engine] = filters[engine].cEngine->getMultiplyAdds();
+	}
+	const arma::uvec& activeStates = filters[KF_ENGINE_REDUCED].activeStates;
+	const size_t activeLength = activeStates.n_elem;
+	results.multiplyAdds[KF_ENGINE_REDUCED] = 3 * activeLength * activeLength * activeLength + 2 * activeLength * activeLength;
+
+	// Covariance of a filter, the fixed-size engines keep their own
+	auto getCovariance = [](const KalmanFilter& filter)
+	{
+		arma::mat covariance = filter.sData.S;
+		if (filter.cEngine)
+		{
+			filter.cEngine->storeCovariance(covariance.memptr());
+		}
+		else if (KF_ENGINE_REDUCED == filter.engine)
+		{
+			covariance.zeros();
+			covariance.submat(filter.activeStates, filter.activeStates) = filter.reducedS;
+		}
+		return covariance;
+	};
+
+	// Model of an epoch as formed by stateTransitionMatrix() in body frame mechanization, for a platform turning slowly
+	const arma::mat33 eye3 = arma::eye(3, 3);
+	const arma::mat33 skew_ie = Frames::skewInertialEarth(60.2 * Frames::DEG2RAD);
+	arma::mat F = arma::zeros(KF_STATE_VECTOR_LENGTH, KF_STATE_VECTOR_LENGTH);
+	arma::mat G = arma::eye(KF_STATE_VECTOR_LENGTH, KF_STATE_VECTOR_LENGTH);
+	auto formModel = [&](const double t)
+	{
+		const arma::vec3 rpy = { 0.05 * sin(0.3 * t), 0.03 * cos(0.2 * t), 0.1 * t };
+		const arma::vec3 rpyRate = { 0.015 * cos(0.3 * t), -0.006 * sin(0.2 * t), 0.1 };
+		const arma::vec3 acc = { 0.5 * sin(t), 0.2 * cos(0.5 * t), 0.1 };
+		const arma::mat33 Rb2n = Frames::matrixBody2Enu(rpy);
+		const arma::mat33 M = Frames::matrixRateAttitudeDynamics(rpy);
+		F(KfStates::Position::span(), KfStates::Velocity::span()) = Rb2n;
+		F(KfStates::Velocity::last, KfStates::Position::last) = 2 * Frames::G_EQUATOR / Frames::SEMI_MAJOR_A;
+		F(KfStates::Velocity::span(), KfStates::Velocity::span()) = -Rb2n.t() * skew_ie * 2;
+		F(KfStates::Velocity::span(), KfStates::Attitude::span()) = -Rb2n.t() * Frames::skew(arma::vec3(Rb2n * acc));
+		F(KfStates::Velocity::span(), KfStates::AccBias::span()) = eye3;
+		F(KfStates::Attitude::span(), KfStates::Attitude::span()) = Frames::skew(rpyRate);
+		F(KfStates::Attitude::span(), KfStates::GyrBias::span()) = M;
+		F(KfStates::AccBias::span(), KfStates::AccBias::span()) = -eye3 / 100;
+		F(KfStates::GyrBias::span(), KfStates::GyrBias::span()) = -eye3 / 100;
+		G(KfStates::Velocity::span(), KfStates::Velocity::span()) = eye3;
+		G(KfStates::Attitude::span(), KfStates::Attitude::span()) = M;
+	};
+
+	// Each engine runs the whole sequence, the states and covariances after each update are kept to compare them
+	std::vector<arma::vec> states[KF_ENGINE_TOTAL];
+	std::vector<arma::mat> covariances[KF_ENGINE_TOTAL];
+	for (int engine = 0; engine < KF_ENGINE_TOTAL; engine++)
+	{
+		KalmanFilter& filter = filters[engine];
+		for (size_t epoch = 0; epoch < results.epochs; epoch++)
+		{
+			const double t = (double)epoch / fsImu;
+			formModel(t);
+			filter.sData.F = F;
+			filter.sData.G = G;
+
+			// GPS at 1 Hz, differences of a few meters
+			const bool isUpdate = ((epoch + 1) % fsImu) == 0;
+			const arma::vec3 diffs = { 3 * sin(0.7 * t), 2 * cos(0.5 * t), sin(0.3 * t) };
+
+			const auto start = std::chrono::steady_clock::now();
+			filter.step(diffs, isUpdate);
+			const auto stop = std::chrono::steady_clock::now();
+			(isUpdate ? results.nsPerUpdate[engine] : results.nsPerPrediction[engine]) += std::chrono::duration<double, std::nano>(stop - start).count();
+
+			if (isUpdate)
+			{
+				states[engine].push_back(filter.sData.X);
+				covariances[engine].push_back(getCovariance(filter));
+			}
+		}
+	}
+
+	// Differences to the Armadillo engine after each update, on the covariance of the selected states: the masked engines also
+	// propagate the rows of the others, which do not change the selected ones
+	for (int engine = 0; engine < KF_ENGINE_TOTAL; engine++)
+	{
+		for (size_t update = 0; update < results.updates; update++)
+		{
+			const arma::mat covariance = covariances[KF_ENGINE_ARMADILLO][update].submat(activeStates, activeStates);
+			const arma::mat covarianceEngine = covariances[engine][update].submat(activeStates, activeStates);
+			results.maxDiffState[engine] = std::max(results.maxDiffState[engine], arma::abs(states[engine][update] - states[KF_ENGINE_ARMADILLO][update]).max());
+			results.maxDiffCovariance[engine] = std::max(results.maxDiffCovariance[engine], arma::abs(covarianceEngine - covariance).max() / arma::abs(covariance).max());
+		}
+	}
+
+	for (int engine = 0; engine < KF_ENGINE_TOTAL; engine++)
+	{
+		results.nsPerPrediction[engine] /= (double)(results.epochs - results.updates);
+		results.nsPerUpdate[engine] /= (double)results.updates;
+	}
+	return results;
+}
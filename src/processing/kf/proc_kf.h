@@ -9,10 +9,24 @@
 #ifndef KF_HEADER
 #define KF_HEADER
 
+#include <memory>
 #include <general/general.h>
 #include <processing/kf/datatypes/proc_kf_datatypes.h>
+#include <processing/kf/engine/proc_kf_engine.h>
 #include <processing/system/proc_system_helper.h>
 
+/* Results of KalmanFilter::benchmark(): epochs and updates run, multiplications per prediction and time per epoch without and with
+update [ns] of each engine, and largest differences to the Armadillo engine of the state and of the covariance (relative to its largest element) */
+typedef struct KfBenchmark_s {
+	size_t epochs;
+	size_t updates;
+	size_t multiplyAdds[KF_ENGINE_TOTAL];
+	double nsPerPrediction[KF_ENGINE_TOTAL];
+	double nsPerUpdate[KF_ENGINE_TOTAL];
+	double maxDiffState[KF_ENGINE_TOTAL];
+	double maxDiffCovariance[KF_ENGINE_TOTAL];
+} KfBenchmark_t;
+
 /*!
  @brief Class to handle Kalman Filter. Not technically needed to be singletoon class, although only one object is created.
  Inherits SystemDataTemplate methods to access KF variables from outside. KF variables are of type DatatypesKF_t.
@@ -21,7 +35,10 @@
 class KalmanFilter : public SystemDataTemplate<DatatypesKF_t> {
 public:
 	// Constructor
-	KalmanFilter(){};
+	KalmanFilter() : engine(KF_ENGINE_ARMADILLO), dtImu(0), stateMask(arma::ones(KF_STATE_VECTOR_LENGTH, 1)), covarianceEpochs(1), pendingEpochs(0), pendingPeriod(0),
+		pendingFk(arma::eye(KF_STATE_VECTOR_LENGTH, KF_STATE_VECTOR_LENGTH)), pendingF(arma::zeros(KF_STATE_VECTOR_LENGTH, KF_STATE_VECTOR_LENGTH)),
+		pendingG(arma::zeros(KF_STATE_VECTOR_LENGTH, KF_STATE_VECTOR_LENGTH)), steadyConvergence(0), steadyRate(0), steadyAcc(0), steadyGapEpochs(0),
+		isSteady(false), epochsSinceUpdate(0) {};
 
 	/*! KF initialization */
 	void initialize(void);
@@ -36,7 +53,65 @@ public:
 	*/
 	template <class DatatypePrediction_s, class DatatypeObservation_s>
 	void process(const DatatypePrediction_s& sDataIns, const DatatypeObservation_s& sDataGps, const bool isKfUpdatable);
+
+	/*!
+	@brief Benchmark the engines (KfEngine_e) on the 15 states model with the same model every epoch: 300 Hz prediction and 1 Hz update.
+	@param attitudeSelector, bodySelector: states selected, as in initialize().
+	@return timings of each engine and differences to the Armadillo engine.
+	*/
+	static KfBenchmark_t benchmark(const arma::vec& attitudeSelector, const arma::vec& bodySelector);
 private:
+	/*!
+	@brief Discretize, predict and update with the selected engine, once the state transition matrix is formed.
+	@param diffs: difference between observation and prediction.
+	@param isKfUpdatable: run prediction only or also update filter.
+	*/
+	void step(const arma::vec3& diffs, const bool isKfUpdatable);
+
+	/*!
+	@brief Discretize, predict and update the selected states only (stateMask not zero), then scatter them to sData.X.
+	The states filtered out are zero and their columns of Fk and Qk too, so that they do not change the selected ones.
+	@param diffs: difference between observation and prediction.
+	@param isKfUpdatable: run prediction only or also update filter.
+	*/
+	void stepReduced(const arma::vec3& diffs, const bool isKfUpdatable);
+
+	/*!
+	@brief Predict the state every epoch and accumulate its transition, propagate the covariance every covarianceEpochs epochs and before
+	an update, then update.
+	@param diffs: difference between observation and prediction.
+	@param isKfUpdatable: run prediction only or also update filter.
+	*/
+	void stepDecimated(const arma::vec3& diffs, const bool isKfUpdatable);
+
+	/*!
+	@brief Propagate the covariance over the pending epochs: S = Fk * S * Fk' + Qk with the product Fk of their transitions, and Qk the noise
+	of the interval with their mean G, integrated along it by Simpson's rule.
+	*/
+	void propagateCovariance(void);
+
+	/*! Predict the state only, with the transition of the epoch filtered as in componentSelection() */
+	void predictStateOnly(void);
+
+	/*!
+	@brief Predict the state and update it with the steady-state gain, the covariance is kept.
+	@param diffs: difference between observation and prediction.
+	@param isKfUpdatable: run prediction only or also update filter.
+	*/
+	void stepSteady(const arma::vec3& diffs, const bool isKfUpdatable);
+
+	/*! Whether the angular rate or the acceleration measured, or the epochs since the last update, exceed the steady-state thresholds */
+	bool isDynamic(void) const;
+
+	/*! After an update: switch to the steady-state gain if the gain and the covariance changed less than steadyConvergence from the previous update */
+	void checkConvergence(void);
+
+	/*!
+	@brief Create the selected engine when it is not the Armadillo one, and start it from the covariance, observation model (sData.H, sData.w),
+	process noise (sData.v) and state mask of the Armadillo one.
+	*/
+	void initializeEngines(void);
+
 	/*!
 	@brief Form state transition matrix
 	@param sDataFusion datatype containing parameters to form the F matrix
@@ -58,6 +133,30 @@ private:
 	@param diffs: Input difference between observation and prediction.
 	*/
 	void updateFilter(arma::vec diffs);
+
+	// Engine (KfEngine_e), period of the navigation epoch (IMU sampling period without preintegration) and mask of the states selected by the attitude and body selectors
+	int engine;
+	double dtImu;
+	arma::vec stateMask;
+	// Fixed-size engine selected (dense, by blocks of 3 states, with packed covariance or with UD factors in float), null for the others, and its state mask
+	std::unique_ptr<KfEngineHandle<KF_STATE_VECTOR_LENGTH>> cEngine;
+	double fixedStateMask[KF_STATE_VECTOR_LENGTH];
+	// Reduced engine: indexes of the selected states, their state, covariance, observation matrix and process noise variances
+	arma::uvec activeStates;
+	arma::vec reducedX, reducedQ;
+	arma::mat reducedS, reducedH;
+	// Covariance decimation: epochs per propagation, epochs pending and their period, product of their transitions and sums of their F * dt and G
+	int covarianceEpochs;
+	int pendingEpochs;
+	double pendingPeriod;
+	arma::mat pendingFk, pendingF, pendingG;
+	// Steady-state gain: thresholds of convergence, angular rate, acceleration and GPS gap, whether it is used, epochs since the last
+	// update, and gain and covariance of the selected states after the previous update (empty when not known)
+	double steadyConvergence, steadyRate, steadyAcc;
+	int steadyGapEpochs;
+	bool isSteady;
+	int epochsSinceUpdate;
+	arma::mat previousK, previousS;
 };
 
 #endif // KF_HEADER
\ No newline at end of file
@@ -30,16 +30,40 @@ void FusionMain::initialize(void)
 void FusionMain::correctPosition(void)
 {
 	const InputValues_t inputValues = cInterfaceNavdata.getInstance().getInputValues();
-	const arma::mat R = (inputValues.modeMechanicsLocal) ? arma::eye(3,3) : Frames::matrixBody2Enu(sData.RPY % inputValues.attitudeSelector);
+	// With the quaternion the Body to ENU matrix is the one of the INS, and the angles are corrected only for the outputs
+	const bool isQuaternion = inputValues.progressAngles && inputValues.progressQuaternion;
+	const arma::mat R = (inputValues.modeMechanicsLocal) ? arma::eye(3,3) :
+		(isQuaternion ? sData.BODY2ENU : FrameCache::getInstance().matrixBody2Enu(sData.RPY % inputValues.attitudeSelector));
 	
 	/* Correction for position */
-	sData.ENU += cKf.getData().X.subvec(0,2);
+	sData.ENU += cKf.getData().X(KfStates::Position::span());
 
 	/* Correction for velocity */
-	sData.V += R * cKf.getData().X.subvec(3,5);
+	sData.V += R * cKf.getData().X(KfStates::Velocity::span());
+
+	if (isQuaternion)
+	{
+		return;
+	}
+
+	/* Correction for attitude angles */
+	sData.RPY += cKf.getData().X(KfStates::Attitude::span());
+
+	Frames::adjustRollPitch(sData.RPY(0));
+	Frames::adjustRollPitch(sData.RPY(1));
+	Frames::adjustYaw(sData.RPY(2));
+}
+
+void FusionMain::updateAttitudeAngles(const arma::vec3& rpyIns)
+{
+	const InputValues_t& inputValues = cInterfaceNavdata.getInputValues();
+	if (!(inputValues.progressAngles && inputValues.progressQuaternion))
+	{
+		return;
+	}
 
 	/* Correction for attitude angles */
-	sData.RPY += cKf.getData().X.subvec(6,8);
+	sData.RPY = rpyIns + cKf.getData().X(KfStates::Attitude::span());
 
 	Frames::adjustRollPitch(sData.RPY(0));
 	Frames::adjustRollPitch(sData.RPY(1));
@@ -49,7 +73,7 @@ void FusionMain::correctPosition(void)
 void FusionMain::calcGeodeticNav(void)
 {
 	sData.ECEF = Frames::enu2ecef(sData.LLH, sData.ENU, sData.ECEF_REF);
-	sData.LLH = Frames::ecef2llh(sData.ECEF);
+	sData.LLH = Frames::ecef2llh(sData.ECEF, cInterfaceNavdata.getInputValues().geodeticMethod);
 }
 
 void FusionMain::process(void)
@@ -78,6 +102,7 @@ void FusionMain::process(void)
 	sData.ENU = sIns.ENU;
 	sData.RPY = sIns.RPY;
 	sData.RPY_dot = sIns.RPY_dot;
+	sData.BODY2ENU = sIns.BODY2ENU;
 	sData.V  = sIns.V;
 
 	// Process KF
@@ -27,6 +27,12 @@ public:
 	/*! System processing. Responsible to call KF to compute fused state with GPS and IMU data and convert from ENU to LLH coordinates */
 	void process(void);
 
+	/*!
+	@brief With the quaternion (-y 2), derive the attitude angles for the outputs: the INS angles with the KF attitude correction.
+	@param rpyIns: attitude angles of the INS, see InsMain::updateAttitudeAngles().
+	*/
+	void updateAttitudeAngles(const arma::vec3& rpyIns);
+
 	/*! Return const reference to KF variables to be accessed read-only from other modules. */
 	const DatatypesKF_t& getKfState(void);
 
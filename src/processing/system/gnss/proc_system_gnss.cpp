@@ -12,7 +12,7 @@
 void GnssMain::process(void)
 {
 	// Assign GPS data read from input
-	sData.LLH = cInterfaceNavdata.getMapInputMonitor().at(KEY_GPS).inputHolder;
+	sData.LLH = cInterfaceNavdata.getEpochInputs().get(KEY_GPS);
 
 	// Calculate ECEF & set the ECEF_REF value for ENU frame computation.
 	sData.ECEF = Frames::llh2ecef(sData.LLH);
@@ -26,5 +26,5 @@ void GnssMain::process(void)
 	arma::vec ecef2 = sData.ECEF;
 	sData.ENU = Frames::ecef2enu(sData.LLH, sData.ECEF, sData.ECEF_REF);
 	sData.ECEF = Frames::enu2ecef(sData.LLH, sData.ENU, sData.ECEF_REF);
-	sData.LLH =  Frames::ecef2llh(sData.ECEF);
+	sData.LLH =  Frames::ecef2llh(sData.ECEF, cInterfaceNavdata.getInputValues().geodeticMethod);
 }
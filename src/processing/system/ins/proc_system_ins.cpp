@@ -17,15 +17,15 @@
 /* Attitude angles: check availability if CSV indexer were entered, or if they can be calculated */
 void AttitudeAngles::checkAttitudeAngles(void)
 {
-	const MapInputMonitor_t& mapInMon = cInterfaceNavdata.getMapInputMonitor();
+	const EpochInputs& epochInputs = cInterfaceNavdata.getEpochInputs();
 
 	// ROLL, PITCH and YAW entered and available (is not NaN)
 	for (struct { int cnt; int i; } s = { 0, ROLL_AVAILABLE }; s.i <= YAW_AVAILABLE; s.i++)
 	{
 		
 		flagsCheckAttitudeAngles.set( s.i,
-			(mapInMon.at(KEY_RPY).inputId.at(s.cnt) != -1) &&
-			!arma::arma_isnan<double>(mapInMon.at(KEY_RPY).inputHolder.at(s.cnt)));
+			epochInputs.isEntered(KEY_RPY, s.cnt) &&
+			!arma::arma_isnan<double>(epochInputs.values[KEY_RPY][s.cnt]));
 		s.cnt++;
 	}
 
@@ -33,14 +33,14 @@ void AttitudeAngles::checkAttitudeAngles(void)
 	bool rpyComputable = true;
 	for (auto i : {1,2})
 	{
-		rpyComputable &= (mapInMon.at(KEY_ACC).inputId.at(i) != -1) && !arma::arma_isnan<double>(mapInMon.at(KEY_ACC).inputHolder.at(i));
+		rpyComputable &= epochInputs.isEntered(KEY_ACC, i) && !arma::arma_isnan<double>(epochInputs.values[KEY_ACC][i]);
 	}
 	flagsCheckAttitudeAngles.set(ROLL_COMPUTABLE, rpyComputable); rpyComputable = true;
 	
 	// PITCH computable (accelerometer data in which its calculation depends is not NaN)
 	for (auto i : { 0,2 })
 	{
-		rpyComputable &= (mapInMon.at(KEY_ACC).inputId.at(i) != -1) && !arma::arma_isnan<double>(mapInMon.at(KEY_ACC).inputHolder.at(i));
+		rpyComputable &= epochInputs.isEntered(KEY_ACC, i) && !arma::arma_isnan<double>(epochInputs.values[KEY_ACC][i]);
 	}
 	flagsCheckAttitudeAngles.set(PITCH_COMPUTABLE, rpyComputable); rpyComputable = true;
 
@@ -48,7 +48,7 @@ void AttitudeAngles::checkAttitudeAngles(void)
 	// YAW computable (magnetometer data in which its calculation depends is not NaN)
 	for (auto i : { 0, 1, 2 })
 	{
-		rpyComputable &= (mapInMon.at(KEY_MAG).inputId.at(i) != -1) && !arma::arma_isnan<double>(mapInMon.at(KEY_MAG).inputHolder.at(i));
+		rpyComputable &= epochInputs.isEntered(KEY_MAG, i) && !arma::arma_isnan<double>(epochInputs.values[KEY_MAG][i]);
 	}
 	flagsCheckAttitudeAngles.set(YAW_COMPUTABLE, rpyComputable); rpyComputable = true;
 
@@ -72,19 +72,44 @@ void AttitudeAngles::checkAttitudeAngles(void)
 void AttitudeAngles::calculateAttitudeDynamics(arma::vec& rpyRate, arma::vec& rpy)
 {
 	const InputValues_t& inputValues = cInterfaceNavdata.getInputValues();
-	const arma::vec gyr = cInterfaceNavdata.getMapInputMonitor().at(KEY_GYR).inputHolder % inputValues.attitudeSelector;
+	const arma::vec gyr = cInterfaceNavdata.getEpochInputs().get(KEY_GYR) % inputValues.attitudeSelector;
 	static arma::vec rpyRatePrev = arma::zeros(3,1);
 
 	rpyRatePrev = rpyRate;
-	rpyRate = Frames::matrixRateAttitudeDynamics(rpy) * gyr;
+	rpyRate = FrameCache::getInstance().matrixRateAttitudeDynamics(rpy) * gyr;
 	rpyRate %= inputValues.attitudeSelector; 
-	rpy += (rpyRate + rpyRatePrev) / 2 * (1.0/inputValues.fsImu);
+	// Preintegrated IMU samples: the gyrometers hold the mean rate of the epoch, integrated as is
+	if (inputValues.navDecimation > 1)
+	{
+		rpyRatePrev = rpyRate;
+	}
+	rpy += (rpyRate + rpyRatePrev) / 2 * cInterfaceNavdata.getNavPeriod();
+}
+
+/* Calculate Attitude Dynamics with quaternion */
+void AttitudeAngles::calculateAttitudeQuaternion(arma::vec& rpyRate)
+{
+	const InputValues_t& inputValues = cInterfaceNavdata.getInputValues();
+	const arma::vec3 gyr = cInterfaceNavdata.getEpochInputs().get(KEY_GYR) % inputValues.attitudeSelector;
+
+	// Rotation of the body over the epoch, trapezoidal as the Euler derivatives. Preintegrated IMU samples give it with the coning, as the mean rate of the epoch.
+	if (inputValues.navDecimation > 1)
+	{
+		gyrPrev = gyr;
+	}
+	quaternion = Frames::quaternionPropagate(quaternion, (gyr + gyrPrev) / 2 * cInterfaceNavdata.getNavPeriod());
+	gyrPrev = gyr;
+	body2Enu = Frames::matrixBody2EnuQuaternion(quaternion);
+
+	// Rates of the angles for the Kalman Filter, from the matrix without trigonometric functions. The angles themselves are only derived for the outputs.
+	rpyRate = Frames::matrixRateAttitudeDynamics(Frames::attitudeTrig(body2Enu)) * gyr;
+	rpyRate %= inputValues.attitudeSelector;
 }
 
 /* Get/Calculate Attitude angles: assign the readed angles, if entered, or estimate with accelerometer and gyrometer measurements.*/
 void AttitudeAngles::calculateAttitudeAngles(arma::vec& rpy)
 {
-	const MapInputMonitor_t& mapInMon = cInterfaceNavdata.getMapInputMonitor();
+	const EpochInputs& epochInputs = cInterfaceNavdata.getEpochInputs();
 	const arma::vec& attitudeSelector = cInterfaceNavdata.getInputValues().attitudeSelector;
 
 
@@ -92,22 +117,22 @@ void AttitudeAngles::calculateAttitudeAngles(arma::vec& rpy)
 		if (!flagsCheckAttitudeAngles.test(ROLL_AVAILABLE) && flagsCheckAttitudeAngles.test(ROLL_COMPUTABLE))
 		{
 			// Roll estimation is asin(-fy/fz), considering Roll = 0 when Y axis (phone looks upwards)  is horizontal and parallel to the surface of the Earth
-			rpy(0) = atan(-mapInMon.at(KEY_ACC).inputHolder(1) / mapInMon.at(KEY_ACC).inputHolder(2));
+			rpy(0) = atan(-epochInputs.values[KEY_ACC][1] / epochInputs.values[KEY_ACC][2]);
 		}
 		else // Assign ROLL if entered
 		{
-			rpy(0) = mapInMon.at(KEY_RPY).inputHolder(0);
+			rpy(0) = epochInputs.values[KEY_RPY][0];
 		}
 
 		// PITCH estimation if is not entered. To make PITCH estimation, non-gravity corrected acceleration measurements must be entered
 		if (!flagsCheckAttitudeAngles.test(PITCH_AVAILABLE) && flagsCheckAttitudeAngles.test(PITCH_COMPUTABLE))
 		{
 			// Pitch estimation is asin(-fx/fz), considering pitch = 0 when x axis (phone looks upwards) is horizontal and parallel to the surface of the Earth
-			rpy(1) = atan(-mapInMon.at(KEY_ACC).inputHolder(0) / mapInMon.at(KEY_ACC).inputHolder(2));
+			rpy(1) = atan(-epochInputs.values[KEY_ACC][0] / epochInputs.values[KEY_ACC][2]);
 		}
 		else // Assign PITCH if entered
 		{
-			rpy(1) = mapInMon.at(KEY_RPY).inputHolder(1);
+			rpy(1) = epochInputs.values[KEY_RPY][1];
 		}
 
 		rpy = rpy.replace(arma::datum::nan, 0);
@@ -118,36 +143,44 @@ void AttitudeAngles::calculateAttitudeAngles(arma::vec& rpy)
 		{
 			// According to page 45 https://www.spelektroniikka.fi/kuvat/hmcdataa.pdf
 			rpy(2) = atan2(
-				mapInMon.at(KEY_MAG).inputHolder(1) * cos(rpy(0)) +
-				mapInMon.at(KEY_MAG).inputHolder(2) * sin(rpy(0)),
-				mapInMon.at(KEY_MAG).inputHolder(0) * cos(rpy(1)) +
-				mapInMon.at(KEY_MAG).inputHolder(1) * sin(rpy(1)) * sin(rpy(0)) -
-				mapInMon.at(KEY_MAG).inputHolder(2) * cos(rpy(0)) * sin(rpy(0))
+				epochInputs.values[KEY_MAG][1] * cos(rpy(0)) +
+				epochInputs.values[KEY_MAG][2] * sin(rpy(0)),
+				epochInputs.values[KEY_MAG][0] * cos(rpy(1)) +
+				epochInputs.values[KEY_MAG][1] * sin(rpy(1)) * sin(rpy(0)) -
+				epochInputs.values[KEY_MAG][2] * cos(rpy(0)) * sin(rpy(0))
 			);
 		}
 		else // Assign YAW if entered
 		{
-			rpy(2) = mapInMon.at(KEY_RPY).inputHolder(2);
+			rpy(2) = epochInputs.values[KEY_RPY][2];
 		}
 
 		rpy = rpy.replace(arma::datum::nan, 0);
 		rpy %= attitudeSelector;
 }
 
-void AttitudeAngles::process(arma::vec& rpyRate, arma::vec& rpy, bool& isRpySet, const bool progressAngles)
+void AttitudeAngles::process(arma::vec& rpyRate, arma::vec& rpy, bool& isRpySet, const bool progressAngles, const bool progressQuaternion)
 {
 	// Check if attitude angles are available (CSV indexes set) or computable (from accelerometers, gyrometers and magnetometers)
 	checkAttitudeAngles();
 
 	if(progressAngles) // Get or calculate the angles the 1st time and then progress with attitude dynamics
 	{
-		if (isRpySet) // apply dynamics
+		if (isRpySet && progressQuaternion) // apply dynamics with quaternion
+		{
+			calculateAttitudeQuaternion(rpyRate);
+		}
+		else if (isRpySet) // apply dynamics
 		{
 			calculateAttitudeDynamics(rpyRate, rpy);
 		}
 		else // 1st time
 		{
 			calculateAttitudeAngles(rpy);
+			quaternion = Frames::quaternionFromRpy(rpy);
+			body2Enu = Frames::matrixBody2EnuQuaternion(quaternion);
+			// The 1st propagation is then trapezoidal between this epoch and the next, not from a null rate
+			gyrPrev = cInterfaceNavdata.getEpochInputs().get(KEY_GYR) % cInterfaceNavdata.getInputValues().attitudeSelector;
 			isRpySet = true;
 		}
 	}
@@ -173,29 +206,61 @@ void InsMain::process(void)
 		sData.LLH = NavsystemsHolder::getInstance().getPtrGps().LLH;
 	}
 
-	// Process Attitude Angles
-	handlerAttitudeAngles.process(sData.RPY_dot, sData.RPY, isRpySet, inputValues.progressAngles);
-	Frames::adjustRollPitch(sData.RPY(0));
-	Frames::adjustRollPitch(sData.RPY(1));
-	Frames::adjustYaw(sData.RPY(2));
+	// Process Attitude Angles. With the quaternion the attitude is its matrix, the angles are derived in updateAttitudeAngles() for the outputs.
+	handlerAttitudeAngles.process(sData.RPY_dot, sData.RPY, isRpySet, inputValues.progressAngles, inputValues.progressQuaternion);
+	if (inputValues.progressAngles && inputValues.progressQuaternion)
+	{
+		sData.BODY2ENU = handlerAttitudeAngles.getMatrixBody2Enu();
+	}
+	else
+	{
+		Frames::adjustRollPitch(sData.RPY(0));
+		Frames::adjustRollPitch(sData.RPY(1));
+		Frames::adjustYaw(sData.RPY(2));
+	}
 
 	// Calculate Navigation
 	calcLocalNav();
 	calcGeodeticNav();
 }
 
+void InsMain::updateAttitudeAngles(void)
+{
+	const InputValues_t& inputValues = cInterfaceNavdata.getInputValues();
+	if (!(inputValues.progressAngles && inputValues.progressQuaternion && isRpySet))
+	{
+		return;
+	}
+
+	sData.RPY = Frames::rpyFromMatrixBody2Enu(sData.BODY2ENU);
+	if (sData.RPY(2) < 0) // yaw in [0, 2*PI), as it is kept by the Euler dynamics
+	{
+		sData.RPY(2) += 2*Frames::PI;
+	}
+	Frames::adjustRollPitch(sData.RPY(0));
+	Frames::adjustRollPitch(sData.RPY(1));
+	Frames::adjustYaw(sData.RPY(2));
+}
+
 void InsMain::calcGeodeticNav(void)
 {
 	sData.ECEF = Frames::enu2ecef(sData.LLH, sData.ENU, sData.ECEF_REF);
-	sData.LLH = Frames::ecef2llh(sData.ECEF);
+	sData.LLH = Frames::ecef2llh(sData.ECEF, cInterfaceNavdata.getInputValues().geodeticMethod);
 }
 
 void InsMain::calcLocalNav()
 {
 	const InputValues_t& inputValues = cInterfaceNavdata.getInputValues();
-	const arma::vec acc = cInterfaceNavdata.getMapInputMonitor().at(KEY_ACC).inputHolder;
-	const arma::mat Rb2n = Frames::matrixBody2Enu(sData.RPY % inputValues.attitudeSelector);
-	const arma::mat skew_ie = Frames::skewInertialEarth(sData.LLH(0));
+	const arma::vec3 acc = cInterfaceNavdata.getEpochInputs().get(KEY_ACC);
+	// With the quaternion the matrix comes from it, not from the angles
+	const arma::mat33 Rb2n = (inputValues.progressAngles && inputValues.progressQuaternion) ?
+		sData.BODY2ENU :
+		FrameCache::getInstance().matrixBody2Enu(sData.RPY % inputValues.attitudeSelector);
+	const arma::mat33 skew_ie = FrameCache::getInstance().skewInertialEarth(sData.LLH(0));
+	const double dt = cInterfaceNavdata.getNavPeriod();
+	// Preintegrated IMU samples: the accelerometers hold the mean of the epoch (velocity increment with rotation and sculling), integrated as is
+	const bool isPreintegrated = inputValues.navDecimation > 1;
+	const arma::vec3 velPrev = sData.V;
 	static arma::vec velRatePrev = arma::zeros(3,1);
 
 	// Calculate velocity in ENU
@@ -204,17 +269,33 @@ void InsMain::calcLocalNav()
 	{
 		// Velocity rate in ENU
 		sData.V_dot = Rb2n * acc + (/*gl*/ -  (skew_ie * sData.V) * 2); // gl handled in interface_navdata
-		sData.V += (sData.V_dot + velRatePrev) / 2 * (1.0/inputValues.fsImu);
+		if (isPreintegrated)
+		{
+			velRatePrev = sData.V_dot;
+		}
+		sData.V += (sData.V_dot + velRatePrev) / 2 * dt;
 	}
 	else
 	{
-		// Velocity rate in body
-		sData.V_dot += (acc + Rb2n.t() * (/*gl*/ -  (skew_ie * sData.V) * 2)); // gl handled in interface_navdata
-		sData.V = Rb2n * (sData.V_dot + velRatePrev) / 2 * (1.0/inputValues.fsImu);
+		// Velocity rate in body, summed over the IMU samples: the preintegrated ones count as many times as the samples of their epoch
+		const double samples = isPreintegrated ? std::round(dt * inputValues.fsImu) : 1;
+		sData.V_dot += (acc + Rb2n.t() * (/*gl*/ -  (skew_ie * sData.V) * 2)) * samples; // gl handled in interface_navdata
+		if (isPreintegrated)
+		{
+			velRatePrev = sData.V_dot;
+		}
+		sData.V = Rb2n * (sData.V_dot + velRatePrev) / 2 * (dt / samples);
 	}
 
-	/* Calculate position in ENU */
-	sData.ENU += sData.V * (1.0/inputValues.fsImu);
+	/* Calculate position in ENU, trapezoidal over the longer epochs of the preintegrated IMU samples */
+	if (isPreintegrated)
+	{
+		sData.ENU += (sData.V + velPrev) / 2 * dt;
+	}
+	else
+	{
+		sData.ENU += sData.V * dt;
+	}
 }
 
 
@@ -34,10 +34,16 @@ public:
 	AttitudeAngles()
 	{
 		flagsCheckAttitudeAngles.reset();
+		quaternion = { 1, 0, 0, 0 };
+		body2Enu.eye();
+		gyrPrev.zeros();
 	};
 
     /*! Main process function. Responsible for checking their availability and reading or computing if necessary. */	
-	void process(arma::vec& rpyRate, arma::vec& rpy, bool& isRpySet, const bool progressAngles);
+	void process(arma::vec& rpyRate, arma::vec& rpy, bool& isRpySet, const bool progressAngles, const bool progressQuaternion);
+
+	/*! Get the Body to ENU matrix of the quaternion, only valid when progressing with the quaternion */
+	const arma::mat33& getMatrixBody2Enu(void) const { return body2Enu; };
 
 private:
 	/*! @brief Check angles availability */
@@ -50,6 +56,13 @@ private:
 	*/
 	void calculateAttitudeDynamics(arma::vec& rpyRate, arma::vec& rpy);
 
+	/*! 
+	@brief Calculate angle dynamics with the quaternion: propagated with the gyrometer increment (trapezoidal), then the rates of the
+	angles are derived from its Body to ENU matrix. The angles are not, see InsMain::updateAttitudeAngles().
+	@param rpyRate: Output, 3x1 vector, 1st dereivative of the attitude angles, is their rate.
+	*/
+	void calculateAttitudeQuaternion(arma::vec& rpyRate);
+
 	/*! 
 	@brief Calculate only the angles from platform measurements in accelerometers, gyrometers and magnetometers.
 	Therefore, they are not computed from the rate of change.
@@ -59,6 +72,9 @@ private:
 
 	// Variables
 	std::bitset<TOTAL_BITS_CHECK_ATTITUDE_ANGLES> flagsCheckAttitudeAngles;
+	arma::vec4 quaternion; // Body to ENU
+	arma::mat33 body2Enu; // Matrix of the quaternion
+	arma::vec3 gyrPrev; // Gyrometer of the previous epoch
 };
 
 
@@ -74,6 +90,9 @@ public:
 	/*! System processing. Responsible to handle attitude angles to compute intertial navigation, and convert from ENU to LLH coordinates */
 	void process(void);
 
+	/*! With the quaternion (-y 2), derive the attitude angles from the Body to ENU matrix. Only needed for the outputs. */
+	void updateAttitudeAngles(void);
+
 private:
 	/*! Compute navigation over variables in local frame, i.e., in ENU plane */
 	void calcLocalNav(void);
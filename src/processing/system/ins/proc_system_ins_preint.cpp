@@ -0,0 +1,78 @@
+/*!
+ @file proc_system_ins_preint.cpp
+ @author Nicolas Padron
+ @brief Description: In this file the processes of proc_system_ins_preint.h are implemented.
+*/
+
+#include <processing/system/ins/proc_system_ins_preint.h>
+
+/* Cross product of 3 element arrays, accumulated: out += scale * a x b */
+static void addCross(double* out, const double scale, const double* a, const double* b)
+{
+	out[0] += scale * (a[1] * b[2] - a[2] * b[1]);
+	out[1] += scale * (a[2] * b[0] - a[0] * b[2]);
+	out[2] += scale * (a[0] * b[1] - a[1] * b[0]);
+}
+
+/*************************************************
+* Methods definitions for Class: ImuPreintegrator *
+**************************************************/
+
+/* Set the IMU period and restart */
+void ImuPreintegrator::initialize(const double dtImu)
+{
+	*this = ImuPreintegrator();
+	dt = dtImu;
+}
+
+/* Accumulate an IMU sample with the recursive coning and sculling compensations:
+*	coning: beta += 1/2 * (alpha + dTheta_prev / 6) x dTheta
+*	sculling: += 1/2 * ((alpha + dTheta_prev / 6) x dVel + (upsilon + dVel_prev / 6) x dTheta)
+* with alpha and upsilon accumulated up to the previous sample.
+*/
+void ImuPreintegrator::add(const arma::vec3& gyr, const arma::vec3& acc)
+{
+	double dTheta[3], dVel[3], angle[3], vel[3];
+	for (int i = 0; i < 3; i++)
+	{
+		dTheta[i] = gyr(i) * dt;
+		dVel[i] = acc(i) * dt;
+		angle[i] = alpha[i] + dThetaPrev[i] / 6;
+		vel[i] = upsilon[i] + dVelPrev[i] / 6;
+	}
+
+	addCross(beta, 0.5, angle, dTheta);
+	addCross(sculling, 0.5, angle, dVel);
+	addCross(sculling, 0.5, vel, dTheta);
+
+	for (int i = 0; i < 3; i++)
+	{
+		alpha[i] += dTheta[i];
+		upsilon[i] += dVel[i];
+		dThetaPrev[i] = dTheta[i];
+		dVelPrev[i] = dVel[i];
+	}
+	samples++;
+}
+
+/* Close the epoch: rotation vector alpha + beta, and velocity increment in the body frame at the end of the epoch,
+* upsilon - 1/2 * alpha x upsilon + sculling (the rotation compensation is + 1/2 * alpha x upsilon at the start).
+*/
+double ImuPreintegrator::close(arma::vec3& gyr, arma::vec3& acc)
+{
+	const double period = samples * dt;
+	double dVel[3] = { upsilon[0] + sculling[0], upsilon[1] + sculling[1], upsilon[2] + sculling[2] };
+	addCross(dVel, -0.5, alpha, upsilon);
+
+	for (int i = 0; i < 3; i++)
+	{
+		gyr(i) = (alpha[i] + beta[i]) / period;
+		acc(i) = dVel[i] / period;
+		alpha[i] = 0;
+		beta[i] = 0;
+		upsilon[i] = 0;
+		sculling[i] = 0;
+	}
+	samples = 0;
+	return period;
+}
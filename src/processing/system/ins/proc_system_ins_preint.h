@@ -0,0 +1,66 @@
+/*!
+ @file proc_system_ins_preint.h
+ @author Nicolas Padron
+ @brief Description: This file contains the IMU preintegration, which accumulates the gyrometer and accelerometer samples of a navigation epoch
+*			into a rotation vector and a velocity increment, with the coning and sculling compensations (Savage's recursive algorithms).
+*			The INS mechanization and the Kalman Filter then run once per navigation epoch instead of once per IMU sample.
+*/
+
+#ifndef SYSTEM_INS_PREINT_HEADER
+#define SYSTEM_INS_PREINT_HEADER
+
+#include <general/general.h>
+
+/*!
+ @brief IMU preintegration over the samples of a navigation epoch. The increments of each sample are the rates times the IMU period,
+ the compensations use the increments of the previous sample too, also when it belongs to the previous epoch.
+ \class ImuPreintegrator
+*/
+class ImuPreintegrator {
+public:
+	/*! Constructor: no samples, previous increments 0 */
+	ImuPreintegrator() : dt(0), samples(0)
+	{
+		for (int i = 0; i < 3; i++)
+		{
+			alpha[i] = 0;
+			beta[i] = 0;
+			upsilon[i] = 0;
+			sculling[i] = 0;
+			dThetaPrev[i] = 0;
+			dVelPrev[i] = 0;
+		}
+	};
+
+	/*! Set the IMU sampling period [s] and restart */
+	void initialize(const double dtImu);
+
+	/*!
+	@brief Accumulate an IMU sample.
+	@param gyr: angular rate [rad/s].
+	@param acc: specific force [m/s^2].
+	*/
+	void add(const arma::vec3& gyr, const arma::vec3& acc);
+
+	/*!
+	@brief Close the epoch and restart the accumulation.
+	@param gyr: output mean angular rate of the epoch, the rotation vector of the body over it (with coning) divided by its period.
+	@param acc: output mean specific force of the epoch, the velocity increment (with rotation and sculling) divided by its period.
+	The increment is expressed in the body frame at the end of the epoch, as the mechanization rotates it with the attitude already propagated.
+	@return period of the epoch [s].
+	*/
+	double close(arma::vec3& gyr, arma::vec3& acc);
+
+	/*! Get the number of samples accumulated in the current epoch */
+	int getSamples(void) const { return samples; };
+
+private:
+	// IMU period, samples of the epoch, accumulated angle and coning, velocity and sculling, and increments of the previous sample
+	double dt;
+	int samples;
+	double alpha[3], beta[3];
+	double upsilon[3], sculling[3];
+	double dThetaPrev[3], dVelPrev[3];
+};
+
+#endif // SYSTEM_INS_PREINT_HEADER
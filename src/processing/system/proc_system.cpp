@@ -61,6 +61,12 @@ void Systems::process(void)
 	/* Process GNSS */
 	gnssSystem.process();
 
+	/* INS and Fusion start from the 1st valid GPS position, which sets the ENU origin. Before it, e.g. while a GNSS file (-G) starts later than the IMU one, there is nothing to navigate from. */
+	if (!cMonitor.flagsMonitorVariables_e.test(MON_IS_GPS_ECEF_REF_SET))
+	{
+		return;
+	}
+
 	/* Process INS */
 	insSystem.process();
 
@@ -68,4 +74,14 @@ void Systems::process(void)
 	fusionSystem.process();
 }
 
+void Systems::updateAttitudeAngles(void)
+{
+	if (!cMonitor.flagsMonitorVariables_e.test(MON_IS_GPS_ECEF_REF_SET))
+	{
+		return;
+	}
+	insSystem.updateAttitudeAngles();
+	fusionSystem.updateAttitudeAngles(insSystem.getData().RPY);
+}
+
 
@@ -33,6 +33,11 @@ public:
 	*/
 	void process(void);
 
+	/*!
+	@brief Derive the attitude angles of INS and Fusion for the outputs, when they are kept as a matrix (quaternion, -y 2).
+	*/
+	void updateAttitudeAngles(void);
+
 	friend class NavsystemsHolder;
 private:
 	Systems(){};
@@ -10,6 +10,9 @@ cmds = {}
 chars = {}
 chars['INPUT_FILE']          = "-I"
 chars['OUTPUT_FILE']         = "-O"
+chars['GNSS_FILE']           = "-G"
+chars['AUX_FILE']            = "-U"
+chars['TIMESTAMP_CSV_INDEX'] = "-S"
 chars['FREQUENCY']           = "-F"      
 chars['INPUTS_IN_RADIANS']   = "-r"     
 chars['ACC_CSV_INDEX']       = "-A"   
@@ -34,7 +37,22 @@ chars['PROGRESS_ANGLES']     = "-y"
 chars['KF_TAU']              = "-t"
 chars['INTERVAL_GPS_OFF']    = "-T"
 chars['QUANT_FACTOR']        = "-q" 
+chars['READER_RING']         = "-B"
+chars['INGEST_THREADS']      = "-j"
+chars['TIME_WINDOW']         = "-s"
+chars['DECODE_THREAD']       = "-Z"
+chars['BLOCK_ROWS']          = "-b"
+chars['GEODETIC']            = "-e"
+chars['KF_ENGINE']           = "-k"
+chars['KF_COVARIANCE']       = "-c"
+chars['KF_STEADY']           = "-u"
+chars['NAV_DECIMATION']      = "-n"
 chars['WRITE_IDX_FILE']      = "--idx"
+chars['WRITE_BIN_FILE']      = "--bin"
+chars['BENCH_PARSER']        = "--bench"
+chars['BENCH_GEODETIC']      = "--geo"
+chars['CONVERT']             = "--conv"
+chars['BENCH_KF']            = "--kf"
 
 kfconfig = {}
 kfconfig['ACCELEROMETER_BIAS_XYZ']  = [0.1,0.1,0.1]
@@ -69,6 +87,11 @@ def formCmdStr(cmds, kfconfig):
         if cmds[cmdkey] is not None:
             cmdstr += ' ' + chars[cmdkey] + ' ' + f"{cmds[cmdkey]}".replace('[','"').replace(']','"').replace("True","1").replace("False","0")
     cmdstr = cmdstr.replace("--idx 1", "--idx").replace("--idx 0", '')
+    cmdstr = cmdstr.replace("--bin 1", "--bin").replace("--bin 0", '')
+    cmdstr = cmdstr.replace("--bench 1", "--bench").replace("--bench 0", '')
+    cmdstr = cmdstr.replace("--geo 1", "--geo").replace("--geo 0", '')
+    cmdstr = cmdstr.replace("--conv 1", "--conv").replace("--conv 0", '')
+    cmdstr = cmdstr.replace("--kf 1", "--kf").replace("--kf 0", '')
     
     kfstr = ''
     for kfkeys in kfconfig.keys():
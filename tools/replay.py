@@ -0,0 +1,84 @@
+import argparse
+import os
+import socket
+import sys
+import time
+
+# Replay an input CSV at real-time rate into a live navfusion input, for testing the streaming mode.
+# Rows are paced with the IMU sampling rate (as entered with -F), or with a timestamp column in seconds.
+#
+# Examples, with navfusion reading the same target through -I:
+#   python tools/replay.py data/tram/input/tram.csv --fs 300 | navfusion -I - ...
+#   mkfifo /tmp/nav.fifo; python tools/replay.py data/tram/input/tram.csv --fs 300 --out /tmp/nav.fifo
+#   python tools/replay.py data/tram/input/tram.csv --fs 300 --out unix:/tmp/nav.sock   (start before navfusion -I unix:/tmp/nav.sock)
+
+UNIX_PREFIX = 'unix:'
+
+def openOutput(out):
+    # Standard output
+    if out == '-':
+        return sys.stdout.buffer, None
+    # UNIX domain socket: serve the data to the 1st client that connects
+    if out.startswith(UNIX_PREFIX):
+        path = out[len(UNIX_PREFIX):]
+        if os.path.exists(path):
+            os.remove(path)
+        server = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+        server.bind(path)
+        server.listen(1)
+        print(f'Waiting for navfusion on {path}', file=sys.stderr)
+        conn, _ = server.accept()
+        server.close()
+        return conn.makefile('wb', buffering=0), path
+    # Named pipe (blocks until navfusion opens it) or regular file
+    return open(out, 'wb', buffering=0), None
+
+def replay(filename, out, fs, timeIndex, speed):
+    stream, socketPath = openOutput(out)
+    try:
+        with open(filename, 'rb') as f:
+            header = f.readline()
+            rows = f.readlines()
+        stream.write(header)
+        stream.flush()
+
+        period = 1.0 / (fs * speed)
+        start = time.perf_counter()
+        epoch = 0
+        timeFirst = None
+        for row in rows:
+            if not row.strip():
+                continue
+            # Time at which the row is due, from the start of the replay. Sleeping until an absolute time avoids accumulating drift.
+            if timeIndex is None:
+                due = epoch * period
+            else:
+                timeRow = float(row.split(b',')[timeIndex])
+                if timeFirst is None:
+                    timeFirst = timeRow
+                due = (timeRow - timeFirst) / speed
+            wait = start + due - time.perf_counter()
+            if wait > 0:
+                time.sleep(wait)
+            stream.write(row if row.endswith(b'\n') else row + b'\n')
+            epoch += 1
+        stream.flush()
+    except BrokenPipeError:
+        print('navfusion closed the input', file=sys.stderr)
+    finally:
+        try:
+            stream.close()
+        except BrokenPipeError:
+            pass
+        if socketPath is not None and os.path.exists(socketPath):
+            os.remove(socketPath)
+
+if __name__ == '__main__':
+    parser = argparse.ArgumentParser(description='Replay an input CSV at real-time rate into a live navfusion input.')
+    parser.add_argument('input', help='Input CSV file')
+    parser.add_argument('--out', default='-', help='"-" for standard output (default), path of a named pipe, or "unix:path" for a UNIX domain socket')
+    parser.add_argument('--fs', type=float, default=100, help='IMU sampling rate in Hz, used to pace the rows. Default is 100.')
+    parser.add_argument('--time-index', type=int, default=None, help='CSV column of the timestamp in seconds, used to pace the rows instead of --fs')
+    parser.add_argument('--speed', type=float, default=1.0, help='Replay speed factor, e.g. 2 for twice real-time. Default is 1.')
+    args = parser.parse_args()
+    replay(args.input, args.out, args.fs, args.time_index, args.speed)
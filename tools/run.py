@@ -7,10 +7,22 @@ from helpers import *
 
 # Write IDX file: program will read input, write file with column indexes in CSV and stop.
 cmds['WRITE_IDX_FILE']      = False         # Bool. True to write file with CSV indexes. # Comment this to run the processing after filling the CSV indexes below.
+# Write binary log: program will convert the input CSV into a binary log (.nfb) next to it and stop. Then set INPUT_FILE to the .nfb to load it faster on repeated runs.
+#cmds['WRITE_BIN_FILE']      = False         # Bool. True to write the binary log. Uses the CSV indexes and FREQUENCY below.
+# Benchmark the CSV field parser against strtod on the input file and stop.
+#cmds['BENCH_PARSER']        = False         # Bool. True to run the parser benchmark.
+#cmds['BENCH_GEODETIC']      = False         # Bool. True to check and benchmark the ECEF to LLH conversions.
+#cmds['CONVERT']             = False         # Bool. True to convert the GPS coordinates of the input to ECEF and ENU (conversion.csv).
+#cmds['BENCH_KF']            = False         # Bool. True to benchmark the Kalman Filter engines (-k).
 
 ## MANDATORY: Input file and output directory
 cmds['INPUT_FILE']          = ' "data/tram/input/tram.csv" '
 cmds['OUTPUT_FILE']         = ' "data/tram/yaw" '
+# Optional: GNSS and magnetometer/attitude recorded in their own files, at their own rates. Their CSV indexes below are then columns of these files.
+# Rows are merged by timestamp with the IMU rows of INPUT_FILE, each IMU row is one epoch.
+#cmds['GNSS_FILE']           = ' "data/tram/input/gnss.csv" '
+#cmds['AUX_FILE']            = ' "data/tram/input/aux.csv" '
+#cmds['TIMESTAMP_CSV_INDEX'] = [0,0,0]       # Timestamp column in seconds of each file, order as [imu, gnss, aux]. -1 for files not entered.
 
 ## MANDATORY: frequency, and CSV indexes of IMU measurements and GPS
 cmds['FREQUENCY']           = [300, 1]      # In Hz, order as [fs_imu, fs_gps]. Default is "100,1".
@@ -39,11 +51,21 @@ cmds['PLATFORM_ALIGNMENT']  = False         # Bool. True to perform platform ali
                                             # If these are zero, or filtered by ATTITUDE_SELECTOR, then PLATFORM_ALIGNMENT is useless. Default is False.
 cmds['FEEDBACK_BIAS']       = False         # Bool. True to compensate IMU measurements with KF accelerometer and gyrometer bias estimation. Default is False.
 cmds['MODE_MECH_LOCAL']     = False         # Bool. True to perform mechanization of velocity in local plane, false to do in body frame.  Default is True.
-cmds['PROGRESS_ANGLES']     = False          # Bool. True to use 1st attitude angles from entered (CSV indexes) or calculated (from acc, gyr, mag), and then continues with Euler derivatives.
+cmds['PROGRESS_ANGLES']     = False          # Bool/Int. True (1) to use 1st attitude angles from entered (CSV indexes) or calculated (from acc, gyr, mag), and then continues with Euler derivatives. 2 to continue with a quaternion instead.
                                             # False to use entered/calculated all the time, no euler derivatives used. Default is True.
 cmds['KF_TAU']              = 100           # Scalar. Correlation time to be used in State Transition Matrix 1st order Markov processes for accelerometer and gyrometer drift. Default is 1.
 cmds['INTERVAL_GPS_OFF']    = [-1,-1]       # Scalar. Interval in seconds to turn GPS off in GPS-INS fusion. Default is [-1,-1] which means don't turn off.
 cmds['QUANT_FACTOR']        = 1000          # Scalar. Quantization factor to apply to input IMU values to remove small variations. Criteria is floor(x * QF) / QF. Default is 10000.
+#cmds['READER_RING']         = [4096, 1]     # Read and parse the input in a background thread through a ring of [capacity, wait] rows, wait: 0 spin, 1 yield, 2 sleep. Capacity 0 disables it. Default is [0, 1].
+#cmds['INGEST_THREADS']      = 4             # Scalar. Threads decoding the whole input CSV in memory at start, then processed from memory. 0 reads row by row. Takes precedence over READER_RING. Default is 0.
+#cmds['TIME_WINDOW']         = [600, 1200, 30]  # Process only [start, end] seconds of the timestamp column (TIMESTAMP_CSV_INDEX), with 30 s of warm-up before. -1 for start/end of input. Default is [-1,-1,0].
+#cmds['DECODE_THREAD']       = True          # Bool. True to decode a compressed (gzip, zstd) INPUT_FILE in a background thread. Default is False.
+#cmds['BLOCK_ROWS']          = 64            # Scalar. Rows of the blocks of epochs read ahead and preprocessed at once, 1 to go row by row. Default is 64.
+#cmds['GEODETIC']            = 0             # Scalar. ECEF to LLH conversion: 0 iterative, 1 closed form. Default is 0.
+#cmds['KF_ENGINE']           = 0             # Scalar. Kalman Filter engine: 0 Armadillo matrices, 1 fixed-size arrays, 2 fixed-size arrays by blocks, 3 selected states only, 4 packed covariance, 5 UD factors in float. Default is 0.
+#cmds['KF_COVARIANCE']       = 1             # Scalar. IMU epochs per Kalman Filter covariance propagation (-k 0), 0 only before the GPS updates. Default is 1.
+#cmds['KF_STEADY']           = [1e-2, 0.05, 0.5, 2]  # Kalman Filter steady-state gain (-k 0): [convergence, rate [rad/s], acceleration [m/s^2], GPS gap [s]], convergence 0 disables. Default is [0, 0.05, 0.5, 2].
+#cmds['NAV_DECIMATION']      = 1             # Scalar. IMU samples preintegrated (coning/sculling) per navigation epoch: INS, KF and outputs run once per epoch. Default is 1.
 # 
 ## MANDATORY: IMU BIASES (to be filled as process noise in KF).
 # Enter as (in order from left to right):